@@ -0,0 +1,321 @@
+/**
+ * @file shm_bench.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief Measures transfer throughput between two processes over a pipe and over shared memory
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#include <sched.h>
+#include <spawn.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TRANSFER_SIZE (64 * 1024 * 1024)
+#define CHUNK_SIZE (64 * 1024)
+
+// Number of chunks in the shared ring, must be a power of two
+#define RING_SLOTS 16
+
+#define SHM_NAME "/shm_bench"
+
+// First page of the shared object, followed by the slots
+typedef struct
+{
+    volatile uint64_t head;
+    volatile uint64_t tail;
+    volatile uint64_t done;
+} ring_header_t;
+
+#define RING_DATA_OFFSET 4096
+#define SHM_SIZE (RING_DATA_OFFSET + RING_SLOTS * CHUNK_SIZE)
+
+static uint8_t chunk[CHUNK_SIZE];
+
+static uint64_t now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void report(const char *name, uint64_t ns)
+{
+    if (ns == 0)
+    {
+        ns = 1;
+    }
+
+    uint64_t mib_per_s = ((uint64_t)TRANSFER_SIZE * 1000000000ULL / ns) >> 20;
+
+    printf("%s: %u MiB in %u us, %u MiB/s\n",
+           name,
+           (uint64_t)(TRANSFER_SIZE >> 20),
+           ns / 1000,
+           mib_per_s);
+}
+
+static int spawn_child(const char *self,
+                       const char *mode,
+                       posix_spawn_file_actions_t *actions)
+{
+    pid_t pid;
+    char *argv[] = {(char *)self, (char *)mode, NULL};
+    char *envp[] = {NULL};
+
+    return posix_spawn(&pid, self, actions, NULL, argv, envp);
+}
+
+//=============================================================================
+// Pipe
+//=============================================================================
+
+static int pipe_child()
+{
+    // Data arrives on 3, the acknowledgement goes out on 4
+    uint64_t total = 0;
+
+    for (;;)
+    {
+        ssize_t n = read(3, chunk, CHUNK_SIZE);
+
+        if (n <= 0)
+        {
+            break;
+        }
+
+        total += n;
+    }
+
+    char ack = total == TRANSFER_SIZE;
+    write(4, &ack, 1);
+
+    return 0;
+}
+
+static int pipe_bench(const char *self)
+{
+    int data[2];
+    int ack[2];
+
+    if (pipe(data) < 0 || pipe(ack) < 0)
+    {
+        puts("shm_bench: pipe failed");
+        return 1;
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+
+    // The actions run in order and the pipes may already occupy 3 and 4, so
+    // close the parent's ends before anything is duplicated over them
+    posix_spawn_file_actions_addclose(&actions, data[1]);
+    posix_spawn_file_actions_addclose(&actions, ack[0]);
+    posix_spawn_file_actions_adddup2(&actions, data[0], 3);
+    posix_spawn_file_actions_adddup2(&actions, ack[1], 4);
+
+    int ret = spawn_child(self, "pipe", &actions);
+
+    posix_spawn_file_actions_destroy(&actions);
+
+    if (ret != 0)
+    {
+        puts("shm_bench: spawn failed");
+        return 1;
+    }
+
+    // Only the child may hold the read end, or the pipe never reports EOF
+    close(data[0]);
+    close(ack[1]);
+
+    memset(chunk, 0xA5, CHUNK_SIZE);
+
+    uint64_t start = now_ns();
+
+    for (uint64_t sent = 0; sent < TRANSFER_SIZE; sent += CHUNK_SIZE)
+    {
+        write(data[1], chunk, CHUNK_SIZE);
+    }
+
+    close(data[1]);
+
+    char ok = 0;
+    read(ack[0], &ok, 1);
+
+    uint64_t end = now_ns();
+
+    close(ack[0]);
+
+    if (!ok)
+    {
+        puts("shm_bench: pipe transfer incomplete");
+        return 1;
+    }
+
+    report("pipe", end - start);
+
+    return 0;
+}
+
+//=============================================================================
+// Shared memory
+//=============================================================================
+
+static void *shm_map_ring(int oflag)
+{
+    int fd = shm_open(SHM_NAME, oflag, 0600);
+
+    if (fd < 0)
+    {
+        return NULL;
+    }
+
+    if ((oflag & O_CREAT) && ftruncate(fd, SHM_SIZE) < 0)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    void *ring = mmap(
+        NULL, SHM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    // The mapping keeps the object alive
+    close(fd);
+
+    return ring == MAP_FAILED ? NULL : ring;
+}
+
+static int shm_child()
+{
+    uint8_t *ring = shm_map_ring(O_RDWR);
+
+    if (!ring)
+    {
+        return 1;
+    }
+
+    ring_header_t *header = (ring_header_t *)ring;
+    uint8_t *slots = ring + RING_DATA_OFFSET;
+
+    for (;;)
+    {
+        while (header->tail == header->head && !header->done)
+        {
+            sched_yield();
+        }
+
+        if (header->tail == header->head)
+        {
+            break;
+        }
+
+        // Copy out, so both sides touch the data once like with a pipe
+        uint64_t slot = header->tail & (RING_SLOTS - 1);
+        memcpy(chunk, slots + slot * CHUNK_SIZE, CHUNK_SIZE);
+
+        header->tail++;
+    }
+
+    header->done = 2;
+
+    munmap(ring, SHM_SIZE);
+
+    return 0;
+}
+
+static int shm_bench(const char *self)
+{
+    uint8_t *ring = shm_map_ring(O_RDWR | O_CREAT | O_TRUNC);
+
+    if (!ring)
+    {
+        puts("shm_bench: could not map shared memory");
+        return 1;
+    }
+
+    ring_header_t *header = (ring_header_t *)ring;
+    uint8_t *slots = ring + RING_DATA_OFFSET;
+
+    if (spawn_child(self, "shm", NULL) != 0)
+    {
+        puts("shm_bench: spawn failed");
+        shm_unlink(SHM_NAME);
+        return 1;
+    }
+
+    memset(chunk, 0x5A, CHUNK_SIZE);
+
+    uint64_t start = now_ns();
+
+    for (uint64_t sent = 0; sent < TRANSFER_SIZE; sent += CHUNK_SIZE)
+    {
+        while (header->head - header->tail == RING_SLOTS)
+        {
+            sched_yield();
+        }
+
+        uint64_t slot = header->head & (RING_SLOTS - 1);
+        memcpy(slots + slot * CHUNK_SIZE, chunk, CHUNK_SIZE);
+
+        header->head++;
+    }
+
+    header->done = 1;
+
+    while (header->done != 2)
+    {
+        sched_yield();
+    }
+
+    uint64_t end = now_ns();
+
+    munmap(ring, SHM_SIZE);
+    shm_unlink(SHM_NAME);
+
+    report("shm", end - start);
+
+    return 0;
+}
+
+//=============================================================================
+// Entry point
+//=============================================================================
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "pipe") == 0)
+    {
+        return pipe_child();
+    }
+
+    if (argc > 1 && strcmp(argv[1], "shm") == 0)
+    {
+        return shm_child();
+    }
+
+    if (pipe_bench(argv[0]) || shm_bench(argv[0]))
+    {
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
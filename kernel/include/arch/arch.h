@@ -111,12 +111,46 @@ int is_interrupts_enabled();
 void sti();
 void cli();
 
+/**
+ * @brief Disables interrupts and returns the previous interrupt state.
+ *
+ * Unlike is_interrupts_enabled(), this reads the actual interrupt flag and
+ * is therefore safe to use from interrupt context.
+ *
+ * @return Opaque interrupt state to be passed to irq_restore().
+ */
+uint64_t irq_save();
+
+/**
+ * @brief Restores the interrupt state returned by irq_save().
+ *
+ * @param flags Interrupt state.
+ */
+void irq_restore(uint64_t flags);
+
+/**
+ * @brief Reads the CPU timestamp counter.
+ *
+ * @return Number of cycles since reset.
+ */
+uint64_t read_timestamp();
+
 void interrupt_done(uint32_t intno);
 
 void set_interrupt_handler(int intno, INT_HANDLER int_handler, int flags);
 
 void set_irq_handler(int irq, IRQ_HANDLER irq_handler);
 
+/**
+ * @brief Installs a handler for a CPU exception.
+ *
+ * Exceptions without a handler are treated as fatal.
+ *
+ * @param exception Exception vector.
+ * @param exception_handler Handler.
+ */
+void set_exception_handler(int exception, IRQ_HANDLER exception_handler);
+
 tick_count_t get_tick_count();
 
 void set_on_tick_handler(on_tick_handler_func on_tick_handler);
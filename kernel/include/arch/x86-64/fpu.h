@@ -23,6 +23,7 @@
 #ifndef _ARCH_X86_64_FPU_H
 #define _ARCH_X86_64_FPU_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #define FPU_ROUND_NEAREST 0
@@ -54,6 +55,41 @@ void arch_x64_64_enable_fpu();
 void arch_x64_64_disable_fpu();
 void arch_x64_64_init_fpu();
 void arch_x64_64_install_fpu();
+
+/**
+ * @brief Gets the size of the FPU state area.
+ *
+ * @return Size in bytes. 512 when saving with FXSAVE, otherwise the size of
+ * the XSAVE area for the enabled state components.
+ */
+size_t arch_x64_64_fpu_state_size();
+
+/**
+ * @brief Allocates a suitably aligned FPU state area.
+ *
+ * The area is initialized to the state of a freshly initialized FPU.
+ *
+ * @return The state area, or NULL on failure.
+ */
+void *arch_x64_64_alloc_fpu_state();
+
+/**
+ * @brief Frees a state area allocated by arch_x64_64_alloc_fpu_state().
+ *
+ * @param buffer State area.
+ */
+void arch_x64_64_free_fpu_state(void *buffer);
+
+/**
+ * @brief Sets CR0.TS, making the next FPU/SSE instruction raise #NM.
+ */
+void arch_x64_64_fpu_set_ts();
+
+/**
+ * @brief Clears CR0.TS.
+ */
+void arch_x64_64_fpu_clear_ts();
+
 void arch_x64_64_restore_fpu(void *buffer);
 void arch_x64_64_save_fpu(void *buffer);
 
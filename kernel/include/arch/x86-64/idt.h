@@ -58,6 +58,9 @@ void arch_x86_64_install_ir(uint32_t i,
 
 void arch_x86_64_install_irq(int irq, IRQ_HANDLER irq_handler);
 
+void arch_x86_64_install_exception_handler(int exception,
+                                           IRQ_HANDLER exception_handler);
+
 void arch_x86_64_initialize_idt(uint16_t code_sel);
 
 #endif
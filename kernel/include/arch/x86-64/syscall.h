@@ -0,0 +1,90 @@
+/**
+ * @file syscall.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief SYSCALL/SYSRET fast system call entry
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _ARCH_X86_64_SYSCALL_H
+#define _ARCH_X86_64_SYSCALL_H
+
+#include <stdint.h>
+
+/**
+ * @brief Per-CPU data reached through the GS base on system call entry.
+ *
+ * The layout is shared with syscall_entry.asm.
+ */
+typedef struct
+{
+    // Top of the system call stack of the running process, or 0 to stay on
+    // the stack of the caller
+    uint64_t syscall_stack;
+
+    // Stack pointer of the caller, saved during the stack swap
+    uint64_t user_rsp;
+} arch_x86_64_cpu_local_t;
+
+/**
+ * @brief Registers saved by the SYSCALL entry, in the Linux convention.
+ *
+ * The system call number is passed in rax and the arguments in rdi, rsi,
+ * rdx, r10, r8 and r9. The layout is shared with syscall_entry.asm.
+ */
+typedef struct
+{
+    uint64_t rax;
+    uint64_t r9;
+    uint64_t r8;
+    uint64_t r10;
+    uint64_t rdx;
+    uint64_t rsi;
+    uint64_t rdi;
+    uint64_t rflags;
+    uint64_t rip;
+    uint64_t rsp;
+} arch_x86_64_syscall_frame_t;
+
+typedef int64_t (*arch_x86_64_syscall_handler_t)(
+    arch_x86_64_syscall_frame_t *frame);
+
+/**
+ * @brief Enables the SYSCALL instruction and points it at the entry stub.
+ */
+void arch_x86_64_initialize_syscall();
+
+/**
+ * @brief Sets the function called for each system call made with SYSCALL.
+ *
+ * @param handler Handler, its return value is passed back in rax.
+ */
+void arch_x86_64_set_syscall_handler(arch_x86_64_syscall_handler_t handler);
+
+/**
+ * @brief Sets the stack used by system calls on this CPU.
+ *
+ * @param stack_top Top of the stack, or 0 to run system calls on the stack
+ * of the caller.
+ */
+void arch_x86_64_set_syscall_stack(uintptr_t stack_top);
+
+#endif
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -0,0 +1,153 @@
+/**
+ * @file page_cache.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Per-file cache of pages
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _PAGE_CACHE_H
+#define _PAGE_CACHE_H
+
+#include <mm/virt_mem.h>
+#include <sync/spinlock.h>
+#include <util/radix_tree.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Maximum number of pages cached for all files together. Reads past
+ * the limit go through a temporary page.
+ */
+#define PAGE_CACHE_MAX_PAGES 8192
+
+/**
+ * @brief Maximum number of missing pages filled by a single call.
+ */
+#define PAGE_CACHE_FILL_MAX 32
+
+/**
+ * @brief Reads consecutive pages of the file from the backing store.
+ *
+ * @param arg Argument given to the cache operation.
+ * @param index Index of the first page in the file.
+ * @param count Number of pages.
+ * @param pages Contiguous pages to fill, count * PAGE_SIZE bytes.
+ *
+ * @return 0 on success.
+ */
+typedef int (*page_cache_fill_t)(void *arg,
+                                 uint64_t index,
+                                 uint32_t count,
+                                 uint8_t *pages);
+
+/**
+ * @brief Pages of a file, indexed by their offset in the file divided by
+ * PAGE_SIZE.
+ *
+ * The pages are physical frames, so that they can later be mapped into a
+ * process as well as copied from.
+ */
+typedef struct _page_cache
+{
+    radix_tree_t pages;
+    size_t count;
+
+    // Bumped under the lock by writes and truncation. Pages filled while it
+    // changed may hold old data and are not cached.
+    uint64_t seq;
+
+    spinlock_t lock;
+} page_cache_t;
+
+typedef struct _page_cache_stats
+{
+    // Pages read from the cache, and filled by reads that missed it
+    uint64_t hits;
+    uint64_t misses;
+
+    // Pages filled ahead of the reader
+    uint64_t prefetched;
+
+    // Pages cached now
+    uint64_t pages;
+} page_cache_stats_t;
+
+void page_cache_init(page_cache_t *cache);
+
+/**
+ * @brief Reads from a file through the cache.
+ *
+ * Missing pages are filled by @p fill and kept. Runs of missing pages in the
+ * range are filled with one call, so that the backing store can read them
+ * with few requests. Data is copied once, from the cached page to the
+ * buffer. The caller limits the range to the file size.
+ *
+ * @return Number of bytes read.
+ */
+uint32_t page_cache_read(page_cache_t *cache,
+                         uint64_t offset,
+                         uint32_t size,
+                         uint8_t *buffer,
+                         page_cache_fill_t fill,
+                         void *arg);
+
+/**
+ * @brief Fills the missing pages of a range without copying them anywhere.
+ *
+ * Used to read ahead of a sequential reader.
+ *
+ * @return Number of pages added to the cache.
+ */
+uint32_t page_cache_prefetch(page_cache_t *cache,
+                             uint64_t offset,
+                             uint32_t size,
+                             page_cache_fill_t fill,
+                             void *arg);
+
+/**
+ * @brief Updates the cached pages after data has been written to the file.
+ *
+ * Pages that are not cached are left to be read from the backing store. Must
+ * be called once the data is in the backing store, and before the file size
+ * covers it, so that concurrent fills either see the new data or are
+ * dropped.
+ */
+void page_cache_write(page_cache_t *cache,
+                      uint64_t offset,
+                      uint32_t size,
+                      const uint8_t *buffer);
+
+/**
+ * @brief Drops the pages after a new file size and clears the end of the
+ * last page.
+ */
+void page_cache_truncate(page_cache_t *cache, uint64_t size);
+
+/**
+ * @brief Frees every page.
+ */
+void page_cache_destroy(page_cache_t *cache);
+
+void page_cache_get_stats(page_cache_stats_t *stats);
+
+#endif
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -0,0 +1,186 @@
+/**
+ * @file shm.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Shared memory objects
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _SHM_H
+#define _SHM_H
+
+#include <process/process.h>
+#include <vfs/vfs.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Maximum length of a shared memory object name, including the
+ * terminating null.
+ */
+#define SHM_NAME_MAX 64
+
+/**
+ * @brief Range of the address space where shared memory is mapped.
+ *
+ * Lies between the program image and the kernel mappings of the second GB.
+ * System calls return an int, so mappings must stay below 2 GB to be
+ * returned as an address.
+ */
+#define SHM_MAP_BASE 0x20000000
+#define SHM_MAP_END 0x40000000
+
+#define PROT_NONE 0x0
+#define PROT_READ 0x1
+#define PROT_WRITE 0x2
+#define PROT_EXEC 0x4
+
+#define MAP_SHARED 0x01
+#define MAP_PRIVATE 0x02
+#define MAP_FIXED 0x10
+#define MAP_ANONYMOUS 0x20
+
+/**
+ * @brief Named set of physical frames that can be mapped by many processes.
+ *
+ * refs counts open nodes and mappings of the object. The frames are released
+ * when the object has been unlinked and the last reference is dropped.
+ * Anonymous objects are created unlinked.
+ */
+typedef struct _shm_object
+{
+    char name[SHM_NAME_MAX];
+
+    uint64_t size;
+
+    // Physical frames backing the object, one per page of size
+    void **frames;
+    size_t n_frames;
+
+    uint32_t permissions;
+
+    size_t refs;
+
+    // Number of mappings among refs, the object cannot shrink while mapped
+    size_t maps;
+
+    uint8_t unlinked;
+
+    struct _shm_object *next;
+} shm_object_t;
+
+/**
+ * @brief Range of pages of an object mapped into an address space.
+ *
+ * Kept sorted by address in a list on the thread group leader.
+ */
+typedef struct _shm_mapping
+{
+    uintptr_t addr;
+    size_t n_pages;
+
+    shm_object_t *object;
+
+    // First page of the object that is mapped at addr
+    size_t first_page;
+
+    struct _shm_mapping *next;
+} shm_mapping_t;
+
+/**
+ * @brief Opens a shared memory object by name.
+ *
+ * @param name Name of the object, with an optional leading slash.
+ * @param oflag O_CREAT, O_EXCL and O_TRUNC are honored.
+ * @param mode Permissions of a created object.
+ * @param node Receives a node referring to the object, with a reference
+ * count of one.
+ *
+ * @return 0 on success, negative error code on failure.
+ */
+int shm_open(const char *name, int oflag, int mode, fs_node_t **node);
+
+/**
+ * @brief Removes the name of a shared memory object.
+ *
+ * Processes that have the object open or mapped keep using it.
+ *
+ * @return 0 on success, negative error code on failure.
+ */
+int shm_unlink(const char *name);
+
+/**
+ * @brief Checks if a node was created by shm_open.
+ */
+int shm_is_shm(fs_node_t *node);
+
+/**
+ * @brief Sets the size of the object behind a node.
+ *
+ * New pages are zeroed. The object cannot shrink while it is mapped.
+ *
+ * @return 0 on success, negative error code on failure.
+ */
+int shm_truncate(fs_node_t *node, uint64_t length);
+
+/**
+ * @brief Maps an object into the address space of a process.
+ *
+ * @param proc Thread group leader of the process.
+ * @param node Node returned by shm_open, or NULL for a new anonymous object.
+ * @param addr Receives the address of the mapping.
+ * @param length Size of the mapping in bytes.
+ * @param offset Page aligned offset in the object.
+ * @param prot PROT_* flags of the mapping.
+ *
+ * @return 0 on success, negative error code on failure.
+ */
+int shm_map(process_t *proc,
+            fs_node_t *node,
+            uintptr_t *addr,
+            uint64_t length,
+            uint64_t offset,
+            int prot);
+
+/**
+ * @brief Removes mappings of shared memory in a range of addresses.
+ *
+ * Mappings partially covered by the range are split.
+ *
+ * @return 0 on success, negative error code on failure.
+ */
+int shm_unmap(process_t *proc, uintptr_t addr, uint64_t length);
+
+/**
+ * @brief Copies the mapping records of a process to a forked child.
+ *
+ * The page tables themselves are shared by virt_mem_clone_address_space,
+ * this only takes the references held by the mappings of the child.
+ */
+int shm_fork(process_t *parent, process_t *child);
+
+/**
+ * @brief Unmaps all shared memory of an exiting process.
+ */
+void shm_release(process_t *proc);
+
+#endif
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -43,6 +43,7 @@ enum PTE_FLAGS
     PTE_ACCESS = 0x20,
     PTE_DIRTY = 0x40,
     PTE_PAT = 0x80,  // Page attribute table
+    PTE_SHARED = 0x200,  // Available to software, see VIRT_MEM_SHARED
     PTE_ON_CLONE = PTE_PRESENT | PTE_WRITABLE | PTE_USER | PTE_WRITETHROUGH |
                    PTE_NOT_CAHCEABLE,
     PTE_FRAME = 0x7FFFFFFFFFFFF000,
@@ -234,20 +235,30 @@ void virt_mem_print_dir(pml4_t *dir);
 enum VIRT_MEM_FLAGS
 {
     VIRT_MEM_USER = 0x01,
-    VIRT_MEM_WRITABLE = 0x02
+    VIRT_MEM_WRITABLE = 0x02,
+
+    // The frame is shared with other address spaces, and is mapped instead of
+    // copied when the address space is cloned.
+    VIRT_MEM_SHARED = 0x04
 };
 
-// TODO: Add flags for cache, remap, shared
+// TODO: Add flags for cache, remap
 int virt_mem_map_page_p(void *phys, void *virt, uint64_t flags, pml4_t *dir);
 int virt_mem_map_page(void *phys, void *virt, uint64_t flags);
 int virt_mem_map_pages_p(
     void *phys, void *virt, size_t n_pages, uint64_t flags, pml4_t *dir);
 int virt_mem_map_pages(void *phys, void *virt, size_t n_pages, uint64_t flags);
+
+// Removes the mapping of a page without freeing its frame
+int virt_mem_unmap_page_p(void *virt, pml4_t *dir);
 int virt_mem_unmap_page(void *virt);
 int virt_mem_unmap_pages(void *virt, size_t n_pages);
 
 pml4_t *virt_mem_clone_address_space(pml4_t *src);
 
+// Shares the kernel mappings of src without copying any of its user pages
+pml4_t *virt_mem_clone_kernel_space(pml4_t *src);
+
 #endif
 
 //=============================================================================
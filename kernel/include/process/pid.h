@@ -0,0 +1,92 @@
+/**
+ * @file pid.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Process ID allocation and lookup
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _PID_H
+#define _PID_H
+
+#include <stdint.h>
+
+/**
+ * @brief Number of process IDs available, including the reserved IDs 0 and 1.
+ *
+ * May be overridden at build time. The allocator supports up to 64^3 IDs.
+ */
+#ifndef PID_MAX
+#define PID_MAX 32768
+#endif
+
+/**
+ * @brief Number of buckets in the PID hash table. Must be a power of two.
+ */
+#define PID_HASH_SIZE 1024
+
+typedef int32_t pid_t;
+
+struct _process;
+
+/**
+ * @brief Initializes the PID allocator and hash table.
+ */
+void pid_init();
+
+/**
+ * @brief Allocates the lowest free process ID.
+ *
+ * @return The allocated ID, or -1 if all IDs are in use.
+ */
+pid_t pid_alloc();
+
+/**
+ * @brief Releases a process ID for reuse.
+ *
+ * @param pid ID to release.
+ */
+void pid_free(pid_t pid);
+
+/**
+ * @brief Makes a process findable by its ID.
+ *
+ * @param proc Process to insert.
+ */
+void pid_hash_insert(struct _process *proc);
+
+/**
+ * @brief Removes a process from the PID hash table.
+ *
+ * @param proc Process to remove.
+ */
+void pid_hash_remove(struct _process *proc);
+
+/**
+ * @brief Looks up a process by its ID.
+ *
+ * @param pid ID to look up.
+ *
+ * @return The process, or NULL if there is none with that ID.
+ */
+struct _process *pid_hash_lookup(pid_t pid);
+
+#endif
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -25,6 +25,7 @@
 
 #include <arch/arch.h>
 #include <mm/virt_mem.h>
+#include <process/pid.h>
 #include <sync/spinlock.h>
 #include <util/list.h>
 #include <util/tree.h>
@@ -32,21 +33,67 @@
 
 #include <stdint.h>
 
-#define MAX_PIDS 256
-
-typedef int32_t pid_t;
 typedef long long int user_t;
 typedef long long int status_t;
 
+typedef int (*kthread_func_t)(void *arg);
+
+#define SPAWN_FA_CLOSE 0
+#define SPAWN_FA_DUP2 1
+#define SPAWN_FA_CHDIR 2
+
+/**
+ * @brief Action applied to a spawned process before it starts.
+ *
+ * SPAWN_FA_CLOSE closes fd, SPAWN_FA_DUP2 duplicates fd onto newfd and
+ * SPAWN_FA_CHDIR changes the working directory to path. Actions are applied
+ * in order.
+ */
+typedef struct _spawn_file_action
+{
+    int type;
+    int fd;
+    int newfd;
+    const char *path;
+} spawn_file_action_t;
+
 typedef struct _thread
 {
     uintptr_t *rsp;
     uintptr_t rip;
 
     uint8_t fpu_enabled;
-    uint8_t fp_regs[512];
+    uint8_t *fp_regs;
 } thread_t;
 
+/**
+ * @brief Scheduler accounting of a process. Times are in timestamp counter
+ * cycles.
+ */
+typedef struct _sched_stats
+{
+    // Time spent outside of system calls
+    uint64_t user_time;
+
+    // Time spent in system calls, or running as a kernel thread
+    uint64_t system_time;
+
+    // Total and worst time spent runnable in the ready queue
+    uint64_t wait_time;
+    uint64_t max_wait_time;
+
+    // Switches where the process gave up the CPU, and where it was preempted
+    uint64_t voluntary_switches;
+    uint64_t involuntary_switches;
+
+    // Timestamps of when the process last started running or became ready
+    uint64_t run_start;
+    uint64_t ready_start;
+
+    // Nesting depth of system calls, time is charged to system while nonzero
+    uint32_t in_kernel;
+} sched_stats_t;
+
 typedef struct _image
 {
     size_t size;
@@ -76,6 +123,9 @@ typedef struct _process
 {
     pid_t id;
 
+    // Thread group, the pid of the thread that started the process
+    pid_t group;
+
     char *name;
     char *description;
 
@@ -86,6 +136,9 @@ typedef struct _process
 
     tree_node_t *tree_entry;
 
+    // Next process in the same PID hash bucket
+    struct _process *pid_next;
+
     image_t image;
 
     fs_node_t *wd_node;
@@ -100,33 +153,130 @@ typedef struct _process
     uint8_t running;
     uint8_t suspended;
     uint8_t sleeping;
+    uint8_t blocked;
+
+    // Reaped by the kernel when it exits, as nobody waits for it
+    uint8_t detached;
 
     system_stack_t *regs;
 
     list_node_t sched_node;
+    list_node_t wait_node;
 
     uint64_t sleep_ticks;
 
+    sched_stats_t stats;
+
     pml4_t *page_directory;
 
+    // Stack used by system calls made with SYSCALL, NULL to use the caller's
+    uint64_t *syscall_stack;
+
+    // Program and arguments of a spawned process, released with the process
+    void *spawn_image;
+
+    // Submission and completion rings, only set on the thread group leader
+    void *io_ring;
+
+    // Mapped shared memory, only set on the thread group leader
+    void *shm_mappings;
+
+    // Threads of the group other than the leader that have not exited yet,
+    // only counted on the leader
+    uint32_t threads;
+
 } process_t;
 
 void debug_print_process(process_t *process);
 void debug_print_process_tree();
+void debug_print_sched_stats();
 
 void process_delete(process_t *process);
 void process_cleanup(process_t *process, int retval);
 void process_reap(process_t *proc);
 void process_exit(int retval);
 pid_t process_fork();
+
+/**
+ * @brief Creates a new thread in the current process.
+ *
+ * The thread shares the address space and file descriptor table of the
+ * caller, but has a stack, register state and scheduling entity of its own.
+ * It exits with the return value of @p thread_func.
+ *
+ * @param new_stack Top of the stack for the new thread, or 0 to allocate one.
+ * @param thread_func Function the thread starts in.
+ * @param arg Argument passed to @p thread_func.
+ *
+ * @return Thread ID of the new thread, or a negative error code.
+ */
+pid_t process_clone(uintptr_t new_stack, uintptr_t thread_func, uintptr_t arg);
+
+/**
+ * @brief Starts a program in a new process.
+ *
+ * Unlike fork followed by exec, the address space of the caller is never
+ * copied. The child gets a fresh address space sharing only the kernel
+ * mappings, and the program is loaded directly into it. The child inherits
+ * the file descriptors and working directory of the caller, modified by
+ * @p actions.
+ *
+ * @param path Path of the executable.
+ * @param argv NULL terminated argument list, may be NULL.
+ * @param env NULL terminated environment, may be NULL.
+ * @param actions File actions to apply, may be NULL.
+ * @param action_count Number of entries in @p actions.
+ *
+ * @return Process ID of the child, or a negative error code.
+ */
+pid_t process_spawn(const char *path,
+                    char *const argv[],
+                    char *const env[],
+                    const spawn_file_action_t *actions,
+                    size_t action_count);
 void process_switch_task(uint8_t reschedule);
+
+/**
+ * @brief Preempts the current process. Called from the timer interrupt.
+ */
+void process_preempt();
+
+/**
+ * @brief Marks the start and end of a system call, so that the time in
+ * between is accounted as system time.
+ */
+void process_account_syscall_enter();
+void process_account_syscall_exit();
 process_t *process_get_current();
 pid_t process_get_pid();
+process_t *process_from_pid(pid_t pid);
 void process_yield(uint8_t reschedule);
 void process_sleep(uint64_t ms);
+void process_block();
+
+/**
+ * @brief Blocks the current process until it is woken up or @p ms
+ * milliseconds have passed.
+ */
+void process_block_timeout(uint64_t ms);
+void process_wakeup(process_t *process);
 void process_disown(process_t *process);
 int waitpid(int pid, int *status, int options);
 
+/**
+ * @brief Creates a kernel thread.
+ *
+ * Kernel threads run in the kernel address space on a stack of their own and
+ * are children of init. The thread exits with the return value of @p func.
+ *
+ * @param name Name of the thread.
+ * @param func Function to run.
+ * @param arg Argument passed to @p func.
+ *
+ * @return The new thread, or NULL on failure.
+ */
+process_t *kthread_create(const char *name, kthread_func_t func, void *arg);
+
 size_t process_append_fd(process_t *proc, fs_node_t *node);
 size_t process_move_fd(process_t *proc, int src, int dest);
 
@@ -0,0 +1,85 @@
+/**
+ * @file sched_trace.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Context switch trace
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _SCHED_TRACE_H
+#define _SCHED_TRACE_H
+
+#include <process/pid.h>
+
+#include <stdint.h>
+
+/**
+ * @brief Number of context switches kept in the trace ring.
+ */
+#define SCHED_TRACE_SIZE 512
+
+/**
+ * @brief Why the previous process stopped running.
+ */
+enum SCHED_TRACE_REASON
+{
+    SCHED_TRACE_PREEMPT = 0,
+    SCHED_TRACE_YIELD,
+    SCHED_TRACE_SLEEP,
+    SCHED_TRACE_BLOCK,
+    SCHED_TRACE_EXIT,
+};
+
+typedef struct _sched_trace_entry
+{
+    uint64_t timestamp;
+    pid_t prev;
+    pid_t next;
+    uint8_t reason;
+} sched_trace_entry_t;
+
+/**
+ * @brief Records a context switch.
+ *
+ * Called with interrupts disabled. The oldest entry is overwritten when the
+ * ring is full.
+ *
+ * @param prev Process switched out.
+ * @param next Process switched in.
+ * @param reason One of SCHED_TRACE_REASON.
+ * @param timestamp Timestamp counter value at the switch.
+ */
+void sched_trace_record(pid_t prev,
+                        pid_t next,
+                        uint8_t reason,
+                        uint64_t timestamp);
+
+/**
+ * @brief Prints the trace, oldest entry first.
+ */
+void sched_trace_dump();
+
+/**
+ * @brief Mounts the trace as a text file at /dev/schedtrace.
+ */
+void sched_trace_install();
+
+#endif
+
+//=============================================================================
+// End of file
+//=============================================================================
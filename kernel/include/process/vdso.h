@@ -0,0 +1,99 @@
+/**
+ * @file vdso.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Data page shared with programs
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _VDSO_H
+#define _VDSO_H
+
+#include <process/pid.h>
+
+#include <stdint.h>
+
+/**
+ * @brief Address of the data page in every address space.
+ *
+ * The page lives in a 2 MB region of its own, so that its page tables are
+ * shared by all address spaces instead of being copied on fork.
+ */
+#define VDSO_DATA_ADDR 0x7FE00000
+
+/**
+ * @brief Data published by the kernel. Must match libc/include/_vdso.h.
+ *
+ * The clock fields are protected by seq, which is odd while the kernel is
+ * updating them. Readers retry until they see the same even value before and
+ * after reading.
+ */
+typedef struct _vdso_data
+{
+    volatile uint32_t seq;
+
+    // Nonzero once the timestamp counter has been calibrated. Until then the
+    // clock advances in timer ticks.
+    uint32_t tsc_valid;
+
+    // Timestamp counter value at the last update, and the monotonic time in
+    // nanoseconds at that point
+    uint64_t tsc_base;
+    uint64_t mono_base_ns;
+
+    // Nanoseconds = (cycles * tsc_mult) >> tsc_shift
+    uint64_t tsc_mult;
+    uint32_t tsc_shift;
+    uint32_t reserved;
+
+    // Wall clock time in seconds at boot
+    int64_t boot_time;
+
+    // Identity of the running thread, updated on every context switch
+    volatile pid_t pid;
+    volatile pid_t tid;
+} vdso_data_t;
+
+/**
+ * @brief Allocates the data page and maps it at VDSO_DATA_ADDR.
+ *
+ * Must be called before any other address space is created.
+ */
+void vdso_install();
+
+/**
+ * @brief Publishes the identity of the thread about to run.
+ *
+ * @param pid Process ID, the thread group of the thread.
+ * @param tid Thread ID.
+ */
+void vdso_set_current(pid_t pid, pid_t tid);
+
+/**
+ * @brief Reads the clock published in the data page.
+ *
+ * @param realtime Nonzero for wall clock time, zero for time since boot.
+ * @param sec Receives the seconds.
+ * @param nsec Receives the nanoseconds.
+ */
+void vdso_get_time(int realtime, int64_t *sec, int64_t *nsec);
+
+#endif
+
+//=============================================================================
+// End of file
+//=============================================================================
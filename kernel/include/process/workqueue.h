@@ -0,0 +1,112 @@
+/**
+ * @file workqueue.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Deferred work executed by kernel worker threads
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _WORKQUEUE_H
+#define _WORKQUEUE_H
+
+#include <process/process.h>
+#include <sync/wait_queue.h>
+#include <util/list.h>
+
+#include <stdint.h>
+
+typedef void (*work_func_t)(void *arg);
+
+/**
+ * @brief A unit of deferred work.
+ *
+ * Work items are usually embedded in the structure they operate on. An item
+ * that is already pending is not queued a second time, so interrupt handlers
+ * may schedule the same item repeatedly.
+ */
+typedef struct _work
+{
+    work_func_t func;
+    void *arg;
+
+    volatile uint8_t pending;
+
+    list_node_t node;
+} work_t;
+
+/**
+ * @brief Queue of work items serviced by a dedicated kernel thread.
+ */
+typedef struct _workqueue
+{
+    char *name;
+
+    list_t items;
+    wait_queue_t wait;
+
+    process_t *worker;
+} workqueue_t;
+
+/**
+ * @brief Initializes a work item.
+ *
+ * @param work Work item to initialize.
+ * @param func Function to run.
+ * @param arg Argument passed to @p func.
+ */
+void work_init(work_t *work, work_func_t func, void *arg);
+
+/**
+ * @brief Creates a work queue along with its worker thread.
+ *
+ * @param name Name of the queue, also used for the worker thread.
+ *
+ * @return The new queue, or NULL on failure.
+ */
+workqueue_t *workqueue_create(const char *name);
+
+/**
+ * @brief Queues a work item. Safe to call from interrupt context.
+ *
+ * @param queue Queue to add the item to.
+ * @param work Work item.
+ *
+ * @return 1 if the item was queued, 0 if it was already pending.
+ */
+int workqueue_queue(workqueue_t *queue, work_t *work);
+
+/**
+ * @brief Queues a work item on the system work queue.
+ *
+ * Work scheduled before the system queue exists is run immediately.
+ *
+ * @param work Work item.
+ *
+ * @return 1 if the item was queued, 0 if it was already pending.
+ */
+int schedule_work(work_t *work);
+
+/**
+ * @brief Creates the system work queue.
+ */
+void workqueue_install();
+
+#endif
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -32,6 +32,9 @@ int rm_command(int argc, const char **argv);
 int exit_command(int argc, const char **argv);
 int time_command(int argc, const char **argv);
 int launch_command(int argc, const char **argv);
+int sched_command(int argc, const char **argv);
+int syscalls_command(int argc, const char **argv);
+int cachestat_command(int argc, const char **argv);
 
 #endif
 
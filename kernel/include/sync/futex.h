@@ -0,0 +1,76 @@
+/**
+ * @file futex.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Fast user-space locking primitive
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _FUTEX_H
+#define _FUTEX_H
+
+#include <stdint.h>
+
+#define FUTEX_WAIT 0
+#define FUTEX_WAKE 1
+#define FUTEX_REQUEUE 3
+
+/**
+ * @brief Sleeps on a futex word, unless it has changed.
+ *
+ * Futexes are keyed by the physical address of the word, so all threads and
+ * processes mapping the same memory share the futex.
+ *
+ * @param uaddr Futex word.
+ * @param val Value the word is expected to hold.
+ *
+ * @return 0 when woken, -EAGAIN if the word did not hold @p val or -EFAULT if
+ * @p uaddr is not mapped.
+ */
+int futex_wait(volatile uint32_t *uaddr, uint32_t val);
+
+/**
+ * @brief Wakes processes sleeping on a futex word.
+ *
+ * @param uaddr Futex word.
+ * @param count Maximum number of processes to wake.
+ *
+ * @return Number of processes woken, or -EFAULT.
+ */
+int futex_wake(volatile uint32_t *uaddr, int count);
+
+/**
+ * @brief Wakes processes sleeping on a futex word and moves the remaining
+ * sleepers to another futex word, without waking them.
+ *
+ * @param uaddr Futex word.
+ * @param wake_count Maximum number of processes to wake.
+ * @param uaddr2 Futex word to requeue sleepers to.
+ * @param requeue_count Maximum number of processes to requeue.
+ *
+ * @return Number of processes woken or requeued, or -EFAULT.
+ */
+int futex_requeue(volatile uint32_t *uaddr,
+                  int wake_count,
+                  volatile uint32_t *uaddr2,
+                  int requeue_count);
+
+#endif
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -0,0 +1,90 @@
+/**
+ * @file wait_queue.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Queue of processes blocked on an event
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _WAIT_QUEUE_H
+#define _WAIT_QUEUE_H
+
+#include <util/list.h>
+
+#include <stdint.h>
+
+/**
+ * @brief List of processes sleeping until some event happens.
+ *
+ * Waiters are linked through process_t::wait_node, so a queue never
+ * allocates memory and may be woken from interrupt context.
+ */
+typedef struct _wait_queue
+{
+    list_t waiters;
+} wait_queue_t;
+
+/**
+ * @brief Initializes an empty wait queue.
+ *
+ * @param queue Queue to initialize.
+ */
+void wait_queue_init(wait_queue_t *queue);
+
+/**
+ * @brief Blocks the current process until it is woken up.
+ *
+ * The caller is expected to re-check its wake condition after returning.
+ *
+ * @param queue Queue to sleep on.
+ */
+void wait_queue_sleep(wait_queue_t *queue);
+
+/**
+ * @brief Blocks the current process until it is woken up, or until a timeout
+ * expires.
+ *
+ * @param queue Queue to sleep on.
+ * @param ms Timeout in milliseconds.
+ *
+ * @return 1 if woken through the queue, 0 if the timeout expired.
+ */
+int wait_queue_sleep_timeout(wait_queue_t *queue, uint64_t ms);
+
+/**
+ * @brief Wakes the process that has waited the longest.
+ *
+ * @param queue Queue to wake.
+ *
+ * @return Number of processes woken.
+ */
+int wait_queue_wake_one(wait_queue_t *queue);
+
+/**
+ * @brief Wakes all processes waiting on the queue.
+ *
+ * @param queue Queue to wake.
+ *
+ * @return Number of processes woken.
+ */
+int wait_queue_wake_all(wait_queue_t *queue);
+
+#endif
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -0,0 +1,192 @@
+/**
+ * @file io_ring.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Batched asynchronous system calls
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _IO_RING_H
+#define _IO_RING_H
+
+#include <sync/wait_queue.h>
+
+#include <stdint.h>
+
+//=============================================================================
+// Shared layout
+//
+// Must match libc/include/io_ring.h.
+//=============================================================================
+
+/**
+ * @brief Maximum number of entries in a submission ring.
+ */
+#define IO_RING_MAX_ENTRIES 4096
+
+#define IO_RING_OP_NOP 0
+#define IO_RING_OP_READ 1
+#define IO_RING_OP_WRITE 2
+#define IO_RING_OP_OPEN 3
+#define IO_RING_OP_CLOSE 4
+#define IO_RING_OP_STAT 5
+
+/**
+ * @brief Offset value for reads and writes that use and advance the file
+ * offset, instead of reading at a given position.
+ */
+#define IO_RING_OFFSET_CURRENT ((uint64_t)-1)
+
+/**
+ * @brief Block in io_ring_enter until at least min_complete completions are
+ * available.
+ */
+#define IO_RING_ENTER_GETEVENTS 0x01
+
+/**
+ * @brief One queued operation.
+ *
+ * Field use per operation:
+ * - READ/WRITE: fd, addr = buffer, len, off = position or
+ *   IO_RING_OFFSET_CURRENT.
+ * - OPEN: addr = path, open_flags, len = mode.
+ * - CLOSE: fd.
+ * - STAT: addr = path, or NULL to stat fd, addr2 = struct stat.
+ */
+typedef struct _io_ring_sqe
+{
+    uint8_t opcode;
+    uint8_t flags;
+    uint16_t reserved;
+    int32_t fd;
+    uint64_t off;
+    uint64_t addr;
+    uint64_t addr2;
+    uint32_t len;
+    uint32_t open_flags;
+    uint64_t user_data;
+} io_ring_sqe_t;
+
+/**
+ * @brief Result of one operation, in the order they complete.
+ */
+typedef struct _io_ring_cqe
+{
+    uint64_t user_data;
+    int32_t res;
+    uint32_t flags;
+} io_ring_cqe_t;
+
+/**
+ * @brief Ring header. The entries follow the header.
+ *
+ * The producer only writes tail and the consumer only writes head. Both
+ * count up forever and are masked to index the entries.
+ */
+typedef struct _io_ring_header
+{
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    uint32_t mask;
+    uint32_t entries;
+} io_ring_header_t;
+
+/**
+ * @brief Filled in by io_ring_setup.
+ */
+typedef struct _io_ring_params
+{
+    uint32_t sq_entries;
+    uint32_t cq_entries;
+
+    // Submission ring header followed by sq_entries io_ring_sqe_t
+    uint64_t sq_ring;
+
+    // Completion ring header followed by cq_entries io_ring_cqe_t
+    uint64_t cq_ring;
+} io_ring_params_t;
+
+//=============================================================================
+// Kernel interface
+//=============================================================================
+
+struct _process;
+
+/**
+ * @brief Ring state of one process.
+ */
+typedef struct _io_ring
+{
+    io_ring_header_t *sq;
+    io_ring_sqe_t *sqes;
+
+    io_ring_header_t *cq;
+    io_ring_cqe_t *cqes;
+
+    // Memory holding both rings, handed out to the process
+    void *memory;
+
+    // Worker thread, in the thread group of the owner so that it shares the
+    // address space and the file descriptors.
+    struct _process *worker;
+
+    // The worker sleeps here waiting for submissions...
+    wait_queue_t submit_wait;
+
+    // ...and wakes callers of io_ring_enter here when completing entries.
+    wait_queue_t complete_wait;
+
+    volatile uint8_t stopping;
+} io_ring_t;
+
+/**
+ * @brief Creates the rings of the current process and starts its worker.
+ *
+ * @param entries Requested number of submission entries, rounded up to a
+ * power of two. The completion ring is twice as large.
+ * @param params Receives the ring sizes and addresses.
+ *
+ * @return 0 on success, negative error code on failure.
+ */
+int io_ring_setup(uint32_t entries, io_ring_params_t *params);
+
+/**
+ * @brief Hands new submissions to the worker, optionally waiting for
+ * completions.
+ *
+ * @param to_submit Number of entries queued since the last call. Only used
+ * to decide whether to wake the worker.
+ * @param min_complete Number of completions to wait for.
+ * @param flags IO_RING_ENTER_* flags.
+ *
+ * @return Number of completions available, or negative error code.
+ */
+int io_ring_enter(uint32_t to_submit, uint32_t min_complete, uint32_t flags);
+
+/**
+ * @brief Stops the worker of an exiting process. The rings are freed by the
+ * worker once it has finished the entry it is processing.
+ *
+ * @param proc Exiting process.
+ */
+void io_ring_release(struct _process *proc);
+
+#endif
+
+//=============================================================================
+// End of file
+//=============================================================================
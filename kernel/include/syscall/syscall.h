@@ -26,6 +26,9 @@
 #include <arch/arch.h>
 #include <debug/backtrace.h>
 #include <process/process.h>
+#include <syscall/io_ring.h>
+#include <vfs/epoll.h>
+#include <vfs/poll.h>
 #include <vfs/vfs.h>
 
 #include <errno.h>
@@ -81,6 +84,37 @@
 #define SYSCALL_GETTIMEOFDAY 29
 #define SYSCALL_SETTIMEOFDAY 30
 
+#define SYSCALL_FUTEX 31
+
+#define SYSCALL_SPAWN 32
+
+#define SYSCALL_READV 33
+#define SYSCALL_WRITEV 34
+#define SYSCALL_PREAD 35
+#define SYSCALL_PWRITE 36
+
+#define SYSCALL_IO_RING_SETUP 37
+#define SYSCALL_IO_RING_ENTER 38
+
+#define SYSCALL_GETDENTS 39
+
+#define SYSCALL_COPY_FILE_RANGE 40
+#define SYSCALL_SENDFILE 41
+
+#define SYSCALL_PIPE 42
+#define SYSCALL_SPLICE 43
+
+#define SYSCALL_SHM_OPEN 44
+#define SYSCALL_SHM_UNLINK 45
+#define SYSCALL_FTRUNCATE 46
+#define SYSCALL_MMAP 47
+#define SYSCALL_MUNMAP 48
+
+#define SYSCALL_POLL 49
+#define SYSCALL_EPOLL_CREATE 50
+#define SYSCALL_EPOLL_CTL 51
+#define SYSCALL_EPOLL_WAIT 52
+
 #define _IFMT 0170000 /* type of file */
 #define S_ISBLK(m) (((m)&_IFMT) == _IFBLK)
 #define S_ISCHR(m) (((m)&_IFMT) == _IFCHR)
@@ -117,7 +151,7 @@ int syscall_yield(int reschedule);   // DONE
 int syscall_sleep(uint64_t ms);      // DONE
 
 int syscall_fork();
-int syscall_clone();
+int syscall_clone(uintptr_t new_stack, uintptr_t thread_func, uintptr_t arg);
 int syscall_kill(pid_t process, uint32_t signal);
 
 int syscall_open(const char *file, int flags, int mode);       // DONE
@@ -150,6 +184,65 @@ int syscall_getcwd(char *buf, size_t size);  // DONE
 int syscall_gettimeofday(struct timeval *tv, struct timezone *tz);
 int syscall_settimeofday(const struct timeval *tv, const struct timezone *tz);
 
+int syscall_futex(uint32_t *uaddr,
+                  int op,
+                  uint32_t val,
+                  uint32_t val2,
+                  uint32_t *uaddr2);
+
+int syscall_spawn(const char *path,
+                  char **argv,
+                  char **env,
+                  const spawn_file_action_t *actions,
+                  size_t action_count);
+
+int syscall_readv(int fd, const struct iovec *iov, int iovcnt);
+int syscall_writev(int fd, const struct iovec *iov, int iovcnt);
+int syscall_pread(int fd, char *ptr, uint64_t len, int64_t offset);
+int syscall_pwrite(int fd, char *ptr, uint64_t len, int64_t offset);
+
+int syscall_io_ring_setup(uint32_t entries, io_ring_params_t *params);
+int syscall_io_ring_enter(uint32_t to_submit,
+                          uint32_t min_complete,
+                          uint32_t flags);
+
+int syscall_getdents(int fd, void *buffer, size_t size);
+
+int syscall_copy_file_range(int fd_in,
+                            int64_t *off_in,
+                            int fd_out,
+                            int64_t *off_out,
+                            uint64_t len,
+                            unsigned int flags);
+int syscall_sendfile(int out_fd, int in_fd, int64_t *offset, uint64_t count);
+
+int syscall_pipe(int *fds);
+int syscall_splice(int fd_in,
+                   int64_t *off_in,
+                   int fd_out,
+                   int64_t *off_out,
+                   uint64_t len,
+                   unsigned int flags);
+
+int syscall_shm_open(const char *name, int oflag, int mode);
+int syscall_shm_unlink(const char *name);
+int syscall_ftruncate(int fd, int64_t length);
+int syscall_mmap(uintptr_t addr,
+                 uint64_t length,
+                 int prot,
+                 int flags,
+                 int fd,
+                 int64_t offset);
+int syscall_munmap(uintptr_t addr, uint64_t length);
+
+int syscall_poll(struct pollfd *fds, uint64_t nfds, int timeout);
+int syscall_epoll_create(int size);
+int syscall_epoll_ctl(int epfd, int op, int fd, struct epoll_event *event);
+int syscall_epoll_wait(int epfd,
+                       struct epoll_event *events,
+                       int maxevents,
+                       int timeout);
+
 void syscall_install();
 
 int64_t do_syscall0(int64_t syscall);
@@ -0,0 +1,140 @@
+/**
+ * @file syscall_trace.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief System call statistics and tracing
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _SYSCALL_TRACE_H
+#define _SYSCALL_TRACE_H
+
+#include <process/pid.h>
+
+#include <stdint.h>
+
+/**
+ * @brief Size of the system call table.
+ */
+#define SYSCALL_MAX 128
+
+/**
+ * @brief Number of latency histogram buckets. Bucket i counts calls that took
+ * between 2^i and 2^(i+1) - 1 cycles, the last one everything longer.
+ */
+#define SYSCALL_HIST_BUCKETS 32
+
+/**
+ * @brief Number of system calls kept in the trace ring.
+ */
+#define SYSCALL_TRACE_SIZE 1024
+
+/**
+ * @brief Thread group value that traces every process.
+ */
+#define SYSCALL_TRACE_ALL -1
+
+typedef struct _syscall_stats
+{
+    uint64_t count;
+
+    // Timestamp counter cycles spent in the call
+    uint64_t total_cycles;
+    uint64_t max_cycles;
+
+    uint64_t histogram[SYSCALL_HIST_BUCKETS];
+} syscall_stats_t;
+
+/**
+ * @brief Traced system call, as read from /dev/systrace.
+ */
+typedef struct _syscall_trace_entry
+{
+    uint64_t timestamp;
+    uint64_t cycles;
+
+    pid_t pid;
+    uint32_t number;
+
+    uint64_t args[6];
+    int64_t retval;
+} syscall_trace_entry_t;
+
+/**
+ * @brief Nonzero while a process is traced.
+ *
+ * The only thing the system call path looks at when tracing is off.
+ */
+extern volatile int syscall_trace_enabled;
+
+/**
+ * @brief Accounts a completed system call.
+ *
+ * @param number System call number.
+ * @param cycles Timestamp counter cycles spent in the call.
+ */
+void syscall_stats_record(uint64_t number, uint64_t cycles);
+
+/**
+ * @brief Records a system call in the trace ring if the current process is
+ * traced.
+ *
+ * The oldest entry is overwritten when the ring is full.
+ */
+void syscall_trace_record(uint64_t number,
+                          const uint64_t *args,
+                          int64_t retval,
+                          uint64_t timestamp,
+                          uint64_t cycles);
+
+/**
+ * @brief Selects the thread group to trace.
+ *
+ * @param group Thread group to trace, SYSCALL_TRACE_ALL for every process,
+ * or 0 to stop tracing.
+ */
+void syscall_trace_set(pid_t group);
+
+/**
+ * @brief Prints the counters of all system calls that have been made.
+ */
+void syscall_stats_dump();
+
+/**
+ * @brief Clears the counters.
+ */
+void syscall_stats_reset();
+
+/**
+ * @brief Prints and removes the entries in the trace ring.
+ */
+void syscall_trace_dump();
+
+/**
+ * @brief Mounts the counters as a text file at /dev/syscalls, and the trace
+ * ring at /dev/systrace.
+ *
+ * Reading /dev/systrace drains whole syscall_trace_entry_t records. Writing
+ * a pid, "all" or "off" to it selects what is traced.
+ */
+void syscall_trace_install();
+
+#endif
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -32,6 +32,13 @@
  */
 void usb_poll();
 
+/**
+ * @brief Starts a kernel thread that periodically polls all USB devices
+ *
+ *
+ */
+void usb_start_poll_thread();
+
 #endif
 
 //=============================================================================
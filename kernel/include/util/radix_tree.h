@@ -0,0 +1,98 @@
+/**
+ * @file radix_tree.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Radix tree mapping integer indices to pointers
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _RADIX_TREE_H
+#define _RADIX_TREE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define RADIX_TREE_SHIFT 6
+#define RADIX_TREE_SLOTS (1 << RADIX_TREE_SHIFT)
+
+typedef struct _radix_tree_node
+{
+    void *slots[RADIX_TREE_SLOTS];
+
+    // Number of slots in use
+    uint32_t count;
+} radix_tree_node_t;
+
+/**
+ * @brief Sparse array indexed by a 64 bit integer.
+ *
+ * A tree of height h holds the indices below 2^(RADIX_TREE_SHIFT * h), and
+ * grows as larger indices are inserted. Lookups touch h nodes.
+ */
+typedef struct _radix_tree
+{
+    radix_tree_node_t *root;
+    uint32_t height;
+} radix_tree_t;
+
+void radix_tree_init(radix_tree_t *tree);
+
+/**
+ * @brief Gets the item at an index, or NULL if there is none.
+ */
+void *radix_tree_lookup(radix_tree_t *tree, uint64_t index);
+
+/**
+ * @brief Inserts an item at an index.
+ *
+ * @return 0 on success, -1 if the index is in use or memory ran out.
+ */
+int radix_tree_insert(radix_tree_t *tree, uint64_t index, void *item);
+
+/**
+ * @brief Removes the item at an index, freeing nodes that become empty.
+ *
+ * @return The removed item, or NULL if there was none.
+ */
+void *radix_tree_delete(radix_tree_t *tree, uint64_t index);
+
+/**
+ * @brief Gets the items at or after an index, in index order.
+ *
+ * @param first First index to look at.
+ * @param items Array receiving the items.
+ * @param indices Array receiving the indices of the items, may be NULL.
+ * @param max Size of the arrays.
+ *
+ * @return Number of items found.
+ */
+size_t radix_tree_gang_lookup(radix_tree_t *tree,
+                              uint64_t first,
+                              void **items,
+                              uint64_t *indices,
+                              size_t max);
+
+/**
+ * @brief Frees all nodes of the tree. The items are not freed.
+ */
+void radix_tree_destroy(radix_tree_t *tree);
+
+#endif
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -0,0 +1,99 @@
+/**
+ * @file dcache.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Directory entry cache
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _DCACHE_H
+#define _DCACHE_H
+
+#include <vfs/vfs.h>
+
+#include <stdint.h>
+
+/**
+ * @brief Maximum number of cached entries. The least recently used entry is
+ * evicted when a new entry would exceed it.
+ */
+#define DCACHE_MAX_ENTRIES 512
+
+/**
+ * @brief Number of hash buckets, a power of two.
+ */
+#define DCACHE_BUCKETS 256
+
+typedef struct _dcache_stats
+{
+    uint64_t hits;
+    uint64_t negative_hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t invalidations;
+
+    uint32_t entries;
+} dcache_stats_t;
+
+/**
+ * @brief Looks up a name in a directory, going to the file system on a miss.
+ *
+ * The node returned by the file system, or the absence of one, is cached
+ * with the directory and the name as key.
+ *
+ * @param parent Directory to look in.
+ * @param name Name of the entry.
+ *
+ * @return Copy of the node, owned by the caller, or NULL if there is no
+ * entry with that name.
+ */
+fs_node_t *dcache_finddir(fs_node_t *parent, char *name);
+
+/**
+ * @brief Drops the entry for a name in a directory.
+ *
+ * Called before and after the file system adds or removes the name.
+ */
+void dcache_invalidate(fs_node_t *parent, const char *name);
+
+/**
+ * @brief Drops all entries that refer to a node.
+ *
+ * Called when the attributes of the node change, so that the next lookup
+ * reads them from the file system.
+ */
+void dcache_invalidate_node(fs_node_t *node);
+
+/**
+ * @brief Drops all entries in a directory.
+ *
+ * Called when the directory is removed, since its inode may be reused.
+ */
+void dcache_invalidate_dir(fs_node_t *dir);
+
+/**
+ * @brief Drops every entry.
+ */
+void dcache_flush();
+
+void dcache_get_stats(dcache_stats_t *stats);
+
+#endif
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -0,0 +1,175 @@
+/**
+ * @file epoll.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Event polling with kernel side interest lists
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _EPOLL_H
+#define _EPOLL_H
+
+#include <sync/wait_queue.h>
+#include <vfs/poll.h>
+#include <vfs/vfs.h>
+
+#include <stdint.h>
+
+#define EPOLLIN POLLIN
+#define EPOLLPRI POLLPRI
+#define EPOLLOUT POLLOUT
+#define EPOLLERR POLLERR
+#define EPOLLHUP POLLHUP
+
+// Report readiness once per notification instead of while it lasts
+#define EPOLLET (1u << 31)
+
+// Disable the item after its first report, until rearmed with EPOLL_CTL_MOD
+#define EPOLLONESHOT (1u << 30)
+
+#define EPOLL_CTL_ADD 1
+#define EPOLL_CTL_DEL 2
+#define EPOLL_CTL_MOD 3
+
+typedef union epoll_data
+{
+    void *ptr;
+    int fd;
+    uint32_t u32;
+    uint64_t u64;
+} epoll_data_t;
+
+struct epoll_event
+{
+    uint32_t events;
+    epoll_data_t data;
+} __attribute__((packed));
+
+struct _epoll;
+
+/**
+ * @brief File descriptor watched by an epoll instance.
+ */
+typedef struct _epoll_item
+{
+    // Registered with the watched node through its selectwait operation
+    poll_entry_t entry;
+
+    struct _epoll *ep;
+
+    // The node is not referenced. The item is removed when the node is
+    // closed, see epoll_node_closed.
+    int fd;
+    fs_node_t *node;
+    int mode;
+
+    uint32_t events;
+    epoll_data_t data;
+
+    uint8_t ready;
+
+    // Next item in the interest list
+    struct _epoll_item *next;
+
+    // Next item in the ready list
+    struct _epoll_item *ready_next;
+
+    // Items watching nodes with the same hash, of all instances
+    struct _epoll_item *watch_prev;
+    struct _epoll_item *watch_next;
+} epoll_item_t;
+
+/**
+ * @brief Epoll instance.
+ *
+ * Watched nodes push their items onto the ready list when they change, so
+ * waiting only looks at items that may be ready. Level triggered items are
+ * put back on the list after being reported, and dropped once a check finds
+ * them no longer ready.
+ */
+typedef struct _epoll
+{
+    epoll_item_t *items;
+
+    epoll_item_t *ready_first;
+    epoll_item_t *ready_last;
+
+    wait_queue_t waiters;
+} epoll_t;
+
+/**
+ * @brief Creates an epoll instance.
+ *
+ * @param node Receives the node of the instance, with a reference count of
+ * one.
+ *
+ * @return 0 on success, negative error code on failure.
+ */
+int epoll_create(fs_node_t **node);
+
+/**
+ * @brief Checks if a node was created by epoll_create.
+ */
+int epoll_is_epoll(fs_node_t *node);
+
+/**
+ * @brief Adds, modifies or removes a watched file descriptor.
+ *
+ * @param epoll Node of the instance.
+ * @param op EPOLL_CTL_ADD, EPOLL_CTL_MOD or EPOLL_CTL_DEL.
+ * @param fd File descriptor, identifies the item together with @a target.
+ * @param target Node of the file descriptor.
+ * @param mode Access mode of the file descriptor.
+ * @param event Events to watch and data to report, unused for
+ * EPOLL_CTL_DEL.
+ *
+ * @return 0 on success, negative error code on failure.
+ */
+int epoll_ctl(fs_node_t *epoll,
+              int op,
+              int fd,
+              fs_node_t *target,
+              int mode,
+              struct epoll_event *event);
+
+/**
+ * @brief Waits for events on the watched file descriptors.
+ *
+ * @param epoll Node of the instance.
+ * @param events Receives the events.
+ * @param maxevents Size of @a events.
+ * @param timeout Timeout in milliseconds, negative to wait forever.
+ *
+ * @return Number of events, 0 on timeout.
+ */
+int epoll_wait(fs_node_t *epoll,
+               struct epoll_event *events,
+               int maxevents,
+               int timeout);
+
+/**
+ * @brief Removes a node from all epoll instances watching it.
+ *
+ * Called by close_fs when the last reference to the node is dropped.
+ */
+void epoll_node_closed(fs_node_t *node);
+
+#endif
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -23,7 +23,11 @@
 #ifndef _EXT2_H
 #define _EXT2_H
 
+#include <mm/page_cache.h>
+#include <process/workqueue.h>
 #include <sync/spinlock.h>
+#include <sync/wait_queue.h>
+#include <util/radix_tree.h>
 #include <vfs/vfs.h>
 
 #include <stdint.h>
@@ -164,15 +168,79 @@ typedef struct
     char name[];
 } __attribute__((packed)) ext2_dir_t;
 
-typedef struct
+// Default number of blocks in the disk cache
+#define EXT2_CACHE_ENTRIES 1024
+
+// Interval at which the flusher writes back dirty blocks
+#define EXT2_FLUSH_INTERVAL_MS 5000
+
+// Maximum number of blocks written back in one batch
+#define EXT2_FLUSH_BATCH 64
+
+typedef struct _ext2_disk_cache_entry
 {
     uint32_t block_no;
-    uint32_t last_use;
+
+    // Bumped on every write, to detect writes while the block is flushed
+    uint32_t write_seq;
+
     uint8_t dirty;
     uint8_t *block;
+
+    struct _ext2_disk_cache_entry *hash_next;
+
+    // Clean list, or dirty list if the block is dirty
+    struct _ext2_disk_cache_entry *prev;
+    struct _ext2_disk_cache_entry *next;
 } ext2_disk_cache_entry_t;
 
 typedef struct
+{
+    ext2_disk_cache_entry_t *head;
+    ext2_disk_cache_entry_t *tail;
+    uint32_t count;
+} ext2_cache_list_t;
+
+// Number of hash buckets in the inode cache, a power of two
+#define EXT2_INODE_CACHE_BUCKETS 64
+
+// Number of unreferenced inodes kept in the inode cache
+#define EXT2_INODE_CACHE_SIZE 256
+
+// Number of block mappings kept per cached inode
+#define EXT2_BLOCK_MAP_SIZE 8192
+
+// Number of blocks allocated ahead of a regular file growing at its end
+#define EXT2_PREALLOC_BLOCKS 8
+
+typedef struct _ext2_inode_cache_entry
+{
+    uint32_t inode_no;
+    uint32_t refcount;
+    uint8_t dirty;
+
+    // Data of the file, dropped with the entry
+    page_cache_t pages;
+
+    // Physical block numbers by logical block, indirect blocks only
+    radix_tree_t block_map;
+    uint32_t block_map_count;
+    spinlock_t block_map_lock;
+
+    // Free blocks reserved for the next blocks of the file
+    uint32_t prealloc_block;
+    uint32_t prealloc_count;
+
+    struct _ext2_inode_cache_entry *hash_next;
+
+    // Least recently released entries last, unreferenced entries only
+    struct _ext2_inode_cache_entry *lru_prev;
+    struct _ext2_inode_cache_entry *lru_next;
+
+    // Followed by the inode, inode_size bytes
+} ext2_inode_cache_entry_t;
+
+typedef struct _ext2_fs
 {
     ext2_superblock_t *superblock;
     ext2_bgdescriptor_t *block_groups;
@@ -187,24 +255,101 @@ typedef struct
 
     ext2_disk_cache_entry_t *disk_cache;
     uint32_t cache_entries;
-    uint32_t cache_time;
+
+    ext2_disk_cache_entry_t **cache_buckets;
+    uint32_t cache_bucket_count;
+
+    // Clean blocks, most recently used first. Evicted from the tail.
+    ext2_cache_list_t clean;
+
+    // Dirty blocks, in the order they were first written
+    ext2_cache_list_t dirty;
 
     spinlock_t lock;
 
+    // Serializes write back, which uses flush_buffer
+    spinlock_t flush_lock;
+    uint8_t *flush_buffer;
+
+    wait_queue_t flusher_wait;
+    uint8_t flusher_running;
+
     uint8_t bgd_block_span;
     uint8_t bgd_offset;
     uint32_t inode_size;
 
     uint8_t *cache_data;
 
+    ext2_inode_cache_entry_t *inode_cache[EXT2_INODE_CACHE_BUCKETS];
+    ext2_inode_cache_entry_t *inode_lru_head;
+    ext2_inode_cache_entry_t *inode_lru_tail;
+    uint32_t inode_cache_unused;
+    spinlock_t inode_lock;
+
     uint32_t flags;
 
+    struct _ext2_fs *next;
+
 } ext2_fs_t;
 
 #define EXT2_FLAG_NOCACHE 0x0001
 
+// Smallest and largest readahead window
+#define EXT2_READAHEAD_MIN 0x4000
+#define EXT2_READAHEAD_MAX 0x80000
+
+/**
+ * @brief Readahead state of an open regular file.
+ *
+ * A read that starts where the previous one ended is sequential. When a
+ * sequential reader gets into the window prefetched last, the next window is
+ * prefetched in the background, twice as large up to EXT2_READAHEAD_MAX.
+ * Any other read resets the window.
+ */
+typedef struct _ext2_readahead
+{
+    ext2_fs_t *fs;
+    uint32_t inode;
+
+    // Offset following the last read
+    uint64_t next_offset;
+
+    // Window prefetched last, 0 sized when not reading sequentially
+    uint64_t window_start;
+    uint32_t window;
+
+    // Range handed to the worker
+    uint64_t work_offset;
+    uint32_t work_size;
+    work_t work;
+
+    // The open file, and each queued run of the work
+    uint32_t refs;
+
+    spinlock_t lock;
+} ext2_readahead_t;
+
+typedef struct _ext2_readahead_stats
+{
+    uint64_t sequential;
+    uint64_t random;
+    uint64_t windows;
+} ext2_readahead_stats_t;
+
 fs_node_t *ext2_fs_mount(char *device, char *mount_path);
 int ext2_initialize();
+
+/**
+ * @brief Starts the threads writing back dirty blocks of the mounted file
+ * systems, and the readahead worker. Called once tasking is up.
+ */
+void ext2_start_flusher();
+
+void ext2_readahead_get_stats(ext2_readahead_stats_t *stats);
+
+/**
+ * @brief Writes back all dirty blocks.
+ */
 int ext2_finalize();
 
 #endif
@@ -0,0 +1,142 @@
+/**
+ * @file pipe.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Anonymous pipes
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _PIPE_H
+#define _PIPE_H
+
+#include <sync/wait_queue.h>
+#include <vfs/poll.h>
+#include <vfs/vfs.h>
+
+#include <stdint.h>
+
+/**
+ * @brief Size of the pipe buffer. Must be a power of two.
+ */
+#define PIPE_SIZE 0x10000
+
+/**
+ * @brief Single producer, single consumer ring shared by the two ends.
+ *
+ * head and tail count bytes written and read since creation. The writer only
+ * moves head and the reader only moves tail, so data is copied without
+ * holding a lock. Interrupts are only disabled to publish a new position
+ * together with the wakeup it implies.
+ */
+typedef struct _pipe
+{
+    uint8_t *buffer;
+    uint64_t size;
+
+    volatile uint64_t head;
+    volatile uint64_t tail;
+
+    // Readers sleep here while the pipe is empty...
+    wait_queue_t readers;
+
+    // ...and writers while it is full.
+    wait_queue_t writers;
+
+    // Watchers of the read and write ends, notified on the same transitions
+    poll_head_t read_poll;
+    poll_head_t write_poll;
+
+    fs_node_t *read_node;
+    fs_node_t *write_node;
+
+    volatile uint8_t read_closed;
+    volatile uint8_t write_closed;
+
+    // The ring has a single producer and a single consumer. Threads sharing
+    // an end take turns using it, sleeping here while another one holds it.
+    volatile uint8_t read_locked;
+    volatile uint8_t write_locked;
+    wait_queue_t read_lock_wait;
+    wait_queue_t write_lock_wait;
+} pipe_t;
+
+/**
+ * @brief Creates a pipe.
+ *
+ * The nodes are returned with a reference count of one each. The pipe is
+ * freed once both have been closed.
+ *
+ * @param read_node Receives the read end.
+ * @param write_node Receives the write end.
+ *
+ * @return 0 on success, negative error code on failure.
+ */
+int pipe_create(fs_node_t **read_node, fs_node_t **write_node);
+
+/**
+ * @brief Checks if a node is an end of a pipe created by pipe_create.
+ */
+int pipe_is_pipe(fs_node_t *node);
+
+/**
+ * @brief Gets POLLHUP for a read end whose write end has been closed, and
+ * POLLERR for a write end whose read end has been closed.
+ */
+int pipe_hangup_events(fs_node_t *node);
+
+/**
+ * @brief Moves data from a node into a pipe, without an intermediate buffer.
+ *
+ * Blocks while the pipe is full. Data is read from @a src directly into the
+ * ring.
+ *
+ * @param pipe_node Write end of the pipe.
+ * @param src Node to read from.
+ * @param offset Offset in @a src.
+ * @param size Maximum number of bytes to move.
+ *
+ * @return Number of bytes moved, or negative error code.
+ */
+int pipe_splice_from(fs_node_t *pipe_node,
+                     fs_node_t *src,
+                     uint64_t offset,
+                     uint32_t size);
+
+/**
+ * @brief Moves data from a pipe into a node, without an intermediate buffer.
+ *
+ * Blocks while the pipe is empty and the write end is open. Data is written
+ * to @a dst directly from the ring.
+ *
+ * @param pipe_node Read end of the pipe.
+ * @param dst Node to write to.
+ * @param offset Offset in @a dst.
+ * @param size Maximum number of bytes to move.
+ *
+ * @return Number of bytes moved, 0 if the write end is closed and the pipe is
+ * empty, or negative error code.
+ */
+int pipe_splice_to(fs_node_t *pipe_node,
+                   fs_node_t *dst,
+                   uint64_t offset,
+                   uint32_t size);
+
+#endif
+
+//=============================================================================
+// End of file
+//=============================================================================
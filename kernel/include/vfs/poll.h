@@ -0,0 +1,118 @@
+/**
+ * @file poll.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Readiness notification
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _POLL_H
+#define _POLL_H
+
+#include <vfs/vfs.h>
+
+#include <stdint.h>
+
+#define POLLIN 0x0001
+#define POLLPRI 0x0002
+#define POLLOUT 0x0004
+#define POLLERR 0x0008
+#define POLLHUP 0x0010
+#define POLLNVAL 0x0020
+
+// Maximum number of entries in a single poll call
+#define POLL_MAX 1024
+
+struct pollfd
+{
+    int fd;
+    short events;
+    short revents;
+};
+
+/**
+ * @brief Called when the readiness of a watched node changes.
+ *
+ * May be called with interrupts disabled, from the process that changed the
+ * state of the node. Must not block.
+ *
+ * @param entry Entry that was registered.
+ * @param events POLL* events that may have become ready.
+ */
+typedef void (*poll_notify_func_t)(struct poll_entry *entry, int events);
+
+/**
+ * @brief Registration of a watcher on a poll head.
+ *
+ * Owned by the watcher, which must remove it before it is freed.
+ */
+typedef struct poll_entry
+{
+    struct _poll_head *head;
+
+    struct poll_entry *prev;
+    struct poll_entry *next;
+
+    poll_notify_func_t notify;
+
+    void *data;
+} poll_entry_t;
+
+/**
+ * @brief List of watchers of a node, embedded in the state of the node.
+ */
+typedef struct _poll_head
+{
+    poll_entry_t *first;
+} poll_head_t;
+
+void poll_head_init(poll_head_t *head);
+
+/**
+ * @brief Adds a watcher, used by the selectwait operation of a node.
+ */
+void poll_head_add(poll_head_t *head, poll_entry_t *entry);
+
+/**
+ * @brief Removes a watcher from the head it was added to, if any.
+ */
+void poll_head_remove(poll_entry_t *entry);
+
+/**
+ * @brief Notifies all watchers of a head.
+ *
+ * Nodes call this when an operation that would have blocked no longer
+ * does, so watchers never have to rescan the nodes that did not change.
+ */
+void poll_head_notify(poll_head_t *head, int events);
+
+/**
+ * @brief Gets the events of a node that are ready now.
+ *
+ * @param node Node to check.
+ * @param mode Access mode of the file descriptor, 01 read and 02 write.
+ *
+ * @return POLLIN and POLLOUT, limited to the access mode, and POLLHUP or
+ * POLLERR once the other end of a pipe has been closed.
+ */
+int poll_node_events(fs_node_t *node, int mode);
+
+#endif
+
+//=============================================================================
+// End of file
+//=============================================================================
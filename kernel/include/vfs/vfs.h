@@ -197,6 +197,24 @@
 
 struct fs_node;
 
+/**
+ * @brief Maximum number of buffers in one vectored read or write
+ *
+ *
+ */
+#define IOV_MAX 1024
+
+/**
+ * @brief One buffer of a vectored read or write
+ *
+ *
+ */
+struct iovec
+{
+    void *iov_base;
+    size_t iov_len;
+};
+
 /**
  * @brief Type of function to read from a node
  *
@@ -308,12 +326,15 @@ typedef int (*readlink_func_t)(struct fs_node *, char *buf, size_t size);
  */
 typedef int (*selectcheck_func_t)(struct fs_node *);
 
+struct poll_entry;
+
 /**
  * @brief Type of function to perform a selectwait operation
  *
- *
+ * Registers the entry to be notified when the readiness of the node changes.
+ * Returns -1 if the node never blocks.
  */
-typedef int (*selectwait_func_t)(struct fs_node *, void *process);
+typedef int (*selectwait_func_t)(struct fs_node *, struct poll_entry *entry);
 
 /**
  * @brief Type of function to change owner file
@@ -329,6 +350,54 @@ typedef int (*chown_func_t)(struct fs_node *, int, int);
  */
 typedef int (*truncate_func_t)(struct fs_node *);
 
+/**
+ * @brief Type of function to read from a node into several buffers
+ *
+ *
+ */
+typedef uint32_t (*readv_func_t)(struct fs_node *,
+                                 uint64_t,
+                                 const struct iovec *,
+                                 int);
+
+/**
+ * @brief Type of function to write to a node from several buffers
+ *
+ *
+ */
+typedef uint32_t (*writev_func_t)(struct fs_node *,
+                                  uint64_t,
+                                  const struct iovec *,
+                                  int);
+
+/**
+ * @brief Type of function to read many directory entries at once
+ *
+ * Fills the buffer with struct vfs_dirent records starting at the entry
+ * identified by the cursor, and advances the cursor past the last entry
+ * written. The cursor is opaque to the caller and 0 refers to the first
+ * entry.
+ *
+ * Returns the number of bytes written, 0 at the end of the directory or
+ * -EINVAL if the buffer is too small for the next entry.
+ */
+typedef int (*getdents_func_t)(struct fs_node *,
+                               uint64_t *cursor,
+                               uint8_t *buffer,
+                               size_t size);
+
+/**
+ * @brief Type of function to copy data between two nodes of the same file
+ * system
+ *
+ *
+ */
+typedef uint32_t (*copy_range_func_t)(struct fs_node *src,
+                                      uint64_t src_offset,
+                                      struct fs_node *dst,
+                                      uint64_t dst_offset,
+                                      uint32_t size);
+
 /**
  * @brief Struct representing a node in the file system
  *
@@ -574,6 +643,45 @@ typedef struct fs_node
      */
     selectwait_func_t selectwait;
 
+    /**
+     * @brief Function used to read into several buffers. Optional, reads are
+     * split into one call to read per buffer if not set.
+     *
+     *
+     */
+    readv_func_t readv;
+
+    /**
+     * @brief Function used to write from several buffers. Optional, writes
+     * are split into one call to write per buffer if not set.
+     *
+     *
+     */
+    writev_func_t writev;
+
+    /**
+     * @brief Function used to read many directory entries at once. Optional,
+     * readdir is called once per entry if not set.
+     *
+     *
+     */
+    getdents_func_t getdents;
+
+    /**
+     * @brief Function used to copy data to another node on the same device.
+     * Optional, data is copied through a kernel buffer if not set.
+     *
+     *
+     */
+    copy_range_func_t copy_range;
+
+    /**
+     * @brief State of the open file, owned by the file system. Set by open
+     * and released by close.
+     *
+     */
+    void *private_data;
+
 } fs_node_t;
 
 struct dirent
@@ -582,6 +690,30 @@ struct dirent
     uint32_t ino;
 };
 
+#define DT_UNKNOWN 0
+#define DT_FIFO 1
+#define DT_CHR 2
+#define DT_DIR 4
+#define DT_BLK 6
+#define DT_REG 8
+#define DT_LNK 10
+#define DT_SOCK 12
+
+/**
+ * @brief Directory entry as returned by getdents.
+ *
+ * Records are packed back to back. Each is d_reclen bytes long, a multiple of
+ * 8, and d_name is NUL-terminated.
+ */
+struct vfs_dirent
+{
+    uint32_t d_ino;
+    uint16_t d_reclen;
+    uint8_t d_type;
+    uint8_t reserved;
+    char d_name[];
+};
+
 struct stat
 {
     uint16_t st_dev;
@@ -635,9 +767,100 @@ uint32_t write_fs(fs_node_t *node,
                   uint64_t offset,
                   uint32_t size,
                   uint8_t *buffer);
+
+/**
+ * @brief Reads consecutive bytes from the VFS into several buffers.
+ *
+ * Each buffer is filled before moving on to the next. Stops at the first
+ * short read.
+ *
+ * @param node Node to read from.
+ * @param offset Offset to start reading from.
+ * @param iov Array of buffers.
+ * @param iovcnt Number of buffers in @a iov.
+ *
+ * @return Total number of bytes read.
+ */
+uint32_t readv_fs(fs_node_t *node,
+                  uint64_t offset,
+                  const struct iovec *iov,
+                  int iovcnt);
+
+/**
+ * @brief Writes several buffers to consecutive bytes in the VFS.
+ *
+ * @param node Node to write to.
+ * @param offset Offset to start writing at.
+ * @param iov Array of buffers.
+ * @param iovcnt Number of buffers in @a iov.
+ *
+ * @return Total number of bytes written.
+ */
+uint32_t writev_fs(fs_node_t *node,
+                   uint64_t offset,
+                   const struct iovec *iov,
+                   int iovcnt);
 void open_fs(fs_node_t *node, uint32_t flags);
 void close_fs(fs_node_t *node);
 struct dirent *readdir_fs(fs_node_t *node, uint32_t index);
+
+/**
+ * @brief Reads as many directory entries as fit in a buffer.
+ *
+ * @param node Directory to read.
+ * @param cursor Position in the directory, 0 to start from the beginning.
+ * Advanced past the entries returned.
+ * @param buffer Buffer receiving struct vfs_dirent records.
+ * @param size Size of @a buffer.
+ *
+ * @return Number of bytes written, 0 at the end of the directory, or negative
+ * error code.
+ */
+int getdents_fs(fs_node_t *node,
+                uint64_t *cursor,
+                uint8_t *buffer,
+                size_t size);
+
+/**
+ * @brief Copies data from one node to another without leaving the kernel.
+ *
+ * Uses the copy_range operation when both nodes belong to the same file
+ * system instance, otherwise copies in chunks through a kernel buffer.
+ *
+ * @param src Node to copy from.
+ * @param src_offset Offset to start reading at.
+ * @param dst Node to copy to.
+ * @param dst_offset Offset to start writing at.
+ * @param size Number of bytes to copy.
+ *
+ * @return Number of bytes copied.
+ */
+uint32_t copy_range_fs(fs_node_t *src,
+                       uint64_t src_offset,
+                       fs_node_t *dst,
+                       uint64_t dst_offset,
+                       uint32_t size);
+
+/**
+ * @brief Appends one record to a getdents buffer.
+ *
+ * @param buffer Buffer being filled.
+ * @param size Size of @a buffer.
+ * @param used Bytes used so far, advanced by the record size.
+ * @param ino Inode number.
+ * @param type Entry type, one of DT_*.
+ * @param name Name of the entry, not necessarily NUL-terminated.
+ * @param name_len Length of @a name.
+ *
+ * @return 1 if the record was added, 0 if it did not fit.
+ */
+int vfs_dirent_emit(uint8_t *buffer,
+                    size_t size,
+                    size_t *used,
+                    uint32_t ino,
+                    uint8_t type,
+                    const char *name,
+                    size_t name_len);
 fs_node_t *finddir_fs(fs_node_t *node, char *name);
 int mkdir_fs(char *name, uint16_t permission);
 int create_file_fs(char *name, uint16_t permission);
@@ -650,7 +873,7 @@ int unlink_fs(char *name);
 int symlink_fs(char *target, char *name);
 int readlink_fs(fs_node_t *node, char *buf, size_t size);
 int selectcheck_fs(fs_node_t *node);
-int selectwait_fs(fs_node_t *node, void *process);
+int selectwait_fs(fs_node_t *node, struct poll_entry *entry);
 void truncate_fs(fs_node_t *node);
 
 //=============================================================================
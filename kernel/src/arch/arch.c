@@ -33,6 +33,7 @@
 #include <arch/x86-64/idt.h>
 #include <arch/x86-64/pic.h>
 #include <arch/x86-64/pit.h>
+#include <arch/x86-64/syscall.h>
 #endif
 
 void arch_initialize()
@@ -63,6 +64,8 @@ void arch_initialize()
 
     log_info("[ARCH] FPU Done!");
 
+    arch_x86_64_initialize_syscall();
+
     log_info("[ARCH] x64-64 Done!");
 #endif
 }
@@ -141,6 +144,36 @@ void cli()
     __asm__ volatile("cli" ::: "memory");
 }
 
+uint64_t irq_save()
+{
+    uint64_t flags;
+
+    __asm__ volatile("pushfq; pop %0" : "=r"(flags) : : "memory");
+
+    cli();
+
+    return flags;
+}
+
+void irq_restore(uint64_t flags)
+{
+    // Only the interrupt flag (bit 9) is of interest
+    if (flags & (1 << 9))
+    {
+        sti();
+    }
+}
+
+uint64_t read_timestamp()
+{
+    uint32_t lo;
+    uint32_t hi;
+
+    __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+
+    return ((uint64_t)hi << 32) | lo;
+}
+
 void interrupt_done(uint32_t intno)
 {
     intno -= 0x20;
@@ -176,6 +209,13 @@ void set_irq_handler(int irq, IRQ_HANDLER irq_handler)
     arch_x86_64_install_irq(irq, irq_handler);
 }
 
+void set_exception_handler(int exception, IRQ_HANDLER exception_handler)
+{
+    log_info("[ARCH] Installing exception handler for exception %i",
+             exception);
+    arch_x86_64_install_exception_handler(exception, exception_handler);
+}
+
 tick_count_t get_tick_count()
 {
     return arch_x86_64_pit_get_tick_count();
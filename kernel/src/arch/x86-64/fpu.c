@@ -20,10 +20,57 @@
  *
  */
 
+#include <arch/x86-64/cpu.h>
 #include <arch/x86-64/fpu.h>
+#include <logging/logging.h>
+#include <mm/kheap.h>
 
 #include <string.h>
 
+//=============================================================================
+// Local data
+//=============================================================================
+
+#define FXSAVE_AREA_SIZE 512
+
+// Largest XSAVE area we are prepared to handle. Enough for x87, SSE and AVX
+// with plenty of room for future state components.
+#define XSAVE_AREA_MAX_SIZE 4096
+
+#define XCR0_X87 (1 << 0)
+#define XCR0_SSE (1 << 1)
+#define XCR0_AVX (1 << 2)
+
+#define CR4_OSXSAVE (1 << 18)
+
+static size_t fpu_state_size = FXSAVE_AREA_SIZE;
+static uint8_t fpu_use_xsave = 0;
+static uint8_t fpu_use_xsaveopt = 0;
+static uint64_t fpu_xcr0 = 0;
+
+// State of a freshly initialized FPU, copied into every new state area. Both
+// FXSAVE and XSAVE require the memory to be aligned.
+static uint8_t fpu_initial_state[XSAVE_AREA_MAX_SIZE] __attribute__((aligned(64)));
+
+static inline void cpuid_count(uint32_t leaf,
+                               uint32_t subleaf,
+                               uint32_t *eax,
+                               uint32_t *ebx,
+                               uint32_t *ecx,
+                               uint32_t *edx)
+{
+    __asm__ volatile("cpuid"
+                     : "=a"(*eax), "=b"(*ebx), "=c"(*ecx), "=d"(*edx)
+                     : "0"(leaf), "2"(subleaf));
+}
+
+static inline void xsetbv(uint32_t index, uint64_t value)
+{
+    __asm__ volatile("xsetbv" ::"c"(index),
+                     "a"((uint32_t)value),
+                     "d"((uint32_t)(value >> 32)));
+}
+
 void arch_x64_64_set_fpu_cw(const uint16_t cw)
 {
     __asm__ volatile("fldcw %0" ::"m"(cw));
@@ -101,28 +148,141 @@ void arch_x64_64_init_fpu()
     __asm__ volatile("fninit");
 }
 
+static void arch_x64_64_enable_xsave()
+{
+    uint32_t eax, ebx, ecx, edx;
+
+    size_t t;
+
+    __asm__ volatile("mov %%cr4, %0" : "=r"(t));
+
+    t |= CR4_OSXSAVE;
+
+    __asm__ volatile("mov %0, %%cr4" ::"r"(t));
+
+    fpu_xcr0 = XCR0_X87 | XCR0_SSE;
+
+    if (arch_x86_64_cpu_query_feature(CPU_FEAT_AVX))
+    {
+        fpu_xcr0 |= XCR0_AVX;
+    }
+
+    xsetbv(0, fpu_xcr0);
+
+    // EBX holds the size required by the components enabled in XCR0
+    cpuid_count(0x0D, 0, &eax, &ebx, &ecx, &edx);
+
+    if (ebx > XSAVE_AREA_MAX_SIZE)
+    {
+        log_warn("[FPU] XSAVE area too large (%i bytes), using FXSAVE", ebx);
+
+        xsetbv(0, XCR0_X87 | XCR0_SSE);
+        fpu_xcr0 = 0;
+
+        return;
+    }
+
+    fpu_state_size = ebx;
+    fpu_use_xsave = 1;
+
+    cpuid_count(0x0D, 1, &eax, &ebx, &ecx, &edx);
+
+    fpu_use_xsaveopt = eax & 1;
+
+    log_info("[FPU] Using %s, XCR0: %#x, area size: %i bytes",
+             fpu_use_xsaveopt ? "XSAVEOPT" : "XSAVE",
+             fpu_xcr0,
+             fpu_state_size);
+}
+
 void arch_x64_64_install_fpu()
 {
     arch_x64_64_enable_fpu();
     arch_x64_64_init_fpu();
+
+    if (arch_x86_64_cpu_query_feature(CPU_FEAT_XSAVE))
+    {
+        arch_x64_64_enable_xsave();
+    }
+
+    memset(fpu_initial_state, 0, sizeof(fpu_initial_state));
+
+    arch_x64_64_save_fpu(fpu_initial_state);
 }
 
-// This buffer must be at least 512 bytes large and
-// the memory must be 16 byte aligned to avoid GP faults
-static uint8_t __fxsave_buffer[512] __attribute__((aligned(16)));
+size_t arch_x64_64_fpu_state_size()
+{
+    return fpu_state_size;
+}
 
-void arch_x64_64_restore_fpu(void *buffer)
+void *arch_x64_64_alloc_fpu_state()
 {
-    memcpy(__fxsave_buffer, buffer, 512);
+    void *buffer = kmalloc_a(fpu_state_size, 64);
 
-    __asm__ volatile("fxrstor (%0)" ::"r"(__fxsave_buffer));
+    if (buffer)
+    {
+        memcpy(buffer, fpu_initial_state, fpu_state_size);
+    }
+
+    return buffer;
 }
 
-void arch_x64_64_save_fpu(void *buffer)
+void arch_x64_64_free_fpu_state(void *buffer)
+{
+    kfree(buffer);
+}
+
+void arch_x64_64_fpu_set_ts()
+{
+    size_t t;
+
+    __asm__ volatile("mov %%cr0, %0" : "=r"(t));
+
+    t |= (1 << 3);
+
+    __asm__ volatile("mov %0, %%cr0" ::"r"(t));
+}
+
+void arch_x64_64_fpu_clear_ts()
 {
-    __asm__ volatile("fxsave (%0)" ::"r"(__fxsave_buffer));
+    __asm__ volatile("clts");
+}
 
-    memcpy(buffer, __fxsave_buffer, 512);
+void arch_x64_64_restore_fpu(void *buffer)
+{
+    if (fpu_use_xsave)
+    {
+        __asm__ volatile("xrstor64 (%0)" ::"r"(buffer),
+                         "a"((uint32_t)fpu_xcr0),
+                         "d"((uint32_t)(fpu_xcr0 >> 32))
+                         : "memory");
+    }
+    else
+    {
+        __asm__ volatile("fxrstor (%0)" ::"r"(buffer) : "memory");
+    }
+}
+
+void arch_x64_64_save_fpu(void *buffer)
+{
+    if (fpu_use_xsaveopt)
+    {
+        __asm__ volatile("xsaveopt64 (%0)" ::"r"(buffer),
+                         "a"((uint32_t)fpu_xcr0),
+                         "d"((uint32_t)(fpu_xcr0 >> 32))
+                         : "memory");
+    }
+    else if (fpu_use_xsave)
+    {
+        __asm__ volatile("xsave64 (%0)" ::"r"(buffer),
+                         "a"((uint32_t)fpu_xcr0),
+                         "d"((uint32_t)(fpu_xcr0 >> 32))
+                         : "memory");
+    }
+    else
+    {
+        __asm__ volatile("fxsave (%0)" ::"r"(buffer) : "memory");
+    }
 }
 
 //=============================================================================
@@ -182,10 +182,20 @@ void print_regs(system_stack_t *regs)
 }
 
 static IRQ_HANDLER _irq_handlers[256] = {0};
+static IRQ_HANDLER _exception_handlers[32] = {0};
 
 void arch_x86_64_default_irq_handler(system_stack_t *regs)
 {
-    if (regs->int_no >= 32 && regs->int_no < 48)
+    if (regs->int_no < 32)
+    {
+        if (_exception_handlers[regs->int_no])
+        {
+            _exception_handlers[regs->int_no](regs);
+
+            return;
+        }
+    }
+    else if (regs->int_no >= 32 && regs->int_no < 48)
     {
         int irq = regs->int_no - 32;
 
@@ -199,7 +209,7 @@ void arch_x86_64_default_irq_handler(system_stack_t *regs)
 
             if (irq == 0)
             {
-                process_switch_task(1);
+                process_preempt();
             }
 
             return;
@@ -265,6 +275,17 @@ void arch_x86_64_install_irq(int irq, IRQ_HANDLER irq_handler)
     _irq_handlers[irq] = irq_handler;
 }
 
+void arch_x86_64_install_exception_handler(int exception,
+                                           IRQ_HANDLER exception_handler)
+{
+    if (exception < 0 || exception >= 32)
+    {
+        return;
+    }
+
+    _exception_handlers[exception] = exception_handler;
+}
+
 extern void arch_x86_64_isr_0(void);
 extern void arch_x86_64_isr_1(void);
 extern void arch_x86_64_isr_2(void);
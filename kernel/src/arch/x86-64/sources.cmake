@@ -11,5 +11,7 @@ kernel_source(pit.c)
 kernel_source(atomic.c)
 kernel_source(fpu.c)
 kernel_source(read_cr2.asm)
+kernel_source(syscall.c)
+kernel_source(syscall_entry.asm)
 
 # TODO: Reorganize the files in this file.
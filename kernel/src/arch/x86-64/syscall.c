@@ -0,0 +1,84 @@
+/**
+ * @file syscall.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief SYSCALL/SYSRET fast system call entry
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <arch/x86-64/syscall.h>
+
+#include <arch/x86-64/msr.h>
+#include <logging/logging.h>
+
+#include <stddef.h>
+
+//=============================================================================
+// Definitions
+//=============================================================================
+
+#define EFER_SCE (1 << 0)
+
+#define KERNEL_CS 0x08
+
+// Flags cleared on entry: TF, IF, DF and AC
+#define SYSCALL_FLAG_MASK 0x40700
+
+//=============================================================================
+// Local data
+//=============================================================================
+
+static arch_x86_64_cpu_local_t cpu_local = {0};
+
+// Called by the entry stub
+arch_x86_64_syscall_handler_t arch_x86_64_syscall_handler = NULL;
+
+extern void arch_x86_64_syscall_entry();
+
+//=============================================================================
+// Interface functions
+//=============================================================================
+
+void arch_x86_64_initialize_syscall()
+{
+    log_info("[ARCH] Enabling SYSCALL");
+
+    // The kernel has a single CPU, whose local data is reached through GS
+    wrmsr(MSR_GS_BASE, (uint64_t)&cpu_local);
+
+    // SYSCALL loads CS from STAR[47:32] and SS from the following selector.
+    // SYSRET is not used, as the kernel and the programs share ring 0.
+    wrmsr(MSR_STAR, (uint64_t)KERNEL_CS << 32);
+    wrmsr(MSR_LSTAR, (uint64_t)&arch_x86_64_syscall_entry);
+    wrmsr(MSR_SYSCALL_FLAG_MASK, SYSCALL_FLAG_MASK);
+
+    wrmsr(MSR_EFER, rdmsr(MSR_EFER) | EFER_SCE);
+}
+
+void arch_x86_64_set_syscall_handler(arch_x86_64_syscall_handler_t handler)
+{
+    arch_x86_64_syscall_handler = handler;
+}
+
+void arch_x86_64_set_syscall_stack(uintptr_t stack_top)
+{
+    cpu_local.syscall_stack = stack_top;
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -0,0 +1,65 @@
+global arch_x86_64_syscall_entry
+
+extern arch_x86_64_syscall_handler
+
+bits 64
+
+; Offsets in arch_x86_64_cpu_local_t
+%define CPU_SYSCALL_STACK 0
+%define CPU_USER_RSP 8
+
+; Entered through SYSCALL with rcx holding the return address, r11 holding
+; rflags and interrupts masked. Since everything runs in ring 0, the stub
+; returns with popfq and an indirect jump instead of SYSRET.
+arch_x86_64_syscall_entry:
+    mov [gs:CPU_USER_RSP], rsp
+    mov rsp, [gs:CPU_SYSCALL_STACK]
+    test rsp, rsp
+    jnz .stack_swapped
+
+    ; No system call stack, stay below the red zone of the caller
+    mov rsp, [gs:CPU_USER_RSP]
+    sub rsp, 128
+    and rsp, -16
+
+.stack_swapped:
+    push qword [gs:CPU_USER_RSP]
+    push rcx
+    push r11
+    push rdi
+    push rsi
+    push rdx
+    push r10
+    push r8
+    push r9
+    push rax
+
+    mov rdi, rsp
+    mov rax, [rel arch_x86_64_syscall_handler]
+    test rax, rax
+    jz .no_handler
+    cld
+    call rax
+    jmp .done
+
+.no_handler:
+    mov rax, -88 ; -ENOSYS
+
+.done:
+    add rsp, 8
+    pop r9
+    pop r8
+    pop r10
+    pop rdx
+    pop rsi
+    pop rdi
+    pop r11
+    pop rcx
+
+    ; Restore the flags while still on this stack, it is safe to take
+    ; interrupts here
+    push r11
+    popfq
+
+    mov rsp, [rsp]
+    jmp rcx
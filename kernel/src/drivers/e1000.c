@@ -25,6 +25,7 @@
 #include <logging/logging.h>
 #include <mm/phys_mem.h>
 #include <mm/virt_mem.h>
+#include <process/workqueue.h>
 #include <sync/spinlock.h>
 #include <util/hexdump.h>
 #include <util/list.h>
@@ -145,6 +146,9 @@ typedef struct e1000_device
     spinlock_t packet_queue_lock;
     list_t *packet_queue;
 
+    volatile uint32_t pending_status;
+    work_t irq_work;
+
     rx_descriptor_t *rx;
     tx_descriptor_t *tx;
 } e1000_device_t;
@@ -386,18 +390,34 @@ static void e1000_handle(e1000_device_t *device, uint32_t status)
     }
 }
 
-static void e1000_irq_handler(system_stack_t *regs)
+static void e1000_irq_work(void *arg)
 {
-    log_info("[E1000] Got interrupt");
+    e1000_device_t *device = (e1000_device_t *)arg;
+
+    uint64_t flags = irq_save();
+    uint32_t status = device->pending_status;
+    device->pending_status = 0;
+    irq_restore(flags);
+
+    log_info("[E1000] Handling interrupt");
+
+    e1000_handle(device, status);
+    read_command(device, REG_ICR);
+    write_command(device, 0x00D0, INTS);
+}
 
+static void e1000_irq_handler(system_stack_t *regs)
+{
+    // Reading ICR acknowledges the interrupt
     uint32_t status = read_command(device, REG_ICR);
 
     if (status)
     {
+        // Interrupts stay masked until the work queue has processed the
+        // received packets.
         write_command(device, 0x00D8, INTS);
-        e1000_handle(device, status);
-        read_command(device, REG_ICR);
-        write_command(device, 0x00D0, INTS);
+        device->pending_status |= status;
+        schedule_work(&device->irq_work);
     }
 }
 
@@ -528,6 +548,9 @@ void e1000_init(uint32_t id, PciDeviceInfo_t *deviceInfo)
 
     device->irq = deviceInfo->type0.InterruptLine;
 
+    device->pending_status = 0;
+    work_init(&device->irq_work, e1000_irq_work, device);
+
     uint8_t irq_pin = deviceInfo->type0.InterruptPin;
     uint8_t irq_line = deviceInfo->type0.InterruptLine;
 
@@ -43,6 +43,7 @@
 #include <pci/pci.h>
 #include <process/launch_program.h>
 #include <process/process.h>
+#include <process/workqueue.h>
 #include <serial/serial.h>
 #include <simple_cli/simple_cli.h>
 #include <syscall/syscall.h>
@@ -464,6 +465,10 @@ int kernel_main(unsigned long long rbx, unsigned long long rax)
 
     tasking_install();
 
+    workqueue_install();
+
+    ext2_start_flusher();
+
     // exec_elf("bin/hello_world", 0, NULL, NULL, 0);
 
     // printf("My pid: %d\n", pid);
@@ -553,12 +558,11 @@ int kernel_main(unsigned long long rbx, unsigned long long rax)
 
     test_crypto();
 
+    usb_start_poll_thread();
+
     simple_cli_init();
 
-    while (1)
-    {
-        usb_poll();
-    }
+    ext2_finalize();
 
     acpi_power_off();
 
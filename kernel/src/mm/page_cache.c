@@ -0,0 +1,412 @@
+/**
+ * @file page_cache.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Per-file cache of pages
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <mm/page_cache.h>
+
+#include <mm/phys_mem.h>
+
+#include <string.h>
+
+// Number of pages looked up at a time when dropping pages
+#define PAGE_CACHE_GANG 16
+
+//=============================================================================
+// Local data
+//=============================================================================
+
+// Pages cached for all files
+static size_t page_cache_total = 0;
+
+static page_cache_stats_t page_cache_stats;
+
+//=============================================================================
+// Local functions
+//=============================================================================
+
+static void page_cache_drop(page_cache_t *cache, uint64_t index)
+{
+    uint8_t *page = radix_tree_delete(&cache->pages, index);
+
+    if (page)
+    {
+        phys_mem_free_block(page);
+
+        cache->count--;
+
+        __atomic_sub_fetch(&page_cache_total, 1, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Counts the missing pages in a row from a missing page, up to the
+ * last page of the range and PAGE_CACHE_FILL_MAX. Called with the lock held.
+ */
+static uint32_t page_cache_missing_run(page_cache_t *cache,
+                                       uint64_t index,
+                                       uint64_t last)
+{
+    uint32_t want = last - index + 1 < PAGE_CACHE_FILL_MAX
+                        ? last - index + 1
+                        : PAGE_CACHE_FILL_MAX;
+    uint32_t run = 1;
+
+    while (run < want && !radix_tree_lookup(&cache->pages, index + run))
+    {
+        ++run;
+    }
+
+    return run;
+}
+
+/**
+ * @brief Allocates and fills a run of pages, contiguous if possible.
+ *
+ * @param run Number of pages wanted, set to the number filled.
+ *
+ * @return The pages, or NULL on failure.
+ */
+static uint8_t *page_cache_fill_run(uint64_t index,
+                                    uint32_t *run,
+                                    page_cache_fill_t fill,
+                                    void *arg)
+{
+    uint8_t *pages = *run > 1 ? phys_mem_alloc_blocks(*run) : NULL;
+
+    if (!pages)
+    {
+        *run = 1;
+        pages = phys_mem_alloc_block();
+    }
+
+    if (pages && fill(arg, index, *run, pages) != 0)
+    {
+        for (uint32_t i = 0; i < *run; ++i)
+        {
+            phys_mem_free_block(pages + i * PAGE_SIZE);
+        }
+
+        pages = NULL;
+    }
+
+    return pages;
+}
+
+/**
+ * @brief Adds a filled page, unless someone else cached it in the meantime,
+ * the file changed since the fill started or the cache is full. Called with
+ * the lock held.
+ *
+ * @param seq Value of the sequence when the page was found missing.
+ *
+ * @return 1 if the page was added and is owned by the cache.
+ */
+static int page_cache_insert(page_cache_t *cache,
+                             uint64_t index,
+                             uint8_t *page,
+                             uint64_t seq)
+{
+    if (cache->seq != seq || radix_tree_lookup(&cache->pages, index))
+    {
+        return 0;
+    }
+
+    if (__atomic_load_n(&page_cache_total, __ATOMIC_RELAXED) >=
+        PAGE_CACHE_MAX_PAGES)
+    {
+        return 0;
+    }
+
+    if (radix_tree_insert(&cache->pages, index, page) != 0)
+    {
+        return 0;
+    }
+
+    cache->count++;
+
+    __atomic_add_fetch(&page_cache_total, 1, __ATOMIC_RELAXED);
+
+    return 1;
+}
+
+//=============================================================================
+// Interface functions
+//=============================================================================
+
+void page_cache_init(page_cache_t *cache)
+{
+    radix_tree_init(&cache->pages);
+
+    cache->count = 0;
+    cache->seq = 0;
+
+    spinlock_init(&cache->lock);
+}
+
+uint32_t page_cache_read(page_cache_t *cache,
+                         uint64_t offset,
+                         uint32_t size,
+                         uint8_t *buffer,
+                         page_cache_fill_t fill,
+                         void *arg)
+{
+    uint64_t last = (offset + size - 1) / PAGE_SIZE;
+
+    uint32_t done = 0;
+
+    while (done < size)
+    {
+        uint64_t index = (offset + done) / PAGE_SIZE;
+        uint32_t page_offset = (offset + done) % PAGE_SIZE;
+        uint32_t count = PAGE_SIZE - page_offset;
+
+        if (count > size - done)
+        {
+            count = size - done;
+        }
+
+        spinlock_lock(&cache->lock);
+
+        uint8_t *page = radix_tree_lookup(&cache->pages, index);
+
+        if (page)
+        {
+            memcpy(buffer + done, page + page_offset, count);
+
+            spinlock_unlock(&cache->lock);
+
+            __atomic_add_fetch(&page_cache_stats.hits, 1, __ATOMIC_RELAXED);
+
+            done += count;
+
+            continue;
+        }
+
+        uint32_t run = page_cache_missing_run(cache, index, last);
+        uint64_t seq = cache->seq;
+
+        spinlock_unlock(&cache->lock);
+
+        uint8_t *pages = page_cache_fill_run(index, &run, fill, arg);
+
+        if (!pages)
+        {
+            break;
+        }
+
+        __atomic_add_fetch(&page_cache_stats.misses, run, __ATOMIC_RELAXED);
+
+        uint8_t kept[PAGE_CACHE_FILL_MAX];
+
+        spinlock_lock(&cache->lock);
+
+        for (uint32_t i = 0; i < run; ++i)
+        {
+            uint8_t *new_page = pages + i * PAGE_SIZE;
+
+            kept[i] = page_cache_insert(cache, index + i, new_page, seq);
+
+            // Copies from the cached page if someone else filled it first
+            page = radix_tree_lookup(&cache->pages, index + i);
+
+            memcpy(buffer + done,
+                   (page ? page : new_page) + page_offset,
+                   count);
+
+            done += count;
+
+            page_offset = 0;
+            count = size - done < PAGE_SIZE ? size - done : PAGE_SIZE;
+        }
+
+        spinlock_unlock(&cache->lock);
+
+        for (uint32_t i = 0; i < run; ++i)
+        {
+            if (!kept[i])
+            {
+                phys_mem_free_block(pages + i * PAGE_SIZE);
+            }
+        }
+    }
+
+    return done;
+}
+
+uint32_t page_cache_prefetch(page_cache_t *cache,
+                             uint64_t offset,
+                             uint32_t size,
+                             page_cache_fill_t fill,
+                             void *arg)
+{
+    if (!size)
+    {
+        return 0;
+    }
+
+    uint64_t index = offset / PAGE_SIZE;
+    uint64_t last = (offset + size - 1) / PAGE_SIZE;
+
+    uint32_t filled = 0;
+
+    while (index <= last &&
+           __atomic_load_n(&page_cache_total, __ATOMIC_RELAXED) <
+               PAGE_CACHE_MAX_PAGES)
+    {
+        spinlock_lock(&cache->lock);
+
+        while (index <= last && radix_tree_lookup(&cache->pages, index))
+        {
+            ++index;
+        }
+
+        if (index > last)
+        {
+            spinlock_unlock(&cache->lock);
+            break;
+        }
+
+        uint32_t run = page_cache_missing_run(cache, index, last);
+        uint64_t seq = cache->seq;
+
+        spinlock_unlock(&cache->lock);
+
+        uint8_t *pages = page_cache_fill_run(index, &run, fill, arg);
+
+        if (!pages)
+        {
+            break;
+        }
+
+        spinlock_lock(&cache->lock);
+
+        for (uint32_t i = 0; i < run; ++i)
+        {
+            if (page_cache_insert(
+                    cache, index + i, pages + i * PAGE_SIZE, seq))
+            {
+                ++filled;
+            }
+            else
+            {
+                phys_mem_free_block(pages + i * PAGE_SIZE);
+            }
+        }
+
+        spinlock_unlock(&cache->lock);
+
+        index += run;
+    }
+
+    __atomic_add_fetch(&page_cache_stats.prefetched, filled, __ATOMIC_RELAXED);
+
+    return filled;
+}
+
+void page_cache_write(page_cache_t *cache,
+                      uint64_t offset,
+                      uint32_t size,
+                      const uint8_t *buffer)
+{
+    uint32_t done = 0;
+
+    spinlock_lock(&cache->lock);
+
+    cache->seq++;
+
+    while (done < size && cache->count)
+    {
+        uint64_t index = (offset + done) / PAGE_SIZE;
+        uint32_t page_offset = (offset + done) % PAGE_SIZE;
+        uint32_t count = PAGE_SIZE - page_offset;
+
+        if (count > size - done)
+        {
+            count = size - done;
+        }
+
+        uint8_t *page = radix_tree_lookup(&cache->pages, index);
+
+        if (page)
+        {
+            memcpy(page + page_offset, buffer + done, count);
+        }
+
+        done += count;
+    }
+
+    spinlock_unlock(&cache->lock);
+}
+
+void page_cache_truncate(page_cache_t *cache, uint64_t size)
+{
+    uint64_t first = (size + PAGE_SIZE - 1) / PAGE_SIZE;
+
+    void *pages[PAGE_CACHE_GANG];
+    uint64_t indices[PAGE_CACHE_GANG];
+
+    spinlock_lock(&cache->lock);
+
+    cache->seq++;
+
+    size_t found;
+
+    while ((found = radix_tree_gang_lookup(
+                &cache->pages, first, pages, indices, PAGE_CACHE_GANG)) > 0)
+    {
+        for (size_t i = 0; i < found; ++i)
+        {
+            page_cache_drop(cache, indices[i]);
+        }
+    }
+
+    if (size % PAGE_SIZE)
+    {
+        uint8_t *page = radix_tree_lookup(&cache->pages, size / PAGE_SIZE);
+
+        if (page)
+        {
+            memset(page + size % PAGE_SIZE, 0, PAGE_SIZE - size % PAGE_SIZE);
+        }
+    }
+
+    spinlock_unlock(&cache->lock);
+}
+
+void page_cache_destroy(page_cache_t *cache)
+{
+    page_cache_truncate(cache, 0);
+
+    radix_tree_destroy(&cache->pages);
+}
+
+void page_cache_get_stats(page_cache_stats_t *stats)
+{
+    stats->hits = __atomic_load_n(&page_cache_stats.hits, __ATOMIC_RELAXED);
+    stats->misses = __atomic_load_n(&page_cache_stats.misses, __ATOMIC_RELAXED);
+    stats->prefetched =
+        __atomic_load_n(&page_cache_stats.prefetched, __ATOMIC_RELAXED);
+    stats->pages = __atomic_load_n(&page_cache_total, __ATOMIC_RELAXED);
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -0,0 +1,657 @@
+/**
+ * @file shm.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Shared memory objects
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <mm/shm.h>
+
+#include <logging/logging.h>
+#include <mm/phys_mem.h>
+#include <mm/virt_mem.h>
+#include <sync/spinlock.h>
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SHM_PAGES(size) (((size) + PAGE_SIZE - 1) / PAGE_SIZE)
+
+static shm_object_t *shm_objects = NULL;
+
+// Protects the object list, the object reference counts and the mapping
+// lists of the processes.
+static spinlock_t shm_lock = {0};
+
+//=============================================================================
+// Objects
+//=============================================================================
+
+static shm_object_t *shm_find(const char *name)
+{
+    for (shm_object_t *obj = shm_objects; obj; obj = obj->next)
+    {
+        if (strcmp(obj->name, name) == 0)
+        {
+            return obj;
+        }
+    }
+
+    return NULL;
+}
+
+static shm_object_t *shm_create(const char *name, uint32_t permissions)
+{
+    shm_object_t *obj = malloc(sizeof(shm_object_t));
+
+    if (!obj)
+    {
+        return NULL;
+    }
+
+    memset(obj, 0, sizeof(shm_object_t));
+
+    strcpy(obj->name, name);
+    obj->permissions = permissions;
+
+    return obj;
+}
+
+static void shm_destroy(shm_object_t *obj)
+{
+    for (size_t i = 0; i < obj->n_frames; ++i)
+    {
+        phys_mem_free_block(obj->frames[i]);
+    }
+
+    free(obj->frames);
+    free(obj);
+}
+
+static void shm_put(shm_object_t *obj)
+{
+    obj->refs--;
+
+    // A named object lives on without references until it is unlinked
+    if (obj->refs == 0 && obj->unlinked)
+    {
+        shm_destroy(obj);
+    }
+}
+
+static int shm_resize(shm_object_t *obj, uint64_t size)
+{
+    size_t n_frames = SHM_PAGES(size);
+
+    if (n_frames < obj->n_frames && obj->maps)
+    {
+        return -EBUSY;
+    }
+
+    if (n_frames > obj->n_frames)
+    {
+        void **frames = realloc(obj->frames, n_frames * sizeof(void *));
+
+        if (!frames)
+        {
+            return -ENOMEM;
+        }
+
+        obj->frames = frames;
+
+        for (size_t i = obj->n_frames; i < n_frames; ++i)
+        {
+            frames[i] = phys_mem_alloc_block_z();
+
+            if (!frames[i])
+            {
+                while (i-- > obj->n_frames)
+                {
+                    phys_mem_free_block(frames[i]);
+                }
+
+                return -ENOMEM;
+            }
+        }
+    }
+    else
+    {
+        for (size_t i = n_frames; i < obj->n_frames; ++i)
+        {
+            phys_mem_free_block(obj->frames[i]);
+        }
+    }
+
+    obj->n_frames = n_frames;
+    obj->size = size;
+
+    return 0;
+}
+
+static const char *shm_name(const char *name)
+{
+    if (!name)
+    {
+        return NULL;
+    }
+
+    if (*name == '/')
+    {
+        ++name;
+    }
+
+    if (*name == '\0' || strchr(name, '/'))
+    {
+        return NULL;
+    }
+
+    return name;
+}
+
+//=============================================================================
+// VFS operations
+//=============================================================================
+
+static void close_shm(fs_node_t *node)
+{
+    spinlock_lock(&shm_lock);
+    shm_put((shm_object_t *)node->device);
+    spinlock_unlock(&shm_lock);
+
+    free(node);
+}
+
+static fs_node_t *shm_create_node(shm_object_t *obj)
+{
+    fs_node_t *node = malloc(sizeof(fs_node_t));
+
+    if (!node)
+    {
+        return NULL;
+    }
+
+    memset(node, 0, sizeof(fs_node_t));
+
+    strcpy(node->name, obj->name);
+
+    node->device = obj;
+    node->flags = FS_FILE;
+    node->permissions = obj->permissions;
+    node->length = obj->size;
+    node->refcount = 1;
+    node->nlink = 1;
+
+    node->close = close_shm;
+
+    return node;
+}
+
+//=============================================================================
+// Mappings
+//=============================================================================
+
+static uintptr_t shm_find_range(shm_mapping_t *maps, size_t n_pages)
+{
+    uintptr_t addr = SHM_MAP_BASE;
+    uint64_t size = n_pages * PAGE_SIZE;
+
+    // The list is sorted, so the first gap that fits is found in one pass
+    for (shm_mapping_t *map = maps; map; map = map->next)
+    {
+        if (map->addr - addr >= size)
+        {
+            break;
+        }
+
+        addr = map->addr + map->n_pages * PAGE_SIZE;
+    }
+
+    if (size > SHM_MAP_END - addr)
+    {
+        return 0;
+    }
+
+    return addr;
+}
+
+static void shm_insert_mapping(process_t *proc, shm_mapping_t *map)
+{
+    shm_mapping_t **link = (shm_mapping_t **)&proc->shm_mappings;
+
+    while (*link && (*link)->addr < map->addr)
+    {
+        link = &(*link)->next;
+    }
+
+    map->next = *link;
+    *link = map;
+}
+
+static void shm_unmap_pages(process_t *proc, uintptr_t addr, size_t n_pages)
+{
+    for (size_t i = 0; i < n_pages; ++i, addr += PAGE_SIZE)
+    {
+        virt_mem_unmap_page_p((void *)addr, proc->page_directory);
+    }
+}
+
+static void shm_drop_mapping(shm_mapping_t *map)
+{
+    map->object->maps--;
+    shm_put(map->object);
+
+    free(map);
+}
+
+//=============================================================================
+// Interface functions
+//=============================================================================
+
+int shm_open(const char *name, int oflag, int mode, fs_node_t **node)
+{
+    const char *obj_name = shm_name(name);
+
+    if (!obj_name)
+    {
+        return -EINVAL;
+    }
+
+    if (strlen(obj_name) >= SHM_NAME_MAX)
+    {
+        return -ENAMETOOLONG;
+    }
+
+    spinlock_lock(&shm_lock);
+
+    shm_object_t *obj = shm_find(obj_name);
+    int ret = 0;
+
+    if (obj && (oflag & O_CREAT) && (oflag & O_EXCL))
+    {
+        ret = -EEXIST;
+        goto out;
+    }
+
+    if (!obj)
+    {
+        if (!(oflag & O_CREAT))
+        {
+            ret = -ENOENT;
+            goto out;
+        }
+
+        obj = shm_create(obj_name, mode & 0777);
+
+        if (!obj)
+        {
+            ret = -ENOMEM;
+            goto out;
+        }
+
+        obj->next = shm_objects;
+        shm_objects = obj;
+    }
+
+    if (oflag & O_TRUNC)
+    {
+        ret = shm_resize(obj, 0);
+
+        if (ret < 0)
+        {
+            goto out;
+        }
+    }
+
+    *node = shm_create_node(obj);
+
+    if (!*node)
+    {
+        ret = -ENOMEM;
+        goto out;
+    }
+
+    obj->refs++;
+
+out:
+    spinlock_unlock(&shm_lock);
+
+    return ret;
+}
+
+int shm_unlink(const char *name)
+{
+    const char *obj_name = shm_name(name);
+
+    if (!obj_name)
+    {
+        return -EINVAL;
+    }
+
+    spinlock_lock(&shm_lock);
+
+    shm_object_t **link = &shm_objects;
+
+    while (*link && strcmp((*link)->name, obj_name) != 0)
+    {
+        link = &(*link)->next;
+    }
+
+    shm_object_t *obj = *link;
+
+    if (!obj)
+    {
+        spinlock_unlock(&shm_lock);
+        return -ENOENT;
+    }
+
+    *link = obj->next;
+    obj->unlinked = 1;
+
+    if (obj->refs == 0)
+    {
+        shm_destroy(obj);
+    }
+
+    spinlock_unlock(&shm_lock);
+
+    return 0;
+}
+
+int shm_is_shm(fs_node_t *node)
+{
+    return node && node->close == close_shm;
+}
+
+int shm_truncate(fs_node_t *node, uint64_t length)
+{
+    shm_object_t *obj = (shm_object_t *)node->device;
+
+    spinlock_lock(&shm_lock);
+
+    int ret = shm_resize(obj, length);
+
+    node->length = obj->size;
+
+    spinlock_unlock(&shm_lock);
+
+    return ret;
+}
+
+int shm_map(process_t *proc,
+            fs_node_t *node,
+            uintptr_t *addr,
+            uint64_t length,
+            uint64_t offset,
+            int prot)
+{
+    if (length == 0 || (offset & (PAGE_SIZE - 1)))
+    {
+        return -EINVAL;
+    }
+
+    size_t n_pages = SHM_PAGES(length);
+    size_t first_page = offset / PAGE_SIZE;
+
+    shm_mapping_t *map = malloc(sizeof(shm_mapping_t));
+
+    if (!map)
+    {
+        return -ENOMEM;
+    }
+
+    spinlock_lock(&shm_lock);
+
+    shm_object_t *obj = NULL;
+    int ret = 0;
+
+    if (node)
+    {
+        obj = (shm_object_t *)node->device;
+    }
+    else
+    {
+        obj = shm_create("[anon]", 0600);
+
+        if (!obj || shm_resize(obj, n_pages * PAGE_SIZE) < 0)
+        {
+            if (obj)
+            {
+                shm_destroy(obj);
+                obj = NULL;
+            }
+
+            ret = -ENOMEM;
+            goto fail;
+        }
+
+        obj->unlinked = 1;
+    }
+
+    // Pages past the end of the object have no frames to map
+    if (first_page + n_pages > obj->n_frames)
+    {
+        ret = -ENXIO;
+        goto fail;
+    }
+
+    uintptr_t start = shm_find_range(proc->shm_mappings, n_pages);
+
+    if (!start)
+    {
+        ret = -ENOMEM;
+        goto fail;
+    }
+
+    uint64_t flags = VIRT_MEM_USER | VIRT_MEM_SHARED;
+
+    if (prot & PROT_WRITE)
+    {
+        flags |= VIRT_MEM_WRITABLE;
+    }
+
+    for (size_t i = 0; i < n_pages; ++i)
+    {
+        void *virt = (void *)(start + i * PAGE_SIZE);
+
+        if (virt_mem_map_page_p(obj->frames[first_page + i],
+                                virt,
+                                flags,
+                                proc->page_directory))
+        {
+            shm_unmap_pages(proc, start, i);
+
+            ret = -ENOMEM;
+            goto fail;
+        }
+    }
+
+    map->addr = start;
+    map->n_pages = n_pages;
+    map->object = obj;
+    map->first_page = first_page;
+
+    shm_insert_mapping(proc, map);
+
+    obj->refs++;
+    obj->maps++;
+
+    spinlock_unlock(&shm_lock);
+
+    *addr = start;
+
+    return 0;
+
+fail:
+    // An anonymous object has no other references
+    if (!node && obj && obj->refs == 0)
+    {
+        shm_destroy(obj);
+    }
+
+    spinlock_unlock(&shm_lock);
+
+    free(map);
+
+    return ret;
+}
+
+int shm_unmap(process_t *proc, uintptr_t addr, uint64_t length)
+{
+    if (length == 0 || (addr & (PAGE_SIZE - 1)))
+    {
+        return -EINVAL;
+    }
+
+    uintptr_t end = addr + SHM_PAGES(length) * PAGE_SIZE;
+
+    spinlock_lock(&shm_lock);
+
+    shm_mapping_t **link = (shm_mapping_t **)&proc->shm_mappings;
+
+    while (*link)
+    {
+        shm_mapping_t *map = *link;
+
+        uintptr_t map_start = map->addr;
+        uintptr_t map_end = map->addr + map->n_pages * PAGE_SIZE;
+
+        if (map_start >= end)
+        {
+            break;
+        }
+
+        if (map_end <= addr)
+        {
+            link = &map->next;
+            continue;
+        }
+
+        uintptr_t from = map_start > addr ? map_start : addr;
+        uintptr_t to = map_end < end ? map_end : end;
+
+        if (from > map_start && to < map_end)
+        {
+            // A hole in the middle splits the mapping in two
+            shm_mapping_t *tail = malloc(sizeof(shm_mapping_t));
+
+            if (!tail)
+            {
+                spinlock_unlock(&shm_lock);
+                return -ENOMEM;
+            }
+
+            memcpy(tail, map, sizeof(shm_mapping_t));
+
+            tail->addr = to;
+            tail->first_page = map->first_page + (to - map_start) / PAGE_SIZE;
+            tail->n_pages = (map_end - to) / PAGE_SIZE;
+
+            map->n_pages = (from - map_start) / PAGE_SIZE;
+            map->next = tail;
+
+            map->object->refs++;
+            map->object->maps++;
+
+            shm_unmap_pages(proc, from, (to - from) / PAGE_SIZE);
+
+            break;
+        }
+
+        shm_unmap_pages(proc, from, (to - from) / PAGE_SIZE);
+
+        if (from == map_start && to == map_end)
+        {
+            *link = map->next;
+            shm_drop_mapping(map);
+            continue;
+        }
+
+        if (from == map_start)
+        {
+            map->first_page += (to - map_start) / PAGE_SIZE;
+            map->addr = to;
+        }
+
+        map->n_pages -= (to - from) / PAGE_SIZE;
+
+        link = &map->next;
+    }
+
+    spinlock_unlock(&shm_lock);
+
+    return 0;
+}
+
+int shm_fork(process_t *parent, process_t *child)
+{
+    spinlock_lock(&shm_lock);
+
+    shm_mapping_t **link = (shm_mapping_t **)&child->shm_mappings;
+
+    for (shm_mapping_t *map = parent->shm_mappings; map; map = map->next)
+    {
+        shm_mapping_t *copy = malloc(sizeof(shm_mapping_t));
+
+        if (!copy)
+        {
+            spinlock_unlock(&shm_lock);
+            return -ENOMEM;
+        }
+
+        memcpy(copy, map, sizeof(shm_mapping_t));
+        copy->next = NULL;
+
+        map->object->refs++;
+        map->object->maps++;
+
+        *link = copy;
+        link = &copy->next;
+    }
+
+    spinlock_unlock(&shm_lock);
+
+    return 0;
+}
+
+void shm_release(process_t *proc)
+{
+    spinlock_lock(&shm_lock);
+
+    shm_mapping_t *map = proc->shm_mappings;
+
+    while (map)
+    {
+        shm_mapping_t *next = map->next;
+
+        // The page tables outlive the process, so the frames must not be
+        // left reachable from them once the object is freed.
+        shm_unmap_pages(proc, map->addr, map->n_pages);
+        shm_drop_mapping(map);
+
+        map = next;
+    }
+
+    proc->shm_mappings = NULL;
+
+    spinlock_unlock(&shm_lock);
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
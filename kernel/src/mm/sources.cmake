@@ -1,4 +1,6 @@
 kernel_source(kheap.c)
 kernel_source(mm_bitmap.c)
+kernel_source(page_cache.c)
 kernel_source(phys_mem.c)
+kernel_source(shm.c)
 kernel_source(virt_mem.c)
\ No newline at end of file
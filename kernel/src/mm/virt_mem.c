@@ -491,7 +491,7 @@ void *virt_mem_get_physical_addr(void *addr, pml4_t *dir)
     // PML4 table
     //=========================================================================
 
-    pml4_t *current_dir = dir == NULL ? dir : _cur_dir;
+    pml4_t *current_dir = dir != NULL ? dir : _cur_dir;
 
     if (!current_dir)
     {
@@ -538,7 +538,7 @@ void *virt_mem_get_physical_addr(void *addr, pml4_t *dir)
         return NULL;
     }
 
-    dir = ADD_PAGE_OFFSET(dir);
+    pdir = ADD_PAGE_OFFSET(pdir);
 
     pd_entry_t entry_pd = pdir->entries[PD_INDEX(vaddr)];
 
@@ -1010,7 +1010,7 @@ int virt_mem_map_page_p(void *phys, void *virt, uint64_t flags, pml4_t *pml4)
 
         if (flags & VIRT_MEM_WRITABLE)
         {
-            pd_entry_add_attrib(pd_entry, PDE_USER);
+            pd_entry_add_attrib(pd_entry, PDE_WRITABLE);
         }
 
         if (flags & VIRT_MEM_USER)
@@ -1065,6 +1065,11 @@ int virt_mem_map_page_p(void *phys, void *virt, uint64_t flags, pml4_t *pml4)
         pt_entry_add_attrib(pt_entry, PTE_USER);
     }
 
+    if (flags & VIRT_MEM_SHARED)
+    {
+        pt_entry_add_attrib(pt_entry, PTE_SHARED);
+    }
+
     pt_entry_set_frame(pt_entry, (phys_addr)phys);
     return 0;
 }
@@ -1101,23 +1106,79 @@ int virt_mem_map_pages(void *phys, void *virt, size_t n_pages, uint64_t flags)
     return virt_mem_map_pages_p(phys, virt, n_pages, flags, _cur_dir);
 }
 
-int virt_mem_unmap_page(void *virt)
+int virt_mem_unmap_page_p(void *virt, pml4_t *dir)
 {
-    (void)virt;
+    virt_addr vaddr = (virt_addr)virt;
+
+    pml4_t *pml4 = ADD_PAGE_OFFSET(dir);
+
+    pml4_entry_t pml4_entry = pml4->entries[PML4_INDEX(vaddr)];
+
+    if (!pml4_entry_is_present(pml4_entry))
+    {
+        return -1;
+    }
+
+    pdp_t *pdp = ADD_PAGE_OFFSET((pdp_t *)pml4_entry_pfn(pml4_entry));
+
+    pdp_entry_t pdp_entry = pdp->entries[PDP_INDEX(vaddr)];
+
+    if (!pdp_entry_is_present(pdp_entry) || pdp_entry_is_huge(pdp_entry))
+    {
+        return -1;
+    }
+
+    pdirectory_t *pdir =
+        ADD_PAGE_OFFSET((pdirectory_t *)pdp_entry_pfn(pdp_entry));
+
+    pd_entry_t pd_entry = pdir->entries[PD_INDEX(vaddr)];
+
+    if (!pd_entry_is_present(pd_entry) || pd_entry_is_huge(pd_entry))
+    {
+        return -1;
+    }
 
-    // TODO:
+    ptable_t *ptable = ADD_PAGE_OFFSET((ptable_t *)pd_entry_pfn(pd_entry));
 
-    return -1;
+    pt_entry_t *pt_entry = &ptable->entries[PT_INDEX(vaddr)];
+
+    if (!pt_entry_is_present(*pt_entry))
+    {
+        return -1;
+    }
+
+    // The frame belongs to the caller, only the mapping is removed. Empty
+    // tables are kept for later mappings.
+    *pt_entry = 0;
+
+    if (dir == _cur_dir)
+    {
+        virt_mem_flush_tlb(vaddr);
+    }
+
+    return 0;
+}
+
+int virt_mem_unmap_page(void *virt)
+{
+    return virt_mem_unmap_page_p(virt, _cur_dir);
 }
 
 int virt_mem_unmap_pages(void *virt, size_t n_pages)
 {
-    (void)virt;
-    (void)n_pages;
+    uint64_t vaddr = (uint64_t)virt;
 
-    // TODO:
+    int ret = 0;
+
+    for (size_t i = 0; i < n_pages; ++i, vaddr += PAGE_SIZE)
+    {
+        if (virt_mem_unmap_page((void *)vaddr))
+        {
+            ret = -1;
+        }
+    }
 
-    return -1;
+    return ret;
 }
 
 static void copy_page(void *dst, const void *src)
@@ -1139,7 +1200,8 @@ static ptable_t *clone_ptable(ptable_t *src)
             continue;
         }
 
-        if (!pt_entry_is_user(src->entries[i]))
+        if (!pt_entry_is_user(src->entries[i]) ||
+            (src->entries[i] & PTE_SHARED))
         {
             // TODO: Lookup. This will copy accessed and dirty flag. This may
             // not be desireable.
@@ -1170,7 +1232,7 @@ static ptable_t *clone_ptable(ptable_t *src)
     return table;
 }
 
-static pdirectory_t *clone_pdirectory(pdirectory_t *src)
+static pdirectory_t *clone_pdirectory(pdirectory_t *src, int copy_user)
 {
     pdirectory_t *dir = virt_mem_alloc_pdirectory();
 
@@ -1192,6 +1254,12 @@ static pdirectory_t *clone_pdirectory(pdirectory_t *src)
         }
         else
         {
+            // Page tables marked as user only map user pages
+            if (!copy_user)
+            {
+                continue;
+            }
+
             ptable_t *src_table = (ptable_t *)pd_entry_pfn(src->entries[i]);
             ptable_t *new_table = clone_ptable(src_table);
 
@@ -1206,7 +1274,7 @@ static pdirectory_t *clone_pdirectory(pdirectory_t *src)
     return dir;
 }
 
-static pdp_t *clone_pdp(pdp_t *src)
+static pdp_t *clone_pdp(pdp_t *src, int copy_user)
 {
     pdp_t *dir = virt_mem_alloc_pdp();
 
@@ -1230,7 +1298,7 @@ static pdp_t *clone_pdp(pdp_t *src)
         {
             pdirectory_t *src_table =
                 (pdirectory_t *)pdp_entry_pfn(src->entries[i]);
-            pdirectory_t *new_table = clone_pdirectory(src_table);
+            pdirectory_t *new_table = clone_pdirectory(src_table, copy_user);
 
             pdp_entry_set_frame(&dir->entries[i], (phys_addr)new_table);
 
@@ -1243,7 +1311,7 @@ static pdp_t *clone_pdp(pdp_t *src)
     return dir;
 }
 
-static pml4_t *clone_pml4(pml4_t *src)
+static pml4_t *clone_pml4(pml4_t *src, int copy_user)
 {
     pml4_t *dir = virt_mem_alloc_pml4();
 
@@ -1265,7 +1333,7 @@ static pml4_t *clone_pml4(pml4_t *src)
         else
         {
             pdp_t *src_table = (pdp_t *)pml4_entry_pfn(src->entries[i]);
-            pdp_t *new_table = clone_pdp(src_table);
+            pdp_t *new_table = clone_pdp(src_table, copy_user);
 
             pml4_entry_set_frame(&dir->entries[i], (phys_addr)new_table);
 
@@ -1280,7 +1348,12 @@ static pml4_t *clone_pml4(pml4_t *src)
 
 pml4_t *virt_mem_clone_address_space(pml4_t *src)
 {
-    return clone_pml4(src);
+    return clone_pml4(src, 1);
+}
+
+pml4_t *virt_mem_clone_kernel_space(pml4_t *src)
+{
+    return clone_pml4(src, 0);
 }
 
 //==============================================================================
@@ -30,36 +30,21 @@
 
 int launch_program(char *path)
 {
-    pid_t pid;
     int status;
-    int retval;
 
-    // TODO: This needs to be fixed
-    static char *programPath;
-    programPath = path;
+    // The program is loaded straight into a fresh address space, so nothing
+    // of the caller has to be copied.
+    char *argv[] = {path, NULL};
 
-    pid = process_fork();
+    pid_t pid = process_spawn(path, argv, NULL, NULL, 0);
 
-    if (pid < 0)  // Error
+    if (pid < 0)
     {
-        log_error("[LAUNCH] Error: Could not fork");
+        log_error("[LAUNCH] Error: Could not spawn %s", path);
         return -1;  // TODO: This should probably be something else
     }
-    else if (pid == 0)  // Child
-    {
-        exec_elf(programPath, 0, NULL, NULL, 0);
-        log_error("[LAUNCH] Exec elf returned");
-
-        return -1;
-    }
-    else
-    {
-        int status;
-
-        retval = waitpid(pid, &status, 0);
-    }
 
-    return retval;
+    return waitpid(pid, &status, 0);
 }
 
 //=============================================================================
@@ -0,0 +1,246 @@
+/**
+ * @file pid.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Process ID allocation and lookup
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <process/pid.h>
+
+#include <arch/arch.h>
+#include <process/process.h>
+
+#include <stddef.h>
+
+//=============================================================================
+// Local definitions
+//=============================================================================
+
+// The free ID map has three levels. A set bit in the leaf level marks an ID
+// as used, a set bit in the middle level marks a leaf word as full and a set
+// bit in the top word marks a middle level word as full. Allocation is three
+// find-first-zero operations regardless of the number of IDs in use.
+#define PID_LEAF_WORDS ((PID_MAX + 63) / 64)
+#define PID_MID_WORDS ((PID_LEAF_WORDS + 63) / 64)
+
+_Static_assert(PID_MID_WORDS <= 64, "PID_MAX too large for PID bitmap");
+_Static_assert((PID_HASH_SIZE & (PID_HASH_SIZE - 1)) == 0,
+               "PID_HASH_SIZE must be a power of two");
+
+//=============================================================================
+// Local data
+//=============================================================================
+
+static uint64_t pid_leaf[PID_LEAF_WORDS];
+static uint64_t pid_mid[PID_MID_WORDS];
+static uint64_t pid_top;
+
+static process_t *pid_hash[PID_HASH_SIZE];
+
+//=============================================================================
+// Bitmap
+//=============================================================================
+
+static void pid_mark_used(pid_t pid)
+{
+    size_t leaf = pid / 64;
+    size_t mid = leaf / 64;
+
+    pid_leaf[leaf] |= 1ULL << (pid % 64);
+
+    if (pid_leaf[leaf] != ~0ULL)
+    {
+        return;
+    }
+
+    pid_mid[mid] |= 1ULL << (leaf % 64);
+
+    if (pid_mid[mid] != ~0ULL)
+    {
+        return;
+    }
+
+    pid_top |= 1ULL << mid;
+}
+
+void pid_init()
+{
+    for (size_t i = 0; i < PID_LEAF_WORDS; ++i)
+    {
+        pid_leaf[i] = 0;
+    }
+
+    for (size_t i = 0; i < PID_MID_WORDS; ++i)
+    {
+        pid_mid[i] = 0;
+    }
+
+    pid_top = 0;
+
+    // Mark the bits past the end of each level as used, so that the search
+    // never has to check the bounds.
+    for (size_t pid = PID_MAX; pid < PID_LEAF_WORDS * 64; ++pid)
+    {
+        pid_mark_used(pid);
+    }
+
+    for (size_t leaf = PID_LEAF_WORDS; leaf < PID_MID_WORDS * 64; ++leaf)
+    {
+        pid_mid[leaf / 64] |= 1ULL << (leaf % 64);
+    }
+
+    for (size_t mid = 0; mid < 64; ++mid)
+    {
+        if (mid >= PID_MID_WORDS || pid_mid[mid] == ~0ULL)
+        {
+            pid_top |= 1ULL << mid;
+        }
+    }
+
+    // 0 is never used and 1 is reserved for init
+    pid_mark_used(0);
+    pid_mark_used(1);
+
+    for (size_t i = 0; i < PID_HASH_SIZE; ++i)
+    {
+        pid_hash[i] = NULL;
+    }
+}
+
+pid_t pid_alloc()
+{
+    pid_t pid = -1;
+
+    uint64_t flags = irq_save();
+
+    if (pid_top != ~0ULL)
+    {
+        size_t mid = __builtin_ctzll(~pid_top);
+        size_t leaf = mid * 64 + __builtin_ctzll(~pid_mid[mid]);
+
+        pid = leaf * 64 + __builtin_ctzll(~pid_leaf[leaf]);
+
+        pid_mark_used(pid);
+    }
+
+    irq_restore(flags);
+
+    return pid;
+}
+
+void pid_free(pid_t pid)
+{
+    if (pid <= 1 || pid >= PID_MAX)
+    {
+        return;
+    }
+
+    size_t leaf = pid / 64;
+    size_t mid = leaf / 64;
+
+    uint64_t flags = irq_save();
+
+    pid_leaf[leaf] &= ~(1ULL << (pid % 64));
+    pid_mid[mid] &= ~(1ULL << (leaf % 64));
+    pid_top &= ~(1ULL << mid);
+
+    irq_restore(flags);
+}
+
+//=============================================================================
+// Hash table
+//=============================================================================
+
+// IDs are handed out densely from the bottom, so the low bits spread them
+// evenly over the buckets.
+static inline size_t pid_hash_index(pid_t pid)
+{
+    return (size_t)pid & (PID_HASH_SIZE - 1);
+}
+
+void pid_hash_insert(process_t *proc)
+{
+    if (proc->id < 0)
+    {
+        return;
+    }
+
+    size_t index = pid_hash_index(proc->id);
+
+    uint64_t flags = irq_save();
+
+    proc->pid_next = pid_hash[index];
+    pid_hash[index] = proc;
+
+    irq_restore(flags);
+}
+
+void pid_hash_remove(process_t *proc)
+{
+    if (proc->id < 0)
+    {
+        return;
+    }
+
+    size_t index = pid_hash_index(proc->id);
+
+    uint64_t flags = irq_save();
+
+    for (process_t **link = &pid_hash[index]; *link != NULL;
+         link = &(*link)->pid_next)
+    {
+        if (*link == proc)
+        {
+            *link = proc->pid_next;
+            break;
+        }
+    }
+
+    proc->pid_next = NULL;
+
+    irq_restore(flags);
+}
+
+process_t *pid_hash_lookup(pid_t pid)
+{
+    if (pid < 0)
+    {
+        return NULL;
+    }
+
+    process_t *proc;
+
+    uint64_t flags = irq_save();
+
+    for (proc = pid_hash[pid_hash_index(pid)]; proc != NULL;
+         proc = proc->pid_next)
+    {
+        if (proc->id == pid)
+        {
+            break;
+        }
+    }
+
+    irq_restore(flags);
+
+    return proc;
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -22,12 +22,17 @@
 
 #include <arch/arch.h>
 #include <arch/x86-64/fpu.h>
+#include <arch/x86-64/syscall.h>
 #include <debug/backtrace.h>
 #include <exec/elf64.h>
 #include <logging/logging.h>
+#include <mm/shm.h>
 #include <process/process.h>
+#include <process/sched_trace.h>
+#include <process/vdso.h>
+#include <process/workqueue.h>
 #include <sync/spinlock.h>
-#include <util/bitset.h>
+#include <syscall/io_ring.h>
 #include <util/hexdump.h>
 
 #include <assert.h>
@@ -47,6 +52,7 @@
 #endif
 
 #define KERNEL_STACK_SIZE 0x8000
+#define SYSCALL_STACK_SIZE 0x4000
 
 #define PUSH(stack, type, item) \
     stack -= sizeof(type);      \
@@ -72,7 +78,15 @@ static list_t *process_sleeping_list;
 volatile process_t *current_process = NULL;
 process_t *kernel_idle_task = NULL;
 
-static bitset_t pid_set;
+// Process whose FPU state is currently loaded in the FPU registers
+static process_t *fpu_owner = NULL;
+
+// Reason for the context switch in progress, see SCHED_TRACE_REASON
+static uint8_t switch_reason = SCHED_TRACE_YIELD;
+
+// Set by process_preempt to tell process_switch_task that the switch was
+// forced by the timer
+static uint8_t switch_preempted = 0;
 
 static spinlock_t tree_lock = {0};
 static spinlock_t process_queue_lock = {0};
@@ -86,6 +100,7 @@ process_t *spawn_idle_thread();
 process_t *spawn_init();
 void make_process_ready(process_t *proc);
 void wakeup_sleeping_processes();
+static void process_fpu_trap(system_stack_t *regs);
 
 //=============================================================================
 // Debug
@@ -160,20 +175,40 @@ void debug_print_process_tree()
     debug_print_process_tree_node(process_tree->root, 0);
 }
 
+void debug_print_sched_stats()
+{
+    printf("  PID         user       system         wait     max wait"
+           "   vol  invol name\n");
+
+    spinlock_lock(&tree_lock);
+
+    for (list_node_t *node = process_list->head; node != NULL;
+         node = node->next)
+    {
+        process_t *proc = (process_t *)node->payload;
+        sched_stats_t *stats = &proc->stats;
+
+        printf("%5d %12d %12d %12d %12d %5d %6d %s\n",
+               proc->id,
+               stats->user_time,
+               stats->system_time,
+               stats->wait_time,
+               stats->max_wait_time,
+               stats->voluntary_switches,
+               stats->involuntary_switches,
+               proc->name);
+    }
+
+    spinlock_unlock(&tree_lock);
+}
+
 //=============================================================================
 // PID
 //=============================================================================
 
 static int get_next_free_pid()
 {
-    int index = bitset_ffub(&pid_set);
-
-    if (index != -1)
-    {
-        bitset_set(&pid_set, index);
-    }
-
-    return index;
+    return pid_alloc();
 }
 
 //=============================================================================
@@ -187,9 +222,7 @@ void initialize_process_tree()
     process_ready_queue = list_create();
     process_sleeping_list = list_create();
 
-    bitset_init(&pid_set, MAX_PIDS);
-    bitset_set(&pid_set, 0);
-    bitset_set(&pid_set, 1);
+    pid_init();
 
     spinlock_init(&tree_lock);
     spinlock_init(&process_queue_lock);
@@ -204,13 +237,27 @@ void tasking_install()
 
     initialize_process_tree();
 
+    // Mapped before any address space is cloned, so that all share it
+    vdso_install();
+
     current_process = spawn_init();
     kernel_idle_task = spawn_idle_thread();
 
+    vdso_set_current(current_process->group, current_process->id);
+
     current_process->running = 1;
 
+    // The registers currently hold the state of the boot code, which from now
+    // on belongs to init.
+    fpu_owner = (process_t *)current_process;
+
+    // #NM, raised on the first FPU use after a task switch
+    set_exception_handler(7, process_fpu_trap);
+
     sti();
 
+    sched_trace_install();
+
     log_info("[PROC] Done!");
 }
 
@@ -237,6 +284,7 @@ process_t *spawn_idle_thread()
     process_t *idle = malloc(sizeof(process_t));
     memset(idle, 0x00, sizeof(process_t));
     idle->id = -1;
+    idle->group = -1;
     idle->name = strdup("[kernel idle thread]");
 
     // Setup the stack
@@ -247,15 +295,98 @@ process_t *spawn_idle_thread()
     idle->thread.rsp = &(stack[KERNEL_STACK_SIZE - 17]);
 
     idle->thread.rip = (uintptr_t)&kernel_idle;
+    idle->thread.fp_regs = arch_x64_64_alloc_fpu_state();
 
     idle->started = 1;
     idle->running = 1;
 
+    idle->stats.in_kernel = 1;
+    idle->stats.run_start = read_timestamp();
+
     idle->page_directory = virt_mem_get_current_dir();
 
     return idle;
 }
 
+//=============================================================================
+// File descriptor table
+//=============================================================================
+
+static fd_table_t *create_fd_table()
+{
+    fd_table_t *table = malloc(sizeof(fd_table_t));
+
+    table->refs = 1;
+    table->length = 0;
+    table->capacity = 4;
+    table->entries = malloc(sizeof(fs_node_t *) * table->capacity);
+    table->modes = malloc(sizeof(int) * table->capacity);
+    table->offsets = malloc(sizeof(uint64_t) * table->capacity);
+
+    memset(table->entries, 0, sizeof(fs_node_t *) * table->capacity);
+
+    return table;
+}
+
+static fd_table_t *copy_fd_table(fd_table_t *src)
+{
+    fd_table_t *table = malloc(sizeof(fd_table_t));
+
+    table->refs = 1;
+    table->length = src->length;
+    table->capacity = src->capacity;
+    table->entries = malloc(sizeof(fs_node_t *) * table->capacity);
+    table->modes = malloc(sizeof(int) * table->capacity);
+    table->offsets = malloc(sizeof(uint64_t) * table->capacity);
+
+    memset(table->entries, 0, sizeof(fs_node_t *) * table->capacity);
+
+    for (size_t i = 0; i < src->length; ++i)
+    {
+        table->entries[i] = clone_fs(src->entries[i]);
+        table->modes[i] = src->modes[i];
+        table->offsets[i] = src->offsets[i];
+    }
+
+    return table;
+}
+
+static void release_fd_table(fd_table_t *table)
+{
+    for (size_t i = 0; i < table->capacity; ++i)
+    {
+        if (table->entries[i])
+        {
+            close_fs(table->entries[i]);
+            table->entries[i] = NULL;
+        }
+    }
+
+    free(table->entries);
+    free(table->offsets);
+    free(table->modes);
+    free(table);
+}
+
+//=============================================================================
+// System call stack
+//=============================================================================
+
+static uint64_t *alloc_syscall_stack()
+{
+    return (uint64_t *)malloc(sizeof(uint64_t) * SYSCALL_STACK_SIZE);
+}
+
+static uintptr_t syscall_stack_top(process_t *proc)
+{
+    if (!proc->syscall_stack)
+    {
+        return 0;
+    }
+
+    return (uintptr_t)(proc->syscall_stack + SYSCALL_STACK_SIZE);
+}
+
 //=============================================================================
 // Spawn kernel idle process
 //=============================================================================
@@ -277,28 +408,26 @@ process_t *spawn_init()
 
     init->tree_entry = process_tree->root;
     init->id = 1;
+    init->group = 1;
     init->name = strdup("init");
     init->cmdline = NULL;
     init->argc = 0;
     init->status = 0;
 
-    init->file_descriptors = malloc(sizeof(fd_table_t));
+    pid_hash_insert(init);
+
+    // Init runs the kernel shell, so all of its time is system time
+    init->stats.in_kernel = 1;
+    init->stats.run_start = read_timestamp();
 
-    init->file_descriptors->refs = 1;
-    init->file_descriptors->length = 0;
-    init->file_descriptors->capacity = 4;
-    init->file_descriptors->entries =
-        malloc(sizeof(fs_node_t *) * init->file_descriptors->capacity);
-    init->file_descriptors->modes =
-        malloc(sizeof(int) * init->file_descriptors->capacity);
-    init->file_descriptors->offsets =
-        malloc(sizeof(uint64_t) * init->file_descriptors->capacity);
+    init->file_descriptors = create_fd_table();
 
     init->wd_node = clone_fs(fs_root);
     init->wd_path = strdup("/");
 
     init->thread.rip = 0;
     init->thread.rsp = 0;
+    init->thread.fp_regs = arch_x64_64_alloc_fpu_state();
 
     init->image.entry = 0;
     init->image.size = 0;
@@ -336,6 +465,7 @@ process_t *spawn_process(process_t *parent)
     memset(proc, 0, sizeof(process_t));
 
     proc->id = get_next_free_pid();
+    proc->group = proc->id;
 
     PRINT("Got pid: %d", proc->id);
 
@@ -345,9 +475,20 @@ process_t *spawn_process(process_t *parent)
     proc->cmdline = parent->cmdline;
     proc->argc = parent->argc;
 
-    // proc->thread.fpu_enabled = 0;
-    // memcpy((void *)proc->thread.fp_regs, (void *)parent->thread.fp_regs,
-    // 512);
+    proc->thread.fp_regs = arch_x64_64_alloc_fpu_state();
+
+    // The live registers are newer than the saved state if the parent owns
+    // the FPU
+    if (parent == fpu_owner)
+    {
+        arch_x64_64_fpu_clear_ts();
+        arch_x64_64_save_fpu(parent->thread.fp_regs);
+    }
+
+    proc->thread.fpu_enabled = parent->thread.fpu_enabled;
+    memcpy(proc->thread.fp_regs,
+           parent->thread.fp_regs,
+           arch_x64_64_fpu_state_size());
 
     uint64_t *stack = (uint64_t *)malloc(sizeof(uint64_t) * KERNEL_STACK_SIZE);
 
@@ -364,6 +505,7 @@ process_t *spawn_process(process_t *parent)
     // hexdump(stack, sizeof(uint64_t) * KERNEL_STACK_SIZE);
 
     proc->image.stack = (uint64_t)(stack);
+    proc->syscall_stack = alloc_syscall_stack();
 
     stack[KERNEL_STACK_SIZE - 1] = (uint64_t)parent->thread.rip;
     proc->thread.rsp = &(stack[KERNEL_STACK_SIZE - 17]);
@@ -377,26 +519,7 @@ process_t *spawn_process(process_t *parent)
 
     spinlock_init(&proc->image.lock);
 
-    proc->file_descriptors = malloc(sizeof(fd_table_t));
-    proc->file_descriptors->refs = 1;
-    proc->file_descriptors->length = parent->file_descriptors->length;
-    proc->file_descriptors->capacity = parent->file_descriptors->capacity;
-
-    proc->file_descriptors->entries =
-        malloc(sizeof(fs_node_t *) * proc->file_descriptors->capacity);
-    proc->file_descriptors->modes =
-        malloc(sizeof(int) * proc->file_descriptors->capacity);
-    proc->file_descriptors->offsets =
-        malloc(sizeof(uint64_t) * proc->file_descriptors->capacity);
-
-    for (uint32_t i = 0; i < parent->file_descriptors->length; ++i)
-    {
-        proc->file_descriptors->entries[i] =
-            clone_fs(parent->file_descriptors->entries[i]);
-        proc->file_descriptors->modes[i] = parent->file_descriptors->modes[i];
-        proc->file_descriptors->offsets[i] =
-            parent->file_descriptors->offsets[i];
-    }
+    proc->file_descriptors = copy_fd_table(parent->file_descriptors);
 
     proc->wd_node = clone_fs(parent->wd_node);
     proc->wd_path = strdup(parent->wd_path);
@@ -414,6 +537,7 @@ process_t *spawn_process(process_t *parent)
 
     spinlock_lock(&tree_lock);
     tree_node_insert_child_node(process_tree, parent->tree_entry, entry);
+    pid_hash_insert(proc);
     list_insert(process_list, (void *)proc);
     spinlock_unlock(&tree_lock);
 
@@ -422,6 +546,109 @@ process_t *spawn_process(process_t *parent)
     return proc;
 }
 
+//=============================================================================
+// Kernel threads
+//=============================================================================
+
+static void thread_entry(void *arg, kthread_func_t func)
+{
+    // We arrive here from switch_to, which might have been called with
+    // interrupts disabled.
+    sti();
+
+    process_exit(func(arg));
+}
+
+static void setup_thread_stack(thread_t *thread,
+                               uint64_t *stack_top,
+                               kthread_func_t func,
+                               void *arg)
+{
+    // Frame popped by switch_to: 16 registers followed by the return
+    // address. The slot above the return address acts as the return address
+    // of thread_entry and keeps the stack aligned as required by the ABI.
+    stack_top[-1] = 0;
+    stack_top[-2] = (uint64_t)&thread_entry;
+    stack_top[-8] = (uint64_t)func;  // rsi
+    stack_top[-9] = (uint64_t)arg;   // rdi
+
+    thread->rsp = &(stack_top[-18]);
+    thread->rip = (uintptr_t)&thread_entry;
+}
+
+process_t *kthread_create(const char *name, kthread_func_t func, void *arg)
+{
+    ASSERT(process_tree->root);
+
+    process_t *init = (process_t *)process_tree->root->value;
+
+    process_t *proc = (process_t *)malloc(sizeof(process_t));
+
+    if (!proc)
+    {
+        return NULL;
+    }
+
+    memset(proc, 0, sizeof(process_t));
+
+    uint64_t *stack = (uint64_t *)malloc(sizeof(uint64_t) * KERNEL_STACK_SIZE);
+
+    if (!stack)
+    {
+        free(proc);
+        return NULL;
+    }
+
+    memset(stack, 0, sizeof(uint64_t) * KERNEL_STACK_SIZE);
+
+    proc->id = get_next_free_pid();
+
+    if (proc->id == -1)
+    {
+        free(stack);
+        free(proc);
+        return NULL;
+    }
+
+    proc->group = proc->id;
+    proc->name = strdup(name);
+    proc->description = strdup("[kthread]");
+
+    proc->image.stack = (uint64_t)stack;
+    setup_thread_stack(&proc->thread, stack + KERNEL_STACK_SIZE, func, arg);
+    proc->thread.fp_regs = arch_x64_64_alloc_fpu_state();
+
+    proc->stats.in_kernel = 1;
+
+    spinlock_init(&proc->image.lock);
+
+    proc->file_descriptors = create_fd_table();
+
+    proc->wd_node = clone_fs(fs_root);
+    proc->wd_path = strdup("/");
+
+    // Kernel threads never touch user memory, so there is no need for an
+    // address space of their own.
+    proc->page_directory = init->page_directory;
+
+    tree_node_t *entry = tree_node_create(proc);
+
+    proc->tree_entry = entry;
+    proc->sched_node.payload = proc;
+
+    spinlock_lock(&tree_lock);
+    tree_node_insert_child_node(process_tree, init->tree_entry, entry);
+    pid_hash_insert(proc);
+    list_insert(process_list, (void *)proc);
+    spinlock_unlock(&tree_lock);
+
+    log_info("[PROC] Created kernel thread %d (%s)", proc->id, proc->name);
+
+    make_process_ready(proc);
+
+    return proc;
+}
+
 //=============================================================================
 // Fork
 //=============================================================================
@@ -443,48 +670,427 @@ pid_t process_fork()
     pml4_t *new_page_directory =
         virt_mem_clone_address_space(parent->page_directory);
 
-    parent->thread.rip = return_addr;
+    parent->thread.rip = return_addr;
+
+    process_t *new_proc = spawn_process(parent);
+
+    ASSERT(new_proc);
+
+    new_proc->page_directory = new_page_directory;
+
+    // The shared pages were mapped into the clone as they are, the child
+    // only needs its own references to them.
+    process_t *leader = process_from_pid(parent->group);
+
+    if (leader && shm_fork(leader, new_proc) < 0)
+    {
+        log_error("[PROC] Could not copy shared memory mappings");
+    }
+
+    volatile uintptr_t var = (uintptr_t)(get_rsp_val() + 8);
+    parent->thread.rsp = (uint64_t *)(get_rsp_val() + 8);
+    volatile uintptr_t diff =
+        parent->image.stack + sizeof(uint64_t) * KERNEL_STACK_SIZE - 1 - (var);
+
+    log_debug("Parent thread rsp: %#016x", parent->thread.rsp);
+    log_debug("Diff: %#016x", diff);
+
+    new_proc->thread.rsp =
+        (uint64_t *)(((uint64_t)new_proc->thread.rsp) - 8 * ((uint64_t)diff));
+
+    log_debug("New thread rsp: %#016x", new_proc->thread.rsp);
+
+    while (*(new_proc->thread.rsp) != return_addr)
+    {
+        new_proc->thread.rsp++;
+    }
+
+    new_proc->thread.rsp--;
+
+    setup_forked_kthread_stack(new_proc->thread.rsp);
+
+    new_proc->thread.rsp -= 15;
+
+    make_process_ready(new_proc);
+
+    sti();
+
+    return new_proc->id;
+}
+
+//=============================================================================
+// Clone
+//=============================================================================
+
+pid_t process_clone(uintptr_t new_stack, uintptr_t thread_func, uintptr_t arg)
+{
+    process_t *parent = (process_t *)current_process;
+
+    ASSERT(parent);
+
+    process_t *proc = (process_t *)malloc(sizeof(process_t));
+
+    if (!proc)
+    {
+        return -ENOMEM;
+    }
+
+    memset(proc, 0, sizeof(process_t));
+
+    uint64_t *stack_top;
+
+    if (new_stack)
+    {
+        stack_top = (uint64_t *)(new_stack & ~0xFUL);
+        proc->image.stack = 0;
+    }
+    else
+    {
+        uint64_t *stack =
+            (uint64_t *)malloc(sizeof(uint64_t) * KERNEL_STACK_SIZE);
+
+        if (!stack)
+        {
+            free(proc);
+            return -ENOMEM;
+        }
+
+        stack_top = stack + KERNEL_STACK_SIZE;
+        proc->image.stack = (uint64_t)stack;
+    }
+
+    proc->id = get_next_free_pid();
+
+    if (proc->id == -1)
+    {
+        free((void *)proc->image.stack);
+        free(proc);
+        return -EAGAIN;
+    }
+
+    proc->group = parent->group;
+    proc->syscall_stack = alloc_syscall_stack();
+
+    process_t *leader = process_from_pid(proc->group);
+
+    if (leader)
+    {
+        __atomic_add_fetch(&leader->threads, 1, __ATOMIC_SEQ_CST);
+    }
+
+    proc->name = strdup(parent->name);
+    proc->description = NULL;
+    proc->cmdline = parent->cmdline;
+    proc->argc = parent->argc;
+
+    setup_thread_stack(&proc->thread,
+                       stack_top,
+                       (kthread_func_t)thread_func,
+                       (void *)arg);
+    proc->thread.fp_regs = arch_x64_64_alloc_fpu_state();
+
+    proc->image.entry = parent->image.entry;
+    proc->image.size = parent->image.size;
+    proc->image.heap = parent->image.heap;
+    proc->image.heap_actual = parent->image.heap_actual;
+    proc->image.start = parent->image.start;
+
+    spinlock_init(&proc->image.lock);
+
+    // Threads share the file descriptor table and the address space
+    proc->file_descriptors = parent->file_descriptors;
+    proc->file_descriptors->refs++;
+
+    proc->page_directory = parent->page_directory;
+
+    proc->wd_node = clone_fs(parent->wd_node);
+    proc->wd_path = strdup(parent->wd_path);
+
+    tree_node_t *entry = tree_node_create(proc);
+
+    proc->tree_entry = entry;
+    proc->sched_node.payload = proc;
+
+    spinlock_lock(&tree_lock);
+    tree_node_insert_child_node(process_tree, parent->tree_entry, entry);
+    pid_hash_insert(proc);
+    list_insert(process_list, (void *)proc);
+    spinlock_unlock(&tree_lock);
+
+    PRINT("Created thread %d in group %d", proc->id, proc->group);
+
+    make_process_ready(proc);
+
+    return proc->id;
+}
+
+//=============================================================================
+// Spawn
+//=============================================================================
+
+typedef struct _spawn_image
+{
+    char *path;
+    int argc;
+    char **argv;
+    char **env;
+} spawn_image_t;
+
+static char **copy_string_array(char *const src[], int *count)
+{
+    int n = 0;
+
+    if (src)
+    {
+        while (src[n])
+        {
+            ++n;
+        }
+    }
+
+    char **dst = malloc(sizeof(char *) * (n + 1));
+
+    for (int i = 0; i < n; ++i)
+    {
+        dst[i] = strdup(src[i]);
+    }
+
+    dst[n] = NULL;
+
+    if (count)
+    {
+        *count = n;
+    }
+
+    return dst;
+}
+
+static void free_string_array(char **array)
+{
+    for (char **it = array; *it; ++it)
+    {
+        free(*it);
+    }
+
+    free(array);
+}
+
+static void free_spawn_image(spawn_image_t *image)
+{
+    free(image->path);
+    free_string_array(image->argv);
+    free_string_array(image->env);
+    free(image);
+}
+
+static int spawn_entry(void *arg)
+{
+    spawn_image_t *image = (spawn_image_t *)arg;
+
+    // We are already running in the new address space, so the program is
+    // loaded directly into it.
+    exec_elf(image->path, image->argc, image->argv, image->env, 0);
+
+    log_error("[PROC] Could not execute %s", image->path);
+
+    return -1;
+}
+
+static int spawn_apply_actions(process_t *proc,
+                               const spawn_file_action_t *actions,
+                               size_t action_count)
+{
+    fd_table_t *table = proc->file_descriptors;
+
+    for (size_t i = 0; i < action_count; ++i)
+    {
+        const spawn_file_action_t *action = &actions[i];
+
+        switch (action->type)
+        {
+        case SPAWN_FA_CLOSE:
+            if (action->fd < 0 || (size_t)action->fd >= table->length ||
+                !table->entries[action->fd])
+            {
+                return -EBADF;
+            }
+
+            close_fs(table->entries[action->fd]);
+            table->entries[action->fd] = NULL;
+            break;
+
+        case SPAWN_FA_DUP2:
+            if (action->fd < 0 || (size_t)action->fd >= table->length ||
+                !table->entries[action->fd] || action->newfd < 0 ||
+                (size_t)action->newfd > table->length)
+            {
+                return -EBADF;
+            }
+
+            if ((size_t)action->newfd == table->length)
+            {
+                process_append_fd(proc, NULL);
+            }
+
+            process_move_fd(proc, action->fd, action->newfd);
+            break;
+
+        case SPAWN_FA_CHDIR:
+        {
+            if (!action->path)
+            {
+                return -EINVAL;
+            }
+
+            char *path = canonicalize_path(proc->wd_path, (char *)action->path);
+            fs_node_t *dir = kopen(path, 0);
+
+            if (!dir)
+            {
+                free(path);
+                return -ENOENT;
+            }
+
+            if ((dir->flags & FS_DIRECTORY) == 0)
+            {
+                close_fs(dir);
+                free(path);
+                return -ENOTDIR;
+            }
+
+            close_fs(proc->wd_node);
+            free(proc->wd_path);
+
+            proc->wd_node = dir;
+            proc->wd_path = path;
+            break;
+        }
+
+        default:
+            return -EINVAL;
+        }
+    }
+
+    return 0;
+}
+
+pid_t process_spawn(const char *path,
+                    char *const argv[],
+                    char *const env[],
+                    const spawn_file_action_t *actions,
+                    size_t action_count)
+{
+    process_t *parent = (process_t *)current_process;
+
+    ASSERT(parent);
+
+    if (!path)
+    {
+        return -EINVAL;
+    }
+
+    // Fail in the caller rather than in the child if there is nothing to run
+    fs_node_t *file = kopen((char *)path, 0);
+
+    if (!file)
+    {
+        return -ENOENT;
+    }
+
+    close_fs(file);
+
+    process_t *proc = (process_t *)malloc(sizeof(process_t));
+
+    if (!proc)
+    {
+        return -ENOMEM;
+    }
+
+    memset(proc, 0, sizeof(process_t));
+
+    uint64_t *stack = (uint64_t *)malloc(sizeof(uint64_t) * KERNEL_STACK_SIZE);
+
+    if (!stack)
+    {
+        free(proc);
+        return -ENOMEM;
+    }
+
+    memset(stack, 0, sizeof(uint64_t) * KERNEL_STACK_SIZE);
 
-    process_t *new_proc = spawn_process(parent);
+    // Everything the child needs is copied to the kernel heap before the
+    // address space is created, so that it is mapped in the child as well.
+    spawn_image_t *image = malloc(sizeof(spawn_image_t));
 
-    ASSERT(new_proc);
+    image->path = strdup(path);
+    image->argv = copy_string_array(argv, &image->argc);
+    image->env = copy_string_array(env, NULL);
 
-    new_proc->page_directory = new_page_directory;
+    proc->spawn_image = image;
+    proc->image.stack = (uint64_t)stack;
+    proc->syscall_stack = alloc_syscall_stack();
 
-    volatile uintptr_t var = (uintptr_t)(get_rsp_val() + 8);
-    parent->thread.rsp = (uint64_t *)(get_rsp_val() + 8);
-    volatile uintptr_t diff =
-        parent->image.stack + sizeof(uint64_t) * KERNEL_STACK_SIZE - 1 - (var);
+    proc->file_descriptors = copy_fd_table(parent->file_descriptors);
+    proc->wd_node = clone_fs(parent->wd_node);
+    proc->wd_path = strdup(parent->wd_path);
 
-    log_debug("Parent thread rsp: %#016x", parent->thread.rsp);
-    log_debug("Diff: %#016x", diff);
+    int ret = spawn_apply_actions(proc, actions, action_count);
 
-    new_proc->thread.rsp =
-        (uint64_t *)(((uint64_t)new_proc->thread.rsp) - 8 * ((uint64_t)diff));
+    if (ret < 0)
+    {
+        goto error;
+    }
 
-    log_debug("New thread rsp: %#016x", new_proc->thread.rsp);
+    proc->id = get_next_free_pid();
 
-    while (*(new_proc->thread.rsp) != return_addr)
+    if (proc->id == -1)
     {
-        new_proc->thread.rsp++;
+        ret = -EAGAIN;
+        goto error;
     }
 
-    new_proc->thread.rsp--;
+    proc->page_directory = virt_mem_clone_kernel_space(parent->page_directory);
 
-    setup_forked_kthread_stack(new_proc->thread.rsp);
+    proc->group = proc->id;
+    proc->name = strdup(path);
+    proc->description = NULL;
+    proc->cmdline = image->argv;
+    proc->argc = image->argc;
 
-    new_proc->thread.rsp -= 15;
+    setup_thread_stack(
+        &proc->thread, stack + KERNEL_STACK_SIZE, spawn_entry, image);
+    proc->thread.fp_regs = arch_x64_64_alloc_fpu_state();
 
-    make_process_ready(new_proc);
+    spinlock_init(&proc->image.lock);
 
-    sti();
+    tree_node_t *entry = tree_node_create(proc);
 
-    return new_proc->id;
-}
+    proc->tree_entry = entry;
+    proc->sched_node.payload = proc;
 
-//=============================================================================
-// Clone
-//=============================================================================
+    spinlock_lock(&tree_lock);
+    tree_node_insert_child_node(process_tree, parent->tree_entry, entry);
+    pid_hash_insert(proc);
+    list_insert(process_list, (void *)proc);
+    spinlock_unlock(&tree_lock);
+
+    log_info("[PROC] Spawned %d (%s)", proc->id, proc->name);
+
+    make_process_ready(proc);
+
+    return proc->id;
+
+error:
+    free(proc->syscall_stack);
+    release_fd_table(proc->file_descriptors);
+    close_fs(proc->wd_node);
+    free(proc->wd_path);
+    free_spawn_image(image);
+    free(stack);
+    free(proc);
+
+    return ret;
+}
 
 //=============================================================================
 // Process cleanup
@@ -499,7 +1105,28 @@ void process_delete(process_t *proc)
         return;
     }
 
-    free((void *)proc->image.stack);
+    // Threads may run on a stack provided by the caller of clone
+    if (proc->image.stack)
+    {
+        free((void *)proc->image.stack);
+    }
+
+    if (fpu_owner == proc)
+    {
+        fpu_owner = NULL;
+    }
+
+    arch_x64_64_free_fpu_state(proc->thread.fp_regs);
+
+    if (proc->spawn_image)
+    {
+        free_spawn_image(proc->spawn_image);
+    }
+
+    if (proc->syscall_stack)
+    {
+        free(proc->syscall_stack);
+    }
 
     // Check if we are trying to kill init
     ASSERT((entry != process_tree->root));
@@ -520,7 +1147,8 @@ void process_delete(process_t *proc)
     spinlock_unlock(&tree_lock);
 
     // Release our PID
-    bitset_clear(&pid_set, proc->id);
+    pid_hash_remove(proc);
+    pid_free(proc->id);
 
     free(proc);
 }
@@ -530,25 +1158,39 @@ void process_cleanup(process_t *proc, int retval)
     proc->status = retval;
     proc->finished = 1;
 
+    // The ring worker holds a reference to the file descriptor table, so it
+    // must be stopped for the table to be released.
+    io_ring_release(proc);
+
+    // The shared memory of the group stays mapped until its last thread has
+    // exited. The leader is not reaped before that, see waitpid.
+    process_t *leader = process_from_pid(proc->group);
+    int last_thread = 0;
+
+    if (proc == leader)
+    {
+        last_thread =
+            __atomic_load_n(&leader->threads, __ATOMIC_SEQ_CST) == 0;
+    }
+    else if (leader)
+    {
+        last_thread =
+            __atomic_sub_fetch(&leader->threads, 1, __ATOMIC_SEQ_CST) == 0 &&
+            leader->finished;
+    }
+
+    if (last_thread)
+    {
+        shm_release(leader);
+    }
+
     proc->file_descriptors->refs--;
 
     if (proc->file_descriptors->refs == 0)
     {
         PRINT("Releasing FDS for process %i", process_get_pid());
 
-        for (size_t i = 0; i < proc->file_descriptors->capacity; ++i)
-        {
-            if (proc->file_descriptors->entries[i])
-            {
-                close_fs(proc->file_descriptors->entries[i]);
-                proc->file_descriptors->entries[i] = NULL;
-            }
-        }
-
-        free(proc->file_descriptors->entries);
-        free(proc->file_descriptors->offsets);
-        free(proc->file_descriptors->modes);
-        free(proc->file_descriptors);
+        release_fd_table(proc->file_descriptors);
     }
 }
 
@@ -564,6 +1206,23 @@ void process_reap(process_t *proc)
     process_delete(proc);
 }
 
+typedef struct
+{
+    work_t work;
+    process_t *proc;
+} detached_reap_t;
+
+static void reap_detached(void *arg)
+{
+    detached_reap_t *reap = (detached_reap_t *)arg;
+
+    log_debug("[PROC] Reaping detached thread %d", reap->proc->id);
+
+    process_reap(reap->proc);
+
+    free(reap);
+}
+
 void process_exit(int retval)
 {
     log_debug("Task %d exited with code: %d", current_process->id, retval);
@@ -575,7 +1234,29 @@ void process_exit(int retval)
         return;
     }
 
-    process_cleanup(process_get_current(), retval);
+    if (current_process->detached)
+    {
+        // The thread cannot free the stack it runs on, so it is reaped by the
+        // system work queue. Interrupts stay disabled until we have switched
+        // away, so that the reaper never sees a thread that may still run.
+        cli();
+
+        process_cleanup(process_get_current(), retval);
+
+        detached_reap_t *reap = malloc(sizeof(detached_reap_t));
+
+        if (reap)
+        {
+            work_init(&reap->work, reap_detached, reap);
+            reap->proc = process_get_current();
+
+            schedule_work(&reap->work);
+        }
+    }
+    else
+    {
+        process_cleanup(process_get_current(), retval);
+    }
 
     // Do not reschedule
     process_switch_task(0);
@@ -616,6 +1297,22 @@ process_t *next_ready_process()
     return next;
 }
 
+static void account_runtime(process_t *proc, uint64_t now)
+{
+    uint64_t delta = now - proc->stats.run_start;
+
+    if (proc->stats.in_kernel)
+    {
+        proc->stats.system_time += delta;
+    }
+    else
+    {
+        proc->stats.user_time += delta;
+    }
+
+    proc->stats.run_start = now;
+}
+
 void switch_next(uintptr_t return_addr)
 {
     current_process->thread.rip = return_addr;
@@ -627,8 +1324,6 @@ void switch_next(uintptr_t return_addr)
 
     current_process = next_ready_process();
 
-    arch_x64_64_restore_fpu((void *)current_process->thread.fp_regs);
-
     if (current_process->finished)
     {
         PRINT("Switched to finished process");
@@ -638,18 +1333,74 @@ void switch_next(uintptr_t return_addr)
     current_process->started = 1;
     current_process->running = 1;
 
+    uint64_t now = read_timestamp();
+
+    account_runtime(old_process, now);
+
+    sched_stats_t *stats = (sched_stats_t *)&current_process->stats;
+
+    if (stats->ready_start)
+    {
+        uint64_t wait = now - stats->ready_start;
+
+        stats->wait_time += wait;
+
+        if (wait > stats->max_wait_time)
+        {
+            stats->max_wait_time = wait;
+        }
+
+        stats->ready_start = 0;
+    }
+
+    stats->run_start = now;
+
+    if (old_process != current_process)
+    {
+        if (switch_reason == SCHED_TRACE_PREEMPT)
+        {
+            old_process->stats.involuntary_switches++;
+        }
+        else
+        {
+            old_process->stats.voluntary_switches++;
+        }
+
+        sched_trace_record(
+            old_process->id, current_process->id, switch_reason, now);
+    }
+
     PRINT("Old thread rip: %#016x", old_thread->rip);
     // LOOKUP_SYMBOL(old_thread->rip);
     // PRINT("");
 
     virt_mem_switch_dir(current_process->page_directory);
 
+    vdso_set_current(current_process->group, current_process->id);
+
+    // System calls made with SYSCALL run on the stack of the new process
+    arch_x86_64_set_syscall_stack(
+        syscall_stack_top((process_t *)current_process));
+
+    // The FPU state is switched lazily. Unless the next process already owns
+    // the FPU registers, its first FPU instruction traps to process_fpu_trap.
+    if (current_process == fpu_owner)
+    {
+        arch_x64_64_fpu_clear_ts();
+    }
+    else
+    {
+        arch_x64_64_fpu_set_ts();
+    }
+
     switch_to(&old_thread, (thread_t *)&current_process->thread);
 }
 
 void make_process_ready(process_t *proc)
 {
     PRINT("Make process ready");
+    proc->stats.ready_start = read_timestamp();
+
     spinlock_lock(&process_queue_lock);
     list_append(process_ready_queue, &proc->sched_node);
     spinlock_unlock(&process_queue_lock);
@@ -667,10 +1418,34 @@ void process_switch_task(uint8_t reschedule)
         return;
     }
 
+    uint8_t preempted = switch_preempted;
+    switch_preempted = 0;
+
     wakeup_sleeping_processes();
 
     debug_print_process((process_t *)current_process);
 
+    if (current_process->finished)
+    {
+        switch_reason = SCHED_TRACE_EXIT;
+    }
+    else if (current_process->blocked)
+    {
+        switch_reason = SCHED_TRACE_BLOCK;
+    }
+    else if (current_process->sleeping)
+    {
+        switch_reason = SCHED_TRACE_SLEEP;
+    }
+    else if (preempted)
+    {
+        switch_reason = SCHED_TRACE_PREEMPT;
+    }
+    else
+    {
+        switch_reason = SCHED_TRACE_YIELD;
+    }
+
     if (!current_process->running)
     {
         PRINT("Current process not running");
@@ -679,9 +1454,8 @@ void process_switch_task(uint8_t reschedule)
 
     current_process->running = 0;
 
-    arch_x64_64_save_fpu((void *)current_process->thread.fp_regs);
-
-    if (reschedule && current_process != kernel_idle_task)
+    if (reschedule && current_process != kernel_idle_task &&
+        !current_process->blocked)
     {
         make_process_ready((process_t *)current_process);
     }
@@ -694,45 +1468,112 @@ void process_yield(uint8_t reschedule)
     process_switch_task(reschedule);
 }
 
-//=============================================================================
-// Process queries
-//=============================================================================
-
-process_t *process_get_current()
+void process_preempt()
 {
-    return (process_t *)current_process;
+    switch_preempted = 1;
+
+    process_switch_task(1);
 }
 
-pid_t process_get_pid()
+void process_account_syscall_enter()
 {
-    return current_process->id;
+    process_t *proc = (process_t *)current_process;
+
+    if (!proc)
+    {
+        return;
+    }
+
+    account_runtime(proc, read_timestamp());
+
+    proc->stats.in_kernel++;
 }
 
-uint8_t process_compare(void *proc_v, void *pid_v)
+void process_account_syscall_exit()
 {
-    pid_t pid = (*(pid_t *)pid_v);
-    process_t *proc = (process_t *)proc_v;
+    process_t *proc = (process_t *)current_process;
+
+    if (!proc)
+    {
+        return;
+    }
 
-    return (uint8_t)(proc->id == pid);
+    account_runtime(proc, read_timestamp());
+
+    proc->stats.in_kernel--;
 }
 
-process_t *process_from_pid(pid_t pid)
+static void process_fpu_trap(system_stack_t *regs)
 {
-    if (pid < 0)
+    (void)regs;
+
+    arch_x64_64_fpu_clear_ts();
+
+    process_t *proc = (process_t *)current_process;
+
+    if (!proc || proc == fpu_owner)
     {
-        return NULL;
+        return;
     }
 
-    spinlock_lock(&tree_lock);
-    tree_node_t *entry = tree_find(process_tree, &pid, process_compare);
-    spinlock_unlock(&tree_lock);
+    if (fpu_owner)
+    {
+        arch_x64_64_save_fpu(fpu_owner->thread.fp_regs);
+    }
+
+    arch_x64_64_restore_fpu(proc->thread.fp_regs);
+
+    proc->thread.fpu_enabled = 1;
+
+    fpu_owner = proc;
+}
+
+void process_block()
+{
+    current_process->blocked = 1;
+
+    process_switch_task(0);
+}
 
-    if (entry)
+void process_wakeup(process_t *proc)
+{
+    // A process that has not yet been switched out after blocking is only
+    // marked runnable here, switch_task will then leave it in the ready queue.
+    if (proc->blocked)
     {
-        return (process_t *)entry->value;
+        proc->blocked = 0;
+
+        // Blocked with a timeout, the process is also in the sleep queue
+        if (proc->sleeping)
+        {
+            proc->sleeping = 0;
+
+            spinlock_lock(&process_sleeping_lock);
+            list_delete(process_sleeping_list, &proc->sched_node);
+            spinlock_unlock(&process_sleeping_lock);
+        }
+
+        make_process_ready(proc);
     }
+}
+
+//=============================================================================
+// Process queries
+//=============================================================================
+
+process_t *process_get_current()
+{
+    return (process_t *)current_process;
+}
+
+pid_t process_get_pid()
+{
+    return current_process->id;
+}
 
-    return NULL;
+process_t *process_from_pid(pid_t pid)
+{
+    return pid_hash_lookup(pid);
 }
 
 process_t *process_get_parent(process_t *process)
@@ -832,6 +1673,14 @@ size_t process_move_fd(process_t *proc, int src, int dest)
 // waitpid
 //=============================================================================
 
+// A thread group leader is only waited for once all of its threads have
+// exited, as they still use the resources kept on the leader.
+static int wait_finished(process_t *proc)
+{
+    return proc->finished &&
+           __atomic_load_n(&proc->threads, __ATOMIC_SEQ_CST) == 0;
+}
+
 static int wait_candidate(process_t *parent,
                           int pid,
                           int options,
@@ -844,6 +1693,12 @@ static int wait_candidate(process_t *parent,
         return 0;
     }
 
+    // Threads are only waited for when explicitly joined by their thread ID
+    if (proc->group != proc->id && pid <= 0)
+    {
+        return 0;
+    }
+
     if (pid < -1)
     {
         if (proc->id == -pid)
@@ -882,7 +1737,28 @@ int waitpid(int pid, int *status, int options)
         process_t *candidate = NULL;
         int has_children = 0;
 
-        for (list_node_t *node = proc->tree_entry->children->head; node != NULL;
+        if (pid > 0)
+        {
+            // A specific child can be found directly by its ID
+            process_t *child = process_from_pid(pid);
+
+            if (!child || !child->tree_entry ||
+                child->tree_entry->parent != proc->tree_entry)
+            {
+                log_debug("[WAITPID]: No Children matching");
+                return -ECHILD;
+            }
+
+            has_children = 1;
+
+            if (wait_finished(child))
+            {
+                candidate = child;
+            }
+        }
+
+        for (list_node_t *node = proc->tree_entry->children->head;
+             node != NULL && pid <= 0;
              node = node->next)
         {
             log_debug("[WAITPID]: Child tree node %#016x", node);
@@ -899,7 +1775,7 @@ int waitpid(int pid, int *status, int options)
             {
                 has_children = 1;
 
-                if (child->finished)
+                if (wait_finished(child))
                 {
                     candidate = child;
                     break;
@@ -971,11 +1847,34 @@ void process_sleep(uint64_t ms)
     process_switch_task(0);
 }
 
+void process_block_timeout(uint64_t ms)
+{
+    uint64_t ticks = ms * TIMER_FREQ / 1000;
+
+    // Sleep for at least one tick, a zero timeout never blocks
+    if (!ticks)
+    {
+        ticks = 1;
+    }
+
+    current_process->sleep_ticks = ticks + get_tick_count();
+    current_process->sleeping = 1;
+
+    spinlock_lock(&process_sleeping_lock);
+    list_append(process_sleeping_list,
+                (list_node_t *)&current_process->sched_node);
+    spinlock_unlock(&process_sleeping_lock);
+
+    // Whichever of process_wakeup and the timer comes first takes the
+    // process off the sleep queue.
+    process_block();
+}
+
 void wakeup_sleeping_processes()
 {
     // printf("Waking up sleeping processes");
 
-    cli();
+    uint64_t flags = irq_save();
 
     tick_count_t current_ticks = get_tick_count();
 
@@ -987,20 +1886,23 @@ void wakeup_sleeping_processes()
     while (next_node != NULL)
     {
         process_t *process = next_node->payload;
+        node = next_node;
+
+        // make_process_ready reuses the node, so advance before waking up
+        next_node = next_node->next;
 
         if (process->sleep_ticks < current_ticks)
         {
             process->sleeping = 0;
-            list_delete(process_sleeping_list, next_node);
+            process->blocked = 0;
+            list_delete(process_sleeping_list, node);
             make_process_ready(process);
         }
-
-        next_node = next_node->next;
     }
 
     spinlock_unlock(&process_sleeping_lock);
 
-    sti();
+    irq_restore(flags);
 }
 
 //=============================================================================
@@ -0,0 +1,231 @@
+/**
+ * @file sched_trace.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Context switch trace
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <process/sched_trace.h>
+
+#include <arch/arch.h>
+#include <logging/logging.h>
+#include <vfs/vfs.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//=============================================================================
+// Local data
+//=============================================================================
+
+// The kernel runs on a single CPU, so a single ring serves as the per-CPU
+// trace.
+static sched_trace_entry_t sched_trace[SCHED_TRACE_SIZE];
+static uint64_t sched_trace_count = 0;
+
+static const char *sched_trace_reasons[] = {
+    "preempt",
+    "yield",
+    "sleep",
+    "block",
+    "exit",
+};
+
+// Longest line produced by sched_trace_format_entry
+#define SCHED_TRACE_LINE_MAX 64
+
+//=============================================================================
+// Private functions
+//=============================================================================
+
+static size_t sched_trace_snapshot(sched_trace_entry_t *entries)
+{
+    uint64_t flags = irq_save();
+
+    uint64_t count = sched_trace_count;
+    size_t n = count < SCHED_TRACE_SIZE ? count : SCHED_TRACE_SIZE;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        entries[i] = sched_trace[(count - n + i) % SCHED_TRACE_SIZE];
+    }
+
+    irq_restore(flags);
+
+    return n;
+}
+
+static int sched_trace_format_entry(char *buf, sched_trace_entry_t *entry)
+{
+    const char *reason = "unknown";
+
+    if (entry->reason <
+        sizeof(sched_trace_reasons) / sizeof(sched_trace_reasons[0]))
+    {
+        reason = sched_trace_reasons[entry->reason];
+    }
+
+    return sprintf(buf,
+                   "%016x %5d -> %5d %s\n",
+                   entry->timestamp,
+                   entry->prev,
+                   entry->next,
+                   reason);
+}
+
+static uint32_t read_sched_trace(fs_node_t *node,
+                                 uint64_t offset,
+                                 uint32_t size,
+                                 uint8_t *buffer)
+{
+    (void)node;
+
+    sched_trace_entry_t *entries =
+        malloc(sizeof(sched_trace_entry_t) * SCHED_TRACE_SIZE);
+    char *text = malloc(SCHED_TRACE_LINE_MAX * SCHED_TRACE_SIZE);
+
+    if (!entries || !text)
+    {
+        free(entries);
+        free(text);
+        return 0;
+    }
+
+    size_t n = sched_trace_snapshot(entries);
+    size_t length = 0;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        length += sched_trace_format_entry(text + length, &entries[i]);
+    }
+
+    uint32_t copied = 0;
+
+    if (offset < length)
+    {
+        copied = length - offset < size ? length - offset : size;
+        memcpy(buffer, text + offset, copied);
+    }
+
+    free(entries);
+    free(text);
+
+    return copied;
+}
+
+static uint32_t write_sched_trace(fs_node_t *node,
+                                  uint64_t offset,
+                                  uint32_t size,
+                                  uint8_t *buffer)
+{
+    return 0;
+}
+
+static void open_sched_trace(fs_node_t *node, uint32_t flags)
+{
+    return;
+}
+
+static void close_sched_trace(fs_node_t *node)
+{
+    return;
+}
+
+//=============================================================================
+// Interface functions
+//=============================================================================
+
+void sched_trace_record(pid_t prev,
+                        pid_t next,
+                        uint8_t reason,
+                        uint64_t timestamp)
+{
+    sched_trace_entry_t *entry =
+        &sched_trace[sched_trace_count % SCHED_TRACE_SIZE];
+
+    entry->timestamp = timestamp;
+    entry->prev = prev;
+    entry->next = next;
+    entry->reason = reason;
+
+    ++sched_trace_count;
+}
+
+void sched_trace_dump()
+{
+    sched_trace_entry_t *entries =
+        malloc(sizeof(sched_trace_entry_t) * SCHED_TRACE_SIZE);
+
+    if (!entries)
+    {
+        return;
+    }
+
+    size_t n = sched_trace_snapshot(entries);
+
+    char line[SCHED_TRACE_LINE_MAX];
+
+    printf("%d of %d context switches:\n", (int)n, (int)sched_trace_count);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        sched_trace_format_entry(line, &entries[i]);
+        printf("%s", line);
+    }
+
+    free(entries);
+}
+
+void sched_trace_install()
+{
+    log_info("[SCHED] Installing schedtrace device");
+
+    fs_node_t *node = malloc(sizeof(fs_node_t));
+
+    if (!node)
+    {
+        return;
+    }
+
+    memset(node, 0, sizeof(fs_node_t));
+
+    node->inode = 0;
+    strcpy(node->name, "schedtrace");
+
+    node->uid = 0;
+    node->gid = 0;
+
+    node->permissions = 0444;
+    node->flags = FS_CHARDEVICE | FS_FILE;
+    node->read = read_sched_trace;
+    node->write = write_sched_trace;
+    node->open = open_sched_trace;
+    node->close = close_sched_trace;
+    node->readdir = NULL;
+    node->finddir = NULL;
+    node->ioctl = NULL;
+
+    vfs_mount("/dev/schedtrace", node);
+
+    log_info("[SCHED] Done!");
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -1,4 +1,8 @@
 kernel_source(launch_program.c)
+kernel_source(pid.c)
 kernel_source(process.c)
 kernel_source(read_ip.asm)
-kernel_source(switch_task.asm)
\ No newline at end of file
+kernel_source(sched_trace.c)
+kernel_source(switch_task.asm)
+kernel_source(vdso.c)
+kernel_source(workqueue.c)
\ No newline at end of file
@@ -0,0 +1,211 @@
+/**
+ * @file vdso.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Data page shared with programs
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <process/vdso.h>
+
+#include <arch/arch.h>
+#include <cmos/cmos_rtc.h>
+#include <logging/logging.h>
+#include <mm/phys_mem.h>
+#include <mm/virt_mem.h>
+
+#include <string.h>
+
+//=============================================================================
+// Local definitions
+//=============================================================================
+
+#define NSEC_PER_SEC 1000000000ULL
+#define NSEC_PER_TICK (NSEC_PER_SEC / TIMER_FREQ)
+
+// Number of timer ticks to measure the timestamp counter over
+#define TSC_CALIBRATION_TICKS TIMER_FREQ
+
+#define TSC_SHIFT 32
+
+#define barrier() __asm__ volatile("" ::: "memory")
+
+//=============================================================================
+// Local data
+//=============================================================================
+
+static vdso_data_t *vdso_data = NULL;
+
+static uint64_t calibration_tsc = 0;
+static tick_count_t calibration_ticks = 0;
+
+//=============================================================================
+// Private functions
+//=============================================================================
+
+static uint64_t vdso_cycles_to_ns(uint64_t cycles)
+{
+    return (uint64_t)(((unsigned __int128)cycles * vdso_data->tsc_mult) >>
+                      vdso_data->tsc_shift);
+}
+
+static void vdso_calibrate(uint64_t tsc)
+{
+    tick_count_t ticks = get_tick_count();
+
+    if (!calibration_tsc)
+    {
+        calibration_tsc = tsc;
+        calibration_ticks = ticks;
+        return;
+    }
+
+    if (ticks - calibration_ticks < TSC_CALIBRATION_TICKS)
+    {
+        return;
+    }
+
+    uint64_t elapsed_ns = (ticks - calibration_ticks) * NSEC_PER_TICK;
+    uint64_t cycles = tsc - calibration_tsc;
+
+    if (!cycles)
+    {
+        return;
+    }
+
+    vdso_data->tsc_mult =
+        (uint64_t)(((unsigned __int128)elapsed_ns << TSC_SHIFT) / cycles);
+    vdso_data->tsc_shift = TSC_SHIFT;
+    vdso_data->tsc_valid = 1;
+
+    log_info("[VDSO] TSC runs at %i kHz",
+             (int)(cycles * 1000000ULL / elapsed_ns));
+}
+
+static void vdso_tick()
+{
+    uint64_t tsc = read_timestamp();
+
+    vdso_data->seq++;
+    barrier();
+
+    if (vdso_data->tsc_valid)
+    {
+        vdso_data->mono_base_ns +=
+            vdso_cycles_to_ns(tsc - vdso_data->tsc_base);
+    }
+    else
+    {
+        vdso_data->mono_base_ns += NSEC_PER_TICK;
+
+        vdso_calibrate(tsc);
+    }
+
+    vdso_data->tsc_base = tsc;
+
+    barrier();
+    vdso_data->seq++;
+}
+
+//=============================================================================
+// Interface functions
+//=============================================================================
+
+void vdso_install()
+{
+    log_info("[VDSO] Installing data page");
+
+    void *page = phys_mem_alloc_block();
+
+    if (!page)
+    {
+        log_error("[VDSO] Could not allocate physical memory");
+        return;
+    }
+
+    // Programs run in ring 0, so a kernel mapping is readable by them. A
+    // user mapping would be copied, not shared, when a process forks.
+    virt_mem_map_page(page, (void *)VDSO_DATA_ADDR, VIRT_MEM_WRITABLE);
+
+    vdso_data = (vdso_data_t *)VDSO_DATA_ADDR;
+
+    memset(vdso_data, 0, PAGE_SIZE);
+
+    ktime_t time;
+    RTC_get_time(&time);
+
+    vdso_data->boot_time = RTC_time_to_int(&time);
+    vdso_data->tsc_base = read_timestamp();
+
+    set_on_tick_handler(vdso_tick);
+
+    log_info("[VDSO] Done!");
+}
+
+void vdso_set_current(pid_t pid, pid_t tid)
+{
+    if (!vdso_data)
+    {
+        return;
+    }
+
+    vdso_data->pid = pid;
+    vdso_data->tid = tid;
+}
+
+void vdso_get_time(int realtime, int64_t *sec, int64_t *nsec)
+{
+    uint32_t seq;
+    uint64_t ns;
+    int64_t boot_time;
+
+    if (!vdso_data)
+    {
+        *sec = 0;
+        *nsec = 0;
+        return;
+    }
+
+    do
+    {
+        seq = vdso_data->seq;
+        barrier();
+
+        ns = vdso_data->mono_base_ns;
+
+        if (vdso_data->tsc_valid)
+        {
+            ns += vdso_cycles_to_ns(read_timestamp() - vdso_data->tsc_base);
+        }
+
+        boot_time = vdso_data->boot_time;
+
+        barrier();
+    } while ((seq & 1) || seq != vdso_data->seq);
+
+    *sec = ns / NSEC_PER_SEC;
+    *nsec = ns % NSEC_PER_SEC;
+
+    if (realtime)
+    {
+        *sec += boot_time;
+    }
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
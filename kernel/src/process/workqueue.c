@@ -0,0 +1,156 @@
+/**
+ * @file workqueue.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Deferred work executed by kernel worker threads
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <process/workqueue.h>
+
+#include <arch/arch.h>
+#include <logging/logging.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+//=============================================================================
+// Local data
+//=============================================================================
+
+static workqueue_t *system_workqueue = NULL;
+
+//=============================================================================
+// Worker thread
+//=============================================================================
+
+static int workqueue_worker(void *arg)
+{
+    workqueue_t *queue = (workqueue_t *)arg;
+
+    while (1)
+    {
+        uint64_t flags = irq_save();
+
+        list_node_t *node;
+
+        while ((node = list_dequeue(&queue->items)) == NULL)
+        {
+            wait_queue_sleep(&queue->wait);
+        }
+
+        work_t *work = (work_t *)node->payload;
+
+        // Clear the pending flag before running the work, so that the item
+        // may be requeued while it is being processed.
+        work->pending = 0;
+
+        irq_restore(flags);
+
+        work->func(work->arg);
+    }
+
+    return 0;
+}
+
+//=============================================================================
+// Interface functions
+//=============================================================================
+
+void work_init(work_t *work, work_func_t func, void *arg)
+{
+    memset(work, 0, sizeof(work_t));
+
+    work->func = func;
+    work->arg = arg;
+    work->node.payload = work;
+}
+
+workqueue_t *workqueue_create(const char *name)
+{
+    workqueue_t *queue = malloc(sizeof(workqueue_t));
+
+    if (!queue)
+    {
+        return NULL;
+    }
+
+    memset(queue, 0, sizeof(workqueue_t));
+
+    queue->name = strdup(name);
+
+    wait_queue_init(&queue->wait);
+
+    queue->worker = kthread_create(name, workqueue_worker, queue);
+
+    if (!queue->worker)
+    {
+        log_error("[WORKQUEUE] Failed to create worker for %s", name);
+
+        free(queue->name);
+        free(queue);
+
+        return NULL;
+    }
+
+    return queue;
+}
+
+int workqueue_queue(workqueue_t *queue, work_t *work)
+{
+    uint64_t flags = irq_save();
+
+    if (work->pending)
+    {
+        irq_restore(flags);
+
+        return 0;
+    }
+
+    work->pending = 1;
+
+    list_append(&queue->items, &work->node);
+
+    wait_queue_wake_one(&queue->wait);
+
+    irq_restore(flags);
+
+    return 1;
+}
+
+int schedule_work(work_t *work)
+{
+    if (!system_workqueue)
+    {
+        work->func(work->arg);
+
+        return 1;
+    }
+
+    return workqueue_queue(system_workqueue, work);
+}
+
+void workqueue_install()
+{
+    log_info("[WORKQUEUE] Creating system work queue");
+
+    system_workqueue = workqueue_create("[kworker]");
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -0,0 +1,67 @@
+/**
+ * @file cachestat_command.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Command printing file system cache statistics
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <simple_cli/commands.h>
+
+#include <mm/page_cache.h>
+#include <vfs/dcache.h>
+#include <vfs/ext2.h>
+
+#include <stdio.h>
+
+int cachestat_command(int argc, const char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    dcache_stats_t dcache;
+    page_cache_stats_t pages;
+    ext2_readahead_stats_t readahead;
+
+    dcache_get_stats(&dcache);
+    page_cache_get_stats(&pages);
+    ext2_readahead_get_stats(&readahead);
+
+    printf("dcache:    %d entries, %d hits (%d negative), %d misses\n",
+           (int64_t)dcache.entries,
+           (int64_t)dcache.hits,
+           (int64_t)dcache.negative_hits,
+           (int64_t)dcache.misses);
+    printf("           %d evictions, %d invalidations\n",
+           (int64_t)dcache.evictions,
+           (int64_t)dcache.invalidations);
+    printf("pages:     %d cached, %d hits, %d misses, %d prefetched\n",
+           (int64_t)pages.pages,
+           (int64_t)pages.hits,
+           (int64_t)pages.misses,
+           (int64_t)pages.prefetched);
+    printf("readahead: %d sequential, %d random, %d windows\n",
+           (int64_t)readahead.sequential,
+           (int64_t)readahead.random,
+           (int64_t)readahead.windows);
+
+    return 0;
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
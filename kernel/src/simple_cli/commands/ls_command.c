@@ -87,56 +87,59 @@ int ls_command(int argc, const char **argv)
         return fd;
     }
 
-    int i = 0;
+    uint8_t buffer[1024];
+    int bytes;
 
-    struct dirent dirent;
-
-    while (syscall_readdir(fd, i, &dirent) == 1)
+    while ((bytes = syscall_getdents(fd, buffer, sizeof(buffer))) > 0)
     {
-        struct stat _stat;
+        for (int pos = 0; pos < bytes;)
+        {
+            struct vfs_dirent *dirent = (struct vfs_dirent *)(buffer + pos);
+            pos += dirent->d_reclen;
 
-        syscall_lstat(dirent.name, (uintptr_t)&_stat);
+            struct stat _stat;
 
-        char mode_char = '-';
+            syscall_lstat(dirent->d_name, (uintptr_t)&_stat);
 
-        if (S_ISDIR(_stat.st_mode))
-        {
-            mode_char = 'd';
-        }
+            char mode_char = '-';
 
-        if (S_ISCHR(_stat.st_mode))
-        {
-            mode_char = 'c';
-        }
+            if (S_ISDIR(_stat.st_mode))
+            {
+                mode_char = 'd';
+            }
 
-        if (S_ISBLK(_stat.st_mode))
-        {
-            mode_char = 'b';
-        }
+            if (S_ISCHR(_stat.st_mode))
+            {
+                mode_char = 'c';
+            }
 
-        if (S_ISFIFO(_stat.st_mode))
-        {
-            mode_char = 'p';
-        }
+            if (S_ISBLK(_stat.st_mode))
+            {
+                mode_char = 'b';
+            }
 
-        char permissons_string[10] = {0};
+            if (S_ISFIFO(_stat.st_mode))
+            {
+                mode_char = 'p';
+            }
 
-        ls_command_format_permissions(_stat.st_mode, permissons_string);
+            char permissons_string[10] = {0};
 
-        char size_string[32] = {0};
+            ls_command_format_permissions(_stat.st_mode, permissons_string);
 
-        ls_command_format_size(1, _stat.st_size, size_string);
+            char size_string[32] = {0};
 
-        printf("%c%s %i %s %s %s %s\n",
-               mode_char,
-               permissons_string,
-               _stat.st_nlink,
-               simple_cli_get_user_name(),
-               simple_cli_get_user_group(),
-               size_string,
-               dirent.name);
+            ls_command_format_size(1, _stat.st_size, size_string);
 
-        ++i;
+            printf("%c%s %i %s %s %s %s\n",
+                   mode_char,
+                   permissons_string,
+                   _stat.st_nlink,
+                   simple_cli_get_user_name(),
+                   simple_cli_get_user_group(),
+                   size_string,
+                   dirent->d_name);
+        }
     }
 
     syscall_close(fd);
@@ -0,0 +1,51 @@
+/**
+ * @file sched_command.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <process/process.h>
+#include <process/sched_trace.h>
+#include <simple_cli/commands.h>
+
+#include <stdio.h>
+#include <string.h>
+
+int sched_command(int argc, const char **argv)
+{
+    if (argc == 1 || strcmp(argv[1], "stats") == 0)
+    {
+        debug_print_sched_stats();
+    }
+    else if (strcmp(argv[1], "trace") == 0)
+    {
+        sched_trace_dump();
+    }
+    else
+    {
+        printf("Usage: sched [stats|trace]\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -1,3 +1,4 @@
+kernel_source(cachestat_command.c)
 kernel_source(cd_command.c)
 kernel_source(exit_command.c)
 kernel_source(launch_command.c)
@@ -5,5 +6,7 @@ kernel_source(ls_command.c)
 kernel_source(mkdir_command.c)
 kernel_source(pwd_command.c)
 kernel_source(rm_command.c)
+kernel_source(sched_command.c)
+kernel_source(syscalls_command.c)
 kernel_source(test_command.c)
 kernel_source(time_command.c)
\ No newline at end of file
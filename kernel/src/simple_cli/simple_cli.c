@@ -53,6 +53,9 @@ simple_cli_command_t _commands[] = {
     {.name = "exit", .command = exit_command},
     {.name = "time", .command = time_command},
     {.name = "launch", .command = launch_command},
+    {.name = "sched", .command = sched_command},
+    {.name = "syscalls", .command = syscalls_command},
+    {.name = "cachestat", .command = cachestat_command},
     {.name = NULL, .command = NULL}};
 
 //=============================================================================
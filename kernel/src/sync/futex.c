@@ -0,0 +1,216 @@
+/**
+ * @file futex.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Fast user-space locking primitive
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <sync/futex.h>
+
+#include <arch/arch.h>
+#include <mm/virt_mem.h>
+#include <process/process.h>
+#include <util/list.h>
+
+#include <errno.h>
+
+//=============================================================================
+// Local definitions
+//=============================================================================
+
+#define FUTEX_HASH_BITS 6
+#define FUTEX_HASH_SIZE (1 << FUTEX_HASH_BITS)
+
+typedef struct
+{
+    // Physical address of the futex word
+    uintptr_t key;
+
+    process_t *process;
+
+    list_node_t node;
+} futex_waiter_t;
+
+//=============================================================================
+// Local data
+//=============================================================================
+
+// The buckets are protected by disabling interrupts, which is sufficient as
+// long as we are running on a single CPU.
+static list_t futex_buckets[FUTEX_HASH_SIZE];
+
+//=============================================================================
+// Private functions
+//=============================================================================
+
+static uintptr_t futex_key(volatile uint32_t *uaddr)
+{
+    if (!uaddr || ((uintptr_t)uaddr & (sizeof(uint32_t) - 1)))
+    {
+        return 0;
+    }
+
+    return (uintptr_t)virt_mem_get_physical_addr_cur((void *)uaddr);
+}
+
+static list_t *futex_bucket(uintptr_t key)
+{
+    // Fibonacci hashing of the word index
+    uint64_t hash = (uint64_t)(key >> 2) * 0x9E3779B97F4A7C15ULL;
+
+    return &futex_buckets[hash >> (64 - FUTEX_HASH_BITS)];
+}
+
+static int futex_wake_key(uintptr_t key, int count)
+{
+    list_t *bucket = futex_bucket(key);
+
+    int woken = 0;
+
+    list_node_t *node = bucket->head;
+
+    while (node && woken < count)
+    {
+        list_node_t *next = node->next;
+
+        futex_waiter_t *waiter = (futex_waiter_t *)node->payload;
+
+        if (waiter->key == key)
+        {
+            list_delete(bucket, node);
+            waiter->key = 0;
+
+            process_wakeup(waiter->process);
+
+            ++woken;
+        }
+
+        node = next;
+    }
+
+    return woken;
+}
+
+//=============================================================================
+// Interface functions
+//=============================================================================
+
+int futex_wait(volatile uint32_t *uaddr, uint32_t val)
+{
+    uint64_t flags = irq_save();
+
+    uintptr_t key = futex_key(uaddr);
+
+    if (!key)
+    {
+        irq_restore(flags);
+        return -EFAULT;
+    }
+
+    // With interrupts disabled no one can change the word and wake us up
+    // between this check and the point where we are queued.
+    if (*uaddr != val)
+    {
+        irq_restore(flags);
+        return -EAGAIN;
+    }
+
+    futex_waiter_t waiter;
+
+    waiter.key = key;
+    waiter.process = process_get_current();
+    waiter.node.payload = &waiter;
+
+    list_append(futex_bucket(key), &waiter.node);
+
+    process_block();
+
+    irq_restore(flags);
+
+    return 0;
+}
+
+int futex_wake(volatile uint32_t *uaddr, int count)
+{
+    uint64_t flags = irq_save();
+
+    uintptr_t key = futex_key(uaddr);
+
+    if (!key)
+    {
+        irq_restore(flags);
+        return -EFAULT;
+    }
+
+    int woken = futex_wake_key(key, count);
+
+    irq_restore(flags);
+
+    return woken;
+}
+
+int futex_requeue(volatile uint32_t *uaddr,
+                  int wake_count,
+                  volatile uint32_t *uaddr2,
+                  int requeue_count)
+{
+    uint64_t flags = irq_save();
+
+    uintptr_t key = futex_key(uaddr);
+    uintptr_t key2 = futex_key(uaddr2);
+
+    if (!key || !key2)
+    {
+        irq_restore(flags);
+        return -EFAULT;
+    }
+
+    int woken = futex_wake_key(key, wake_count);
+    int requeued = 0;
+
+    list_t *bucket = futex_bucket(key);
+    list_t *bucket2 = futex_bucket(key2);
+
+    list_node_t *node = bucket->head;
+
+    while (node && requeued < requeue_count)
+    {
+        list_node_t *next = node->next;
+
+        futex_waiter_t *waiter = (futex_waiter_t *)node->payload;
+
+        if (waiter->key == key)
+        {
+            list_delete(bucket, node);
+            waiter->key = key2;
+            list_append(bucket2, node);
+
+            ++requeued;
+        }
+
+        node = next;
+    }
+
+    irq_restore(flags);
+
+    return woken + requeued;
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -1 +1,3 @@
-kernel_source(spinlock.c)
\ No newline at end of file
+kernel_source(futex.c)
+kernel_source(spinlock.c)
+kernel_source(wait_queue.c)
\ No newline at end of file
@@ -0,0 +1,119 @@
+/**
+ * @file wait_queue.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Queue of processes blocked on an event
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <sync/wait_queue.h>
+
+#include <arch/arch.h>
+#include <process/process.h>
+
+void wait_queue_init(wait_queue_t *queue)
+{
+    queue->waiters.head = NULL;
+    queue->waiters.tail = NULL;
+    queue->waiters.length = 0;
+}
+
+void wait_queue_sleep(wait_queue_t *queue)
+{
+    // Interrupts stay disabled until we have been switched out, so a waker
+    // running in interrupt context can not observe a half-queued process.
+    uint64_t flags = irq_save();
+
+    process_t *proc = process_get_current();
+
+    proc->wait_node.payload = proc;
+    list_append(&queue->waiters, &proc->wait_node);
+
+    process_block();
+
+    irq_restore(flags);
+}
+
+int wait_queue_sleep_timeout(wait_queue_t *queue, uint64_t ms)
+{
+    uint64_t flags = irq_save();
+
+    process_t *proc = process_get_current();
+
+    proc->wait_node.payload = proc;
+    list_append(&queue->waiters, &proc->wait_node);
+
+    process_block_timeout(ms);
+
+    // Wakers clear the payload of the nodes they dequeue, so a process still
+    // carrying one was woken by the timer and is still in the queue.
+    int woken = proc->wait_node.payload == NULL;
+
+    if (!woken)
+    {
+        list_delete(&queue->waiters, &proc->wait_node);
+    }
+
+    irq_restore(flags);
+
+    return woken;
+}
+
+int wait_queue_wake_one(wait_queue_t *queue)
+{
+    uint64_t flags = irq_save();
+
+    list_node_t *node = list_dequeue(&queue->waiters);
+
+    if (node)
+    {
+        process_t *proc = (process_t *)node->payload;
+
+        node->payload = NULL;
+        process_wakeup(proc);
+    }
+
+    irq_restore(flags);
+
+    return node != NULL;
+}
+
+int wait_queue_wake_all(wait_queue_t *queue)
+{
+    int count = 0;
+
+    uint64_t flags = irq_save();
+
+    list_node_t *node;
+
+    while ((node = list_dequeue(&queue->waiters)) != NULL)
+    {
+        process_t *proc = (process_t *)node->payload;
+
+        node->payload = NULL;
+        process_wakeup(proc);
+        ++count;
+    }
+
+    irq_restore(flags);
+
+    return count;
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
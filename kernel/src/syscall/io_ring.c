@@ -0,0 +1,340 @@
+/**
+ * @file io_ring.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Batched asynchronous system calls
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <syscall/io_ring.h>
+
+#include <arch/arch.h>
+#include <logging/logging.h>
+#include <process/process.h>
+#include <syscall/syscall.h>
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+//=============================================================================
+// Local functions
+//=============================================================================
+
+static io_ring_t *io_ring_get_current()
+{
+    // The rings belong to the thread group leader, so that all threads of a
+    // process share them.
+    process_t *leader = process_from_pid(process_get_current()->group);
+
+    if (!leader)
+    {
+        return NULL;
+    }
+
+    return (io_ring_t *)leader->io_ring;
+}
+
+static uint32_t io_ring_completions(io_ring_t *ring)
+{
+    return ring->cq->tail - ring->cq->head;
+}
+
+static int io_ring_has_work(io_ring_t *ring)
+{
+    // Submissions are left in the ring while there is no room for their
+    // completions. The next call to io_ring_enter wakes us up again.
+    return ring->sq->head != ring->sq->tail &&
+           io_ring_completions(ring) < ring->cq->entries;
+}
+
+static int32_t io_ring_execute(const io_ring_sqe_t *sqe)
+{
+    switch (sqe->opcode)
+    {
+    case IO_RING_OP_NOP:
+        return 0;
+
+    case IO_RING_OP_READ:
+        if (sqe->off == IO_RING_OFFSET_CURRENT)
+        {
+            return syscall_read(sqe->fd, (char *)sqe->addr, sqe->len);
+        }
+
+        return syscall_pread(
+            sqe->fd, (char *)sqe->addr, sqe->len, (int64_t)sqe->off);
+
+    case IO_RING_OP_WRITE:
+        if (sqe->off == IO_RING_OFFSET_CURRENT)
+        {
+            return syscall_write(sqe->fd, (char *)sqe->addr, sqe->len);
+        }
+
+        return syscall_pwrite(
+            sqe->fd, (char *)sqe->addr, sqe->len, (int64_t)sqe->off);
+
+    case IO_RING_OP_OPEN:
+        return syscall_open(
+            (const char *)sqe->addr, (int)sqe->open_flags, (int)sqe->len);
+
+    case IO_RING_OP_CLOSE:
+        return syscall_close(sqe->fd);
+
+    case IO_RING_OP_STAT:
+        if (sqe->addr)
+        {
+            return syscall_statf((char *)sqe->addr, (uintptr_t)sqe->addr2);
+        }
+
+        return syscall_stat(sqe->fd, (uintptr_t)sqe->addr2);
+
+    default:
+        return -EINVAL;
+    }
+}
+
+static void io_ring_process(io_ring_t *ring)
+{
+    while (!ring->stopping && io_ring_has_work(ring))
+    {
+        // Copy the entry, the process may reuse the slot as soon as head
+        // moves past it.
+        io_ring_sqe_t sqe = ring->sqes[ring->sq->head & ring->sq->mask];
+
+        __sync_synchronize();
+
+        ring->sq->head++;
+
+        int32_t res = io_ring_execute(&sqe);
+
+        io_ring_cqe_t *cqe = &ring->cqes[ring->cq->tail & ring->cq->mask];
+
+        cqe->user_data = sqe.user_data;
+        cqe->res = res;
+        cqe->flags = 0;
+
+        // The entry must be visible before the new tail
+        __sync_synchronize();
+
+        uint64_t flags = irq_save();
+
+        ring->cq->tail++;
+        wait_queue_wake_all(&ring->complete_wait);
+
+        irq_restore(flags);
+    }
+}
+
+static int io_ring_worker(void *arg)
+{
+    io_ring_t *ring = (io_ring_t *)arg;
+
+    while (1)
+    {
+        uint64_t flags = irq_save();
+
+        while (!ring->stopping && !io_ring_has_work(ring))
+        {
+            wait_queue_sleep(&ring->submit_wait);
+        }
+
+        irq_restore(flags);
+
+        if (ring->stopping)
+        {
+            break;
+        }
+
+        io_ring_process(ring);
+    }
+
+    // The owner is gone, nobody else refers to the rings anymore
+    free(ring->memory);
+    free(ring);
+
+    return 0;
+}
+
+static uint32_t round_up_pow2(uint32_t value)
+{
+    uint32_t result = 1;
+
+    while (result < value)
+    {
+        result <<= 1;
+    }
+
+    return result;
+}
+
+//=============================================================================
+// Interface functions
+//=============================================================================
+
+int io_ring_setup(uint32_t entries, io_ring_params_t *params)
+{
+    if (!params || entries == 0 || entries > IO_RING_MAX_ENTRIES)
+    {
+        return -EINVAL;
+    }
+
+    process_t *leader = process_from_pid(process_get_current()->group);
+
+    if (!leader)
+    {
+        return -EINVAL;
+    }
+
+    if (leader->io_ring)
+    {
+        return -EBUSY;
+    }
+
+    uint32_t sq_entries = round_up_pow2(entries);
+    uint32_t cq_entries = sq_entries * 2;
+
+    size_t sq_size =
+        sizeof(io_ring_header_t) + sq_entries * sizeof(io_ring_sqe_t);
+    size_t cq_size =
+        sizeof(io_ring_header_t) + cq_entries * sizeof(io_ring_cqe_t);
+
+    io_ring_t *ring = malloc(sizeof(io_ring_t));
+
+    if (!ring)
+    {
+        return -ENOMEM;
+    }
+
+    memset(ring, 0, sizeof(io_ring_t));
+
+    ring->memory = malloc(sq_size + cq_size);
+
+    if (!ring->memory)
+    {
+        free(ring);
+        return -ENOMEM;
+    }
+
+    memset(ring->memory, 0, sq_size + cq_size);
+
+    ring->sq = (io_ring_header_t *)ring->memory;
+    ring->sq->entries = sq_entries;
+    ring->sq->mask = sq_entries - 1;
+    ring->sqes = (io_ring_sqe_t *)(ring->sq + 1);
+
+    ring->cq = (io_ring_header_t *)((uintptr_t)ring->memory + sq_size);
+    ring->cq->entries = cq_entries;
+    ring->cq->mask = cq_entries - 1;
+    ring->cqes = (io_ring_cqe_t *)(ring->cq + 1);
+
+    wait_queue_init(&ring->submit_wait);
+    wait_queue_init(&ring->complete_wait);
+
+    // Programs run in the same privilege level as the kernel, so the rings
+    // are accessible to the process as they are.
+    leader->io_ring = ring;
+
+    int pid = process_clone(0, (uintptr_t)io_ring_worker, (uintptr_t)ring);
+
+    if (pid < 0)
+    {
+        leader->io_ring = NULL;
+
+        free(ring->memory);
+        free(ring);
+
+        return pid;
+    }
+
+    ring->worker = process_from_pid(pid);
+
+    // Nobody joins the worker, the kernel reaps it when the rings are
+    // released.
+    ring->worker->detached = 1;
+
+    params->sq_entries = sq_entries;
+    params->cq_entries = cq_entries;
+    params->sq_ring = (uint64_t)ring->sq;
+    params->cq_ring = (uint64_t)ring->cq;
+
+    log_info("[IO_RING] Process %d: %d entries, worker %d",
+             leader->id,
+             sq_entries,
+             pid);
+
+    return 0;
+}
+
+int io_ring_enter(uint32_t to_submit, uint32_t min_complete, uint32_t flags)
+{
+    io_ring_t *ring = io_ring_get_current();
+
+    if (!ring)
+    {
+        return -EINVAL;
+    }
+
+    if (min_complete > ring->cq->entries)
+    {
+        return -EINVAL;
+    }
+
+    uint64_t irq_flags = irq_save();
+
+    // Also wake the worker when it has stopped on a full completion ring
+    if (to_submit || ring->sq->head != ring->sq->tail)
+    {
+        wait_queue_wake_one(&ring->submit_wait);
+    }
+
+    if (flags & IO_RING_ENTER_GETEVENTS)
+    {
+        while (io_ring_completions(ring) < min_complete)
+        {
+            wait_queue_sleep(&ring->complete_wait);
+        }
+    }
+
+    int available = (int)io_ring_completions(ring);
+
+    irq_restore(irq_flags);
+
+    return available;
+}
+
+void io_ring_release(process_t *proc)
+{
+    io_ring_t *ring = (io_ring_t *)proc->io_ring;
+
+    if (!ring)
+    {
+        return;
+    }
+
+    proc->io_ring = NULL;
+
+    uint64_t flags = irq_save();
+
+    ring->stopping = 1;
+    wait_queue_wake_all(&ring->submit_wait);
+
+    irq_restore(flags);
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -1,4 +1,6 @@
 kernel_source(do_syscall.c)
+kernel_source(io_ring.c)
 kernel_source(syscall.c)
+kernel_source(syscall_trace.c)
 
 kernel_subdirectory(syscalls)
\ No newline at end of file
@@ -20,36 +20,93 @@
  *
  */
 
+#include <arch/x86-64/syscall.h>
 #include <logging/logging.h>
 #include <syscall/syscall.h>
+#include <syscall/syscall_trace.h>
 
 int syscall_fork();
-int syscall_clone();
 int syscall_kill(pid_t process, uint32_t signal);
 
 // int syscall_gettimeofday(struct timeval *tv, void *tz);
 
 typedef int (*syscall_func_t)(uint64_t, ...);
 
-syscall_func_t _syscalls[128] = {0};
+syscall_func_t _syscalls[SYSCALL_MAX] = {0};
 
 void syscall_handler(system_stack_t *stack)
 {
-    syscall_func_t syscall_func = _syscalls[stack->rax];
-
-    if (!syscall_func)
+    if (stack->rax >= SYSCALL_MAX || !_syscalls[stack->rax])
     {
         printf("[SYSCALL] Invalid system call: %i\n", stack->rax);
         return;
     }
 
+    syscall_func_t syscall_func = _syscalls[stack->rax];
+
     // TODO: Verify that the correct number of parameters are passed to the
     // functions.
-    int retval = syscall_func(stack->rbx, stack->rcx, stack->rdx);
+    process_account_syscall_enter();
+
+    uint64_t start = read_timestamp();
+
+    int retval = syscall_func(
+        stack->rbx, stack->rcx, stack->rdx, stack->rsi, stack->rdi);
+
+    uint64_t cycles = read_timestamp() - start;
+
+    process_account_syscall_exit();
+
+    syscall_stats_record(stack->rax, cycles);
+
+    if (__builtin_expect(syscall_trace_enabled, 0))
+    {
+        uint64_t args[6] = {
+            stack->rbx, stack->rcx, stack->rdx, stack->rsi, stack->rdi, 0};
+
+        syscall_trace_record(stack->rax, args, retval, start, cycles);
+    }
 
     stack->rax = retval;
 }
 
+static int64_t syscall_fast_handler(arch_x86_64_syscall_frame_t *frame)
+{
+    if (frame->rax >= SYSCALL_MAX || !_syscalls[frame->rax])
+    {
+        printf("[SYSCALL] Invalid system call: %i\n", frame->rax);
+        return -ENOSYS;
+    }
+
+    process_account_syscall_enter();
+
+    uint64_t start = read_timestamp();
+
+    int retval = _syscalls[frame->rax](
+        frame->rdi, frame->rsi, frame->rdx, frame->r10, frame->r8, frame->r9);
+
+    uint64_t cycles = read_timestamp() - start;
+
+    process_account_syscall_exit();
+
+    syscall_stats_record(frame->rax, cycles);
+
+    // With tracing off, this is all the tracer costs
+    if (__builtin_expect(syscall_trace_enabled, 0))
+    {
+        uint64_t args[6] = {frame->rdi,
+                            frame->rsi,
+                            frame->rdx,
+                            frame->r10,
+                            frame->r8,
+                            frame->r9};
+
+        syscall_trace_record(frame->rax, args, retval, start, cycles);
+    }
+
+    return retval;
+}
+
 #define DECLARE_SYSCALL(NAME, FUNC) \
     _syscalls[SYSCALL_##NAME] = (syscall_func_t)syscall_##FUNC
 
@@ -64,6 +121,8 @@ void syscall_install()
     DECLARE_SYSCALL(YIELD, yield);
     DECLARE_SYSCALL(SLEEP, sleep);
 
+    DECLARE_SYSCALL(CLONE, clone);
+
     DECLARE_SYSCALL(OPEN, open);
     DECLARE_SYSCALL(CLOSE, close);
     DECLARE_SYSCALL(READ, read);
@@ -88,9 +147,44 @@ void syscall_install()
 
     DECLARE_SYSCALL(GETTIMEOFDAY, gettimeofday);
     DECLARE_SYSCALL(SETTIMEOFDAY, settimeofday);
+
+    DECLARE_SYSCALL(FUTEX, futex);
+
+    DECLARE_SYSCALL(SPAWN, spawn);
+
+    DECLARE_SYSCALL(READV, readv);
+    DECLARE_SYSCALL(WRITEV, writev);
+    DECLARE_SYSCALL(PREAD, pread);
+    DECLARE_SYSCALL(PWRITE, pwrite);
+
+    DECLARE_SYSCALL(IO_RING_SETUP, io_ring_setup);
+    DECLARE_SYSCALL(IO_RING_ENTER, io_ring_enter);
+
+    DECLARE_SYSCALL(GETDENTS, getdents);
+
+    DECLARE_SYSCALL(COPY_FILE_RANGE, copy_file_range);
+    DECLARE_SYSCALL(SENDFILE, sendfile);
+
+    DECLARE_SYSCALL(PIPE, pipe);
+    DECLARE_SYSCALL(SPLICE, splice);
+
+    DECLARE_SYSCALL(SHM_OPEN, shm_open);
+    DECLARE_SYSCALL(SHM_UNLINK, shm_unlink);
+    DECLARE_SYSCALL(FTRUNCATE, ftruncate);
+    DECLARE_SYSCALL(MMAP, mmap);
+    DECLARE_SYSCALL(MUNMAP, munmap);
+
+    DECLARE_SYSCALL(POLL, poll);
+    DECLARE_SYSCALL(EPOLL_CREATE, epoll_create);
+    DECLARE_SYSCALL(EPOLL_CTL, epoll_ctl);
+    DECLARE_SYSCALL(EPOLL_WAIT, epoll_wait);
 #pragma GCC diagnostic pop
 
+    // int 0x80 is kept for compatibility, SYSCALL is the fast path
     set_irq_handler(SYSCALL_INTNO, syscall_handler);
+    arch_x86_64_set_syscall_handler(syscall_fast_handler);
+
+    syscall_trace_install();
 
     log_info("[SYSCALL] Done!");
 }
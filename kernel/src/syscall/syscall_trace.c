@@ -0,0 +1,387 @@
+/**
+ * @file syscall_trace.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief System call statistics and tracing
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <syscall/syscall_trace.h>
+
+#include <arch/arch.h>
+#include <logging/logging.h>
+#include <process/process.h>
+#include <vfs/vfs.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//=============================================================================
+// Local data
+//=============================================================================
+
+volatile int syscall_trace_enabled = 0;
+
+static pid_t syscall_trace_group = 0;
+
+static syscall_stats_t syscall_stats[SYSCALL_MAX];
+
+// Entries between tail and head have not been drained yet
+static syscall_trace_entry_t syscall_trace[SYSCALL_TRACE_SIZE];
+static uint64_t syscall_trace_head = 0;
+static uint64_t syscall_trace_tail = 0;
+static uint64_t syscall_trace_lost = 0;
+
+// Longest line produced by syscall_stats_format, including the histogram
+#define SYSCALL_STATS_LINE_MAX (64 + SYSCALL_HIST_BUCKETS * 24)
+
+//=============================================================================
+// Private functions
+//=============================================================================
+
+static int syscall_hist_bucket(uint64_t cycles)
+{
+    if (cycles == 0)
+    {
+        return 0;
+    }
+
+    int bucket = 63 - __builtin_clzll(cycles);
+
+    return bucket < SYSCALL_HIST_BUCKETS ? bucket : SYSCALL_HIST_BUCKETS - 1;
+}
+
+static int syscall_stats_format(char *buf, int number, syscall_stats_t *stats)
+{
+    int length = sprintf(buf,
+                         "%3d %10u %10u %10u ",
+                         (int64_t)number,
+                         stats->count,
+                         stats->total_cycles / stats->count,
+                         stats->max_cycles);
+
+    for (int i = 0; i < SYSCALL_HIST_BUCKETS; ++i)
+    {
+        if (stats->histogram[i])
+        {
+            length += sprintf(
+                buf + length, " %d:%u", (int64_t)i, stats->histogram[i]);
+        }
+    }
+
+    buf[length++] = '\n';
+    buf[length] = '\0';
+
+    return length;
+}
+
+static size_t syscall_trace_drain(syscall_trace_entry_t *entries, size_t max)
+{
+    uint64_t flags = irq_save();
+
+    size_t n = syscall_trace_head - syscall_trace_tail;
+
+    if (n > max)
+    {
+        n = max;
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        entries[i] = syscall_trace[syscall_trace_tail++ % SYSCALL_TRACE_SIZE];
+    }
+
+    irq_restore(flags);
+
+    return n;
+}
+
+static uint32_t read_syscalls(fs_node_t *node,
+                              uint64_t offset,
+                              uint32_t size,
+                              uint8_t *buffer)
+{
+    (void)node;
+
+    syscall_stats_t *stats = malloc(sizeof(syscall_stats));
+    char *text = malloc(SYSCALL_STATS_LINE_MAX * (SYSCALL_MAX + 1));
+
+    if (!stats || !text)
+    {
+        free(stats);
+        free(text);
+        return 0;
+    }
+
+    uint64_t flags = irq_save();
+    memcpy(stats, syscall_stats, sizeof(syscall_stats));
+    irq_restore(flags);
+
+    size_t length =
+        sprintf(text, " nr      calls avg cycles max cycles  log2:calls\n");
+
+    for (int i = 0; i < SYSCALL_MAX; ++i)
+    {
+        if (stats[i].count)
+        {
+            length += syscall_stats_format(text + length, i, &stats[i]);
+        }
+    }
+
+    uint32_t copied = 0;
+
+    if (offset < length)
+    {
+        copied = length - offset < size ? length - offset : size;
+        memcpy(buffer, text + offset, copied);
+    }
+
+    free(stats);
+    free(text);
+
+    return copied;
+}
+
+static uint32_t read_systrace(fs_node_t *node,
+                              uint64_t offset,
+                              uint32_t size,
+                              uint8_t *buffer)
+{
+    (void)node;
+    (void)offset;
+
+    // The ring is drained by reading, so only whole entries are returned
+    size_t n = syscall_trace_drain((syscall_trace_entry_t *)buffer,
+                                   size / sizeof(syscall_trace_entry_t));
+
+    return n * sizeof(syscall_trace_entry_t);
+}
+
+static uint32_t write_systrace(fs_node_t *node,
+                               uint64_t offset,
+                               uint32_t size,
+                               uint8_t *buffer)
+{
+    (void)node;
+    (void)offset;
+
+    char command[16] = {0};
+
+    memcpy(command, buffer, size < sizeof(command) - 1 ? size : 15);
+
+    if (strncmp(command, "off", 3) == 0)
+    {
+        syscall_trace_set(0);
+    }
+    else if (strncmp(command, "all", 3) == 0)
+    {
+        syscall_trace_set(SYSCALL_TRACE_ALL);
+    }
+    else
+    {
+        syscall_trace_set(atoi(command));
+    }
+
+    return size;
+}
+
+static void open_syscall_dev(fs_node_t *node, uint32_t flags)
+{
+    return;
+}
+
+static void close_syscall_dev(fs_node_t *node)
+{
+    return;
+}
+
+static void syscall_trace_mount(const char *path,
+                                const char *name,
+                                uint16_t permissions,
+                                read_func_t read,
+                                write_func_t write)
+{
+    fs_node_t *node = malloc(sizeof(fs_node_t));
+
+    if (!node)
+    {
+        return;
+    }
+
+    memset(node, 0, sizeof(fs_node_t));
+
+    node->inode = 0;
+    strcpy(node->name, name);
+
+    node->uid = 0;
+    node->gid = 0;
+
+    node->permissions = permissions;
+    node->flags = FS_CHARDEVICE | FS_FILE;
+    node->read = read;
+    node->write = write;
+    node->open = open_syscall_dev;
+    node->close = close_syscall_dev;
+
+    vfs_mount((char *)path, node);
+}
+
+//=============================================================================
+// Interface functions
+//=============================================================================
+
+void syscall_stats_record(uint64_t number, uint64_t cycles)
+{
+    syscall_stats_t *stats = &syscall_stats[number];
+
+    // Another process may preempt us inside a system call, so the counters
+    // are updated atomically. The maximum may miss a concurrent update.
+    __atomic_add_fetch(&stats->count, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&stats->total_cycles, cycles, __ATOMIC_RELAXED);
+    __atomic_add_fetch(
+        &stats->histogram[syscall_hist_bucket(cycles)], 1, __ATOMIC_RELAXED);
+
+    if (cycles > stats->max_cycles)
+    {
+        stats->max_cycles = cycles;
+    }
+}
+
+void syscall_trace_record(uint64_t number,
+                          const uint64_t *args,
+                          int64_t retval,
+                          uint64_t timestamp,
+                          uint64_t cycles)
+{
+    process_t *proc = process_get_current();
+
+    if (syscall_trace_group != SYSCALL_TRACE_ALL &&
+        proc->group != syscall_trace_group)
+    {
+        return;
+    }
+
+    uint64_t flags = irq_save();
+
+    if (syscall_trace_head - syscall_trace_tail == SYSCALL_TRACE_SIZE)
+    {
+        ++syscall_trace_tail;
+        ++syscall_trace_lost;
+    }
+
+    syscall_trace_entry_t *entry =
+        &syscall_trace[syscall_trace_head % SYSCALL_TRACE_SIZE];
+
+    entry->timestamp = timestamp;
+    entry->cycles = cycles;
+    entry->pid = proc->id;
+    entry->number = (uint32_t)number;
+    memcpy(entry->args, args, sizeof(entry->args));
+    entry->retval = retval;
+
+    ++syscall_trace_head;
+
+    irq_restore(flags);
+}
+
+void syscall_trace_set(pid_t group)
+{
+    syscall_trace_group = group;
+    syscall_trace_enabled = group != 0;
+}
+
+void syscall_stats_dump()
+{
+    char *line = malloc(SYSCALL_STATS_LINE_MAX);
+
+    if (!line)
+    {
+        return;
+    }
+
+    printf(" nr      calls avg cycles max cycles  log2:calls\n");
+
+    for (int i = 0; i < SYSCALL_MAX; ++i)
+    {
+        syscall_stats_t stats = syscall_stats[i];
+
+        if (stats.count)
+        {
+            syscall_stats_format(line, i, &stats);
+            printf("%s", line);
+        }
+    }
+
+    free(line);
+}
+
+void syscall_stats_reset()
+{
+    uint64_t flags = irq_save();
+    memset(syscall_stats, 0, sizeof(syscall_stats));
+    irq_restore(flags);
+}
+
+void syscall_trace_dump()
+{
+    syscall_trace_entry_t *entries =
+        malloc(sizeof(syscall_trace_entry_t) * SYSCALL_TRACE_SIZE);
+
+    if (!entries)
+    {
+        return;
+    }
+
+    size_t n = syscall_trace_drain(entries, SYSCALL_TRACE_SIZE);
+
+    printf("%d system calls, %u lost:\n", (int64_t)n, syscall_trace_lost);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        syscall_trace_entry_t *e = &entries[i];
+
+        printf("%016x %5d %3d(%x, %x, %x, %x, %x, %x) = %d [%u]\n",
+               e->timestamp,
+               (int64_t)e->pid,
+               (int64_t)e->number,
+               e->args[0],
+               e->args[1],
+               e->args[2],
+               e->args[3],
+               e->args[4],
+               e->args[5],
+               e->retval,
+               e->cycles);
+    }
+
+    free(entries);
+}
+
+void syscall_trace_install()
+{
+    log_info("[SYSCALL] Installing syscalls and systrace devices");
+
+    syscall_trace_mount(
+        "/dev/syscalls", "syscalls", 0444, read_syscalls, NULL);
+    syscall_trace_mount(
+        "/dev/systrace", "systrace", 0600, read_systrace, write_systrace);
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
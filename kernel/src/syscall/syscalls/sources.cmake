@@ -3,27 +3,50 @@ kernel_source(syscall_access.c)
 kernel_source(syscall_chdir.c)
 kernel_source(syscall_chmod.c)
 kernel_source(syscall_chown.c)
+kernel_source(syscall_clone.c)
 kernel_source(syscall_close.c)
+kernel_source(syscall_copy_file_range.c)
 kernel_source(syscall_debug_print.c)
+kernel_source(syscall_epoll_create.c)
+kernel_source(syscall_epoll_ctl.c)
+kernel_source(syscall_epoll_wait.c)
 kernel_source(syscall_exit.c)
+kernel_source(syscall_ftruncate.c)
+kernel_source(syscall_futex.c)
 kernel_source(syscall_getcwd.c)
+kernel_source(syscall_getdents.c)
 kernel_source(syscall_getpid.c)
 kernel_source(syscall_gettid.c)
 kernel_source(syscall_gettimeofday.c)
+kernel_source(syscall_io_ring_enter.c)
+kernel_source(syscall_io_ring_setup.c)
 kernel_source(syscall_ioctl.c)
 kernel_source(syscall_lstat.c)
 kernel_source(syscall_mkdir.c)
+kernel_source(syscall_mmap.c)
+kernel_source(syscall_munmap.c)
 kernel_source(syscall_open.c)
+kernel_source(syscall_pipe.c)
+kernel_source(syscall_poll.c)
+kernel_source(syscall_pread.c)
+kernel_source(syscall_pwrite.c)
 kernel_source(syscall_read.c)
 kernel_source(syscall_readdir.c)
 kernel_source(syscall_readlink.c)
+kernel_source(syscall_readv.c)
 kernel_source(syscall_sbrk.c)
 kernel_source(syscall_seek.c)
+kernel_source(syscall_sendfile.c)
 kernel_source(syscall_settimeofday.c)
+kernel_source(syscall_shm_open.c)
+kernel_source(syscall_shm_unlink.c)
 kernel_source(syscall_sleep.c)
+kernel_source(syscall_spawn.c)
+kernel_source(syscall_splice.c)
 kernel_source(syscall_stat.c)
 kernel_source(syscall_statf.c)
 kernel_source(syscall_symlink.c)
 kernel_source(syscall_unlink.c)
 kernel_source(syscall_write.c)
+kernel_source(syscall_writev.c)
 kernel_source(syscall_yield.c)
\ No newline at end of file
@@ -0,0 +1,37 @@
+/**
+ * @file syscall_clone.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <syscall/syscall.h>
+
+int syscall_clone(uintptr_t new_stack, uintptr_t thread_func, uintptr_t arg)
+{
+    if (!thread_func)
+    {
+        return -EINVAL;
+    }
+
+    return process_clone(new_stack, thread_func, arg);
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
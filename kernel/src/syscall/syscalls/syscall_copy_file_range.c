@@ -0,0 +1,103 @@
+/**
+ * @file syscall_copy_file_range.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <syscall/syscall.h>
+
+int syscall_copy_file_range(int fd_in,
+                            int64_t *off_in,
+                            int fd_out,
+                            int64_t *off_out,
+                            uint64_t len,
+                            unsigned int flags)
+{
+    if (!FILE_DESC_CHECK(fd_in) || !FILE_DESC_CHECK(fd_out))
+    {
+        return -EBADF;
+    }
+
+    if (flags != 0)
+    {
+        return -EINVAL;
+    }
+
+    if (!(FILE_DESC_MODE(fd_in) & 01) || !(FILE_DESC_MODE(fd_out) & 02))
+    {
+        printf("[SYSCALL] Access denied\n");
+        return -EBADF;
+    }
+
+    fs_node_t *in = FILE_DESC_ENTRY(fd_in);
+    fs_node_t *out = FILE_DESC_ENTRY(fd_out);
+
+    if ((in->flags & FS_DIRECTORY) || (out->flags & FS_DIRECTORY))
+    {
+        return -EISDIR;
+    }
+
+    int64_t in_pos = off_in ? *off_in : (int64_t)FILE_DESC_OFFSET(fd_in);
+    int64_t out_pos = off_out ? *off_out : (int64_t)FILE_DESC_OFFSET(fd_out);
+
+    if (in_pos < 0 || out_pos < 0)
+    {
+        return -EINVAL;
+    }
+
+    // The result is returned as an int
+    if (len > 0x7FFFFFFF)
+    {
+        len = 0x7FFFFFFF;
+    }
+
+    // Copying within a file is only allowed if the ranges do not overlap
+    if (in->device == out->device && in->inode == out->inode &&
+        in_pos < out_pos + (int64_t)len && out_pos < in_pos + (int64_t)len)
+    {
+        return -EINVAL;
+    }
+
+    uint32_t copied = copy_range_fs(
+        in, (uint64_t)in_pos, out, (uint64_t)out_pos, (uint32_t)len);
+
+    if (off_in)
+    {
+        *off_in += copied;
+    }
+    else
+    {
+        FILE_DESC_OFFSET(fd_in) += copied;
+    }
+
+    if (off_out)
+    {
+        *off_out += copied;
+    }
+    else
+    {
+        FILE_DESC_OFFSET(fd_out) += copied;
+    }
+
+    return (int)copied;
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
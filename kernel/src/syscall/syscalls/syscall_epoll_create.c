@@ -0,0 +1,52 @@
+/**
+ * @file syscall_epoll_create.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Epoll create syscall
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <syscall/syscall.h>
+
+#include <vfs/epoll.h>
+
+int syscall_epoll_create(int size)
+{
+    // The size is only a hint, the interest list grows as needed
+    if (size <= 0)
+    {
+        return -EINVAL;
+    }
+
+    fs_node_t *node;
+
+    int ret = epoll_create(&node);
+
+    if (ret < 0)
+    {
+        return ret;
+    }
+
+    int fd = (int)process_append_fd(process_get_current(), node);
+    FILE_DESC_MODE(fd) = 01;
+
+    return fd;
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -0,0 +1,47 @@
+/**
+ * @file syscall_epoll_ctl.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Epoll ctl syscall
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <syscall/syscall.h>
+
+#include <vfs/epoll.h>
+
+int syscall_epoll_ctl(int epfd, int op, int fd, struct epoll_event *event)
+{
+    if (!FILE_DESC_CHECK(epfd) || !FILE_DESC_CHECK(fd))
+    {
+        return -EBADF;
+    }
+
+    fs_node_t *epoll = FILE_DESC_ENTRY(epfd);
+
+    if (!epoll_is_epoll(epoll))
+    {
+        return -EINVAL;
+    }
+
+    return epoll_ctl(
+        epoll, op, fd, FILE_DESC_ENTRY(fd), FILE_DESC_MODE(fd), event);
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
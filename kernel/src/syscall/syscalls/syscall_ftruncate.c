@@ -0,0 +1,64 @@
+/**
+ * @file syscall_ftruncate.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Ftruncate syscall
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <syscall/syscall.h>
+
+#include <mm/shm.h>
+
+int syscall_ftruncate(int fd, int64_t length)
+{
+    if (!FILE_DESC_CHECK(fd) || !(FILE_DESC_MODE(fd) & 02))
+    {
+        return -EBADF;
+    }
+
+    if (length < 0)
+    {
+        return -EINVAL;
+    }
+
+    fs_node_t *node = FILE_DESC_ENTRY(fd);
+
+    if (shm_is_shm(node))
+    {
+        return shm_truncate(node, (uint64_t)length);
+    }
+
+    if (node->flags & FS_DIRECTORY)
+    {
+        return -EISDIR;
+    }
+
+    // File systems can only discard the whole file
+    if (length != 0)
+    {
+        return -EINVAL;
+    }
+
+    truncate_fs(node);
+
+    return 0;
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
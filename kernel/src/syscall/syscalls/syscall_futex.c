@@ -0,0 +1,48 @@
+/**
+ * @file syscall_futex.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <syscall/syscall.h>
+
+#include <sync/futex.h>
+
+int syscall_futex(uint32_t *uaddr,
+                  int op,
+                  uint32_t val,
+                  uint32_t val2,
+                  uint32_t *uaddr2)
+{
+    switch (op)
+    {
+    case FUTEX_WAIT:
+        return futex_wait(uaddr, val);
+    case FUTEX_WAKE:
+        return futex_wake(uaddr, (int)val);
+    case FUTEX_REQUEUE:
+        return futex_requeue(uaddr, (int)val, uaddr2, (int)val2);
+    default:
+        return -EINVAL;
+    }
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
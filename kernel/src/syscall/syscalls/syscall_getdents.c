@@ -0,0 +1,45 @@
+/**
+ * @file syscall_getdents.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <syscall/syscall.h>
+
+int syscall_getdents(int fd, void *buffer, size_t size)
+{
+    if (!FILE_DESC_CHECK(fd))
+    {
+        return -EBADF;
+    }
+
+    if (!buffer)
+    {
+        return -EINVAL;
+    }
+
+    // Directories have no data to read, so the file offset is used as the
+    // directory cursor. Seeking to 0 restarts the listing.
+    return getdents_fs(
+        FILE_DESC_ENTRY(fd), &FILE_DESC_OFFSET(fd), (uint8_t *)buffer, size);
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
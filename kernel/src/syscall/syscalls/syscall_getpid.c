@@ -24,8 +24,7 @@
 
 int syscall_getpid()
 {
-    // TODO: This should return the group ID if the process is in a group
-    return process_get_current()->id;
+    return process_get_current()->group;
 }
 
 //=============================================================================
@@ -24,7 +24,7 @@
 
 int syscall_gettid()
 {
-    return syscall_getpid();
+    return process_get_current()->id;
 }
 
 //=============================================================================
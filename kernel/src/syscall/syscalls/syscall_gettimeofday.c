@@ -22,28 +22,26 @@
 
 #include <syscall/syscall.h>
 
-#include <cmos/cmos_rtc.h>
 #include <logging/logging.h>
+#include <process/vdso.h>
 
 int syscall_gettimeofday(struct timeval *tv, struct timezone *tz)
 {
     (void) tz; // TODO: Handle timezone.
 
-    // TODO: Handle the case where RTC is not initialized correctly.
+    // The same clock is readable directly from the data page at
+    // VDSO_DATA_ADDR, which is what libc uses.
+    int64_t sec;
+    int64_t nsec;
 
-    ktime_t ktime;
-    RTC_get_time(&ktime);
-
-    time_t seconds = (time_t)RTC_time_to_int(&ktime);
+    vdso_get_time(1, &sec, &nsec);
 
     if (tv != NULL)
     {
-        tv->tv_sec = seconds;
-        tv->tv_usec = 0; // TODO: This needs to be filled out too.
+        tv->tv_sec = sec;
+        tv->tv_usec = nsec / 1000;
     }
 
-    log_info("gettimeofday: %i", seconds);
-
     return 0;
 }
 
@@ -0,0 +1,91 @@
+/**
+ * @file syscall_mmap.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Mmap syscall
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <syscall/syscall.h>
+
+#include <mm/shm.h>
+
+int syscall_mmap(uintptr_t addr,
+                 uint64_t length,
+                 int prot,
+                 int flags,
+                 int fd,
+                 int64_t offset)
+{
+    // The address is only a hint, and only shared mappings are supported
+    (void)addr;
+
+    if (!(flags & MAP_SHARED) || (flags & (MAP_PRIVATE | MAP_FIXED)))
+    {
+        return -EINVAL;
+    }
+
+    if (offset < 0)
+    {
+        return -EINVAL;
+    }
+
+    fs_node_t *node = NULL;
+
+    if (!(flags & MAP_ANONYMOUS))
+    {
+        if (!FILE_DESC_CHECK(fd) || !(FILE_DESC_MODE(fd) & 01))
+        {
+            return -EBADF;
+        }
+
+        if ((prot & PROT_WRITE) && !(FILE_DESC_MODE(fd) & 02))
+        {
+            return -EACCES;
+        }
+
+        node = FILE_DESC_ENTRY(fd);
+
+        if (!shm_is_shm(node))
+        {
+            return -ENODEV;
+        }
+    }
+
+    process_t *leader = process_from_pid(process_get_current()->group);
+
+    if (!leader)
+    {
+        return -ESRCH;
+    }
+
+    uintptr_t start;
+
+    int ret = shm_map(leader, node, &start, length, (uint64_t)offset, prot);
+
+    if (ret < 0)
+    {
+        return ret;
+    }
+
+    // The mapping range lies below 2 GB, so the address fits the return value
+    return (int)start;
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
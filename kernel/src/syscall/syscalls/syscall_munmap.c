@@ -0,0 +1,41 @@
+/**
+ * @file syscall_munmap.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Munmap syscall
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <syscall/syscall.h>
+
+#include <mm/shm.h>
+
+int syscall_munmap(uintptr_t addr, uint64_t length)
+{
+    process_t *leader = process_from_pid(process_get_current()->group);
+
+    if (!leader)
+    {
+        return -ESRCH;
+    }
+
+    return shm_unmap(leader, addr, length);
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -0,0 +1,57 @@
+/**
+ * @file syscall_pipe.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <syscall/syscall.h>
+
+#include <vfs/pipe.h>
+
+int syscall_pipe(int *fds)
+{
+    if (!fds)
+    {
+        return -EFAULT;
+    }
+
+    fs_node_t *read_node;
+    fs_node_t *write_node;
+
+    int ret = pipe_create(&read_node, &write_node);
+
+    if (ret < 0)
+    {
+        return ret;
+    }
+
+    process_t *proc = process_get_current();
+
+    fds[0] = (int)process_append_fd(proc, read_node);
+    FILE_DESC_MODE(fds[0]) = 01;
+
+    fds[1] = (int)process_append_fd(proc, write_node);
+    FILE_DESC_MODE(fds[1]) = 02;
+
+    return 0;
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -0,0 +1,149 @@
+/**
+ * @file syscall_poll.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Poll syscall
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <syscall/syscall.h>
+
+#include <vfs/poll.h>
+
+static void poll_wake(poll_entry_t *entry, int events)
+{
+    (void)events;
+
+    wait_queue_wake_all((wait_queue_t *)entry->data);
+}
+
+static int poll_scan(struct pollfd *fds, uint64_t nfds)
+{
+    int count = 0;
+
+    for (uint64_t i = 0; i < nfds; ++i)
+    {
+        fds[i].revents = 0;
+
+        // Negative descriptors are ignored
+        if (fds[i].fd < 0)
+        {
+            continue;
+        }
+
+        if (!FILE_DESC_CHECK(fds[i].fd))
+        {
+            fds[i].revents = POLLNVAL;
+        }
+        else
+        {
+            int events = poll_node_events(FILE_DESC_ENTRY(fds[i].fd),
+                                          FILE_DESC_MODE(fds[i].fd));
+
+            // Errors and hangups are reported even if not asked for
+            fds[i].revents =
+                (short)(events & (fds[i].events | POLLERR | POLLHUP));
+        }
+
+        if (fds[i].revents)
+        {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+int syscall_poll(struct pollfd *fds, uint64_t nfds, int timeout)
+{
+    if (nfds > POLL_MAX)
+    {
+        return -EINVAL;
+    }
+
+    if (!fds && nfds)
+    {
+        return -EFAULT;
+    }
+
+    int count = poll_scan(fds, nfds);
+
+    if (count || timeout == 0)
+    {
+        return count;
+    }
+
+    // Register with every node, so that any of them changing wakes us
+    wait_queue_t wait;
+    wait_queue_init(&wait);
+
+    poll_entry_t *entries = malloc(nfds * sizeof(poll_entry_t));
+
+    if (!entries)
+    {
+        return -ENOMEM;
+    }
+
+    memset(entries, 0, nfds * sizeof(poll_entry_t));
+
+    for (uint64_t i = 0; i < nfds; ++i)
+    {
+        if (fds[i].fd >= 0 && FILE_DESC_CHECK(fds[i].fd))
+        {
+            entries[i].notify = poll_wake;
+            entries[i].data = &wait;
+
+            selectwait_fs(FILE_DESC_ENTRY(fds[i].fd), &entries[i]);
+        }
+    }
+
+    // Scanning again with interrupts disabled closes the window between the
+    // first scan and the registration
+    uint64_t flags = irq_save();
+
+    count = poll_scan(fds, nfds);
+
+    while (count == 0)
+    {
+        if (timeout < 0)
+        {
+            wait_queue_sleep(&wait);
+        }
+        else if (!wait_queue_sleep_timeout(&wait, (uint64_t)timeout))
+        {
+            count = poll_scan(fds, nfds);
+            break;
+        }
+
+        count = poll_scan(fds, nfds);
+    }
+
+    irq_restore(flags);
+
+    for (uint64_t i = 0; i < nfds; ++i)
+    {
+        poll_head_remove(&entries[i]);
+    }
+
+    free(entries);
+
+    return count;
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -0,0 +1,53 @@
+/**
+ * @file syscall_pwrite.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <syscall/syscall.h>
+
+int syscall_pwrite(int fd, char *ptr, uint64_t len, int64_t offset)
+{
+    if (!FILE_DESC_CHECK(fd))
+    {
+        return -EBADF;
+    }
+
+    if (offset < 0)
+    {
+        return -EINVAL;
+    }
+
+    fs_node_t *node = FILE_DESC_ENTRY(fd);
+
+    if (!(FILE_DESC_MODE(fd) & 02))
+    {
+        printf("[SYSCALL] Access denied\n");
+        return -EACCES;
+    }
+
+    // The file offset is neither used nor updated
+    uint32_t out = write_fs(node, (uint64_t)offset, len, (uint8_t *)ptr);
+
+    return (int)out;
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -0,0 +1,53 @@
+/**
+ * @file syscall_readv.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <syscall/syscall.h>
+
+int syscall_readv(int fd, const struct iovec *iov, int iovcnt)
+{
+    if (!FILE_DESC_CHECK(fd))
+    {
+        return -EBADF;
+    }
+
+    if (iovcnt < 0 || iovcnt > IOV_MAX || (iovcnt && !iov))
+    {
+        return -EINVAL;
+    }
+
+    fs_node_t *node = FILE_DESC_ENTRY(fd);
+
+    if (!(FILE_DESC_MODE(fd) & 01))
+    {
+        printf("[SYSCALL] Access denied\n");
+        return -EACCES;
+    }
+
+    uint32_t out = readv_fs(node, FILE_DESC_OFFSET(fd), iov, iovcnt);
+    FILE_DESC_OFFSET(fd) += out;
+
+    return (int)out;
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -0,0 +1,34 @@
+/**
+ * @file syscall_sendfile.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <syscall/syscall.h>
+
+int syscall_sendfile(int out_fd, int in_fd, int64_t *offset, uint64_t count)
+{
+    // Same as copy_file_range, except that the output always uses and
+    // advances the file offset.
+    return syscall_copy_file_range(in_fd, offset, out_fd, NULL, count, 0);
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
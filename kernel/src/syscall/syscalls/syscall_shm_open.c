@@ -0,0 +1,53 @@
+/**
+ * @file syscall_shm_open.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Shm open syscall
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <syscall/syscall.h>
+
+#include <mm/shm.h>
+
+int syscall_shm_open(const char *name, int oflag, int mode)
+{
+    if (!name)
+    {
+        return -EFAULT;
+    }
+
+    fs_node_t *node;
+
+    int ret = shm_open(name, oflag, mode, &node);
+
+    if (ret < 0)
+    {
+        return ret;
+    }
+
+    int fd = process_append_fd(process_get_current(), node);
+
+    FILE_DESC_MODE(fd) = (oflag & O_RDWR) ? 03 : 01;
+    FILE_DESC_OFFSET(fd) = 0;
+
+    return fd;
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -0,0 +1,41 @@
+/**
+ * @file syscall_spawn.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <syscall/syscall.h>
+
+int syscall_spawn(const char *path,
+                  char **argv,
+                  char **env,
+                  const spawn_file_action_t *actions,
+                  size_t action_count)
+{
+    if (!path || (action_count && !actions))
+    {
+        return -EINVAL;
+    }
+
+    return process_spawn(path, argv, env, actions, action_count);
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -0,0 +1,110 @@
+/**
+ * @file syscall_splice.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <syscall/syscall.h>
+
+#include <vfs/pipe.h>
+
+int syscall_splice(int fd_in,
+                   int64_t *off_in,
+                   int fd_out,
+                   int64_t *off_out,
+                   uint64_t len,
+                   unsigned int flags)
+{
+    (void)flags;
+
+    if (!FILE_DESC_CHECK(fd_in) || !FILE_DESC_CHECK(fd_out))
+    {
+        return -EBADF;
+    }
+
+    if (!(FILE_DESC_MODE(fd_in) & 01) || !(FILE_DESC_MODE(fd_out) & 02))
+    {
+        return -EBADF;
+    }
+
+    fs_node_t *in = FILE_DESC_ENTRY(fd_in);
+    fs_node_t *out = FILE_DESC_ENTRY(fd_out);
+
+    int in_pipe = pipe_is_pipe(in);
+    int out_pipe = pipe_is_pipe(out);
+
+    // One of the ends must be a pipe, and pipes have no offsets
+    if ((!in_pipe && !out_pipe) || (in_pipe && off_in) ||
+        (out_pipe && off_out))
+    {
+        return -EINVAL;
+    }
+
+    if (len > 0x7FFFFFFF)
+    {
+        len = 0x7FFFFFFF;
+    }
+
+    int ret;
+
+    if (in_pipe)
+    {
+        // Covers pipe to pipe as well, the data is written from the ring of
+        // the input pipe straight into the ring of the output pipe.
+        uint64_t pos = off_out ? (uint64_t)*off_out : FILE_DESC_OFFSET(fd_out);
+
+        ret = pipe_splice_to(in, out, pos, (uint32_t)len);
+
+        if (ret > 0 && !out_pipe)
+        {
+            if (off_out)
+            {
+                *off_out += ret;
+            }
+            else
+            {
+                FILE_DESC_OFFSET(fd_out) += ret;
+            }
+        }
+    }
+    else
+    {
+        uint64_t pos = off_in ? (uint64_t)*off_in : FILE_DESC_OFFSET(fd_in);
+
+        ret = pipe_splice_from(out, in, pos, (uint32_t)len);
+
+        if (ret > 0)
+        {
+            if (off_in)
+            {
+                *off_in += ret;
+            }
+            else
+            {
+                FILE_DESC_OFFSET(fd_in) += ret;
+            }
+        }
+    }
+
+    return ret;
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
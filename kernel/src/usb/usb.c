@@ -24,6 +24,11 @@
 #include <usb/usb_controller.h>
 #include <usb/usb_device.h>
 
+#include <logging/logging.h>
+#include <process/process.h>
+
+#define USB_POLL_INTERVAL_MS 20
+
 void usb_poll()
 {
     for (usb_controller_t *c = usb_get_controller_list(); c; c = c->next)
@@ -43,6 +48,28 @@ void usb_poll()
     }
 }
 
+static int usb_poll_thread(void *arg)
+{
+    (void)arg;
+
+    while (1)
+    {
+        usb_poll();
+
+        process_sleep(USB_POLL_INTERVAL_MS);
+    }
+
+    return 0;
+}
+
+void usb_start_poll_thread()
+{
+    if (!kthread_create("[usb poll]", usb_poll_thread, NULL))
+    {
+        log_error("[USB] Failed to start poll thread");
+    }
+}
+
 //=============================================================================
 // End of file
 //=============================================================================
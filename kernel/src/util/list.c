@@ -61,6 +61,7 @@ void list_append(list_t *list, list_node_t *item)
 
     if (!list->tail)
     {
+        item->prev = NULL;
         list->head = item;
     }
     else
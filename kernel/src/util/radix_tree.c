@@ -0,0 +1,322 @@
+/**
+ * @file radix_tree.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Radix tree mapping integer indices to pointers
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <util/radix_tree.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define RADIX_TREE_MASK (RADIX_TREE_SLOTS - 1)
+
+// Height needed to hold every 64 bit index
+#define RADIX_TREE_MAX_HEIGHT ((64 + RADIX_TREE_SHIFT - 1) / RADIX_TREE_SHIFT)
+
+//=============================================================================
+// Local functions
+//=============================================================================
+
+static radix_tree_node_t *radix_tree_node_alloc()
+{
+    radix_tree_node_t *node =
+        (radix_tree_node_t *)malloc(sizeof(radix_tree_node_t));
+
+    if (node)
+    {
+        memset(node, 0, sizeof(radix_tree_node_t));
+    }
+
+    return node;
+}
+
+static int radix_tree_fits(radix_tree_t *tree, uint64_t index)
+{
+    if (tree->height >= RADIX_TREE_MAX_HEIGHT)
+    {
+        return 1;
+    }
+
+    return (index >> (tree->height * RADIX_TREE_SHIFT)) == 0;
+}
+
+static uint32_t radix_tree_slot(uint64_t index, uint32_t level)
+{
+    return (index >> (level * RADIX_TREE_SHIFT)) & RADIX_TREE_MASK;
+}
+
+static size_t radix_tree_gang(radix_tree_node_t *node,
+                              uint32_t level,
+                              uint64_t base,
+                              uint64_t first,
+                              void **items,
+                              uint64_t *indices,
+                              size_t max,
+                              size_t found)
+{
+    for (uint32_t slot = 0; slot < RADIX_TREE_SLOTS && found < max; ++slot)
+    {
+        if (!node->slots[slot])
+        {
+            continue;
+        }
+
+        uint64_t index = base | ((uint64_t)slot << (level * RADIX_TREE_SHIFT));
+
+        if (level == 0)
+        {
+            if (index >= first)
+            {
+                items[found] = node->slots[slot];
+
+                if (indices)
+                {
+                    indices[found] = index;
+                }
+
+                ++found;
+            }
+
+            continue;
+        }
+
+        // Skip subtrees that only hold indices before the first one
+        uint64_t last = index | ((1ULL << (level * RADIX_TREE_SHIFT)) - 1);
+
+        if (last < first)
+        {
+            continue;
+        }
+
+        found = radix_tree_gang((radix_tree_node_t *)node->slots[slot],
+                                level - 1,
+                                index,
+                                first,
+                                items,
+                                indices,
+                                max,
+                                found);
+    }
+
+    return found;
+}
+
+static void radix_tree_free_node(radix_tree_node_t *node, uint32_t level)
+{
+    if (level > 0)
+    {
+        for (uint32_t slot = 0; slot < RADIX_TREE_SLOTS; ++slot)
+        {
+            if (node->slots[slot])
+            {
+                radix_tree_free_node((radix_tree_node_t *)node->slots[slot],
+                                     level - 1);
+            }
+        }
+    }
+
+    free(node);
+}
+
+//=============================================================================
+// Interface functions
+//=============================================================================
+
+void radix_tree_init(radix_tree_t *tree)
+{
+    tree->root = NULL;
+    tree->height = 0;
+}
+
+void *radix_tree_lookup(radix_tree_t *tree, uint64_t index)
+{
+    if (!tree->root || !radix_tree_fits(tree, index))
+    {
+        return NULL;
+    }
+
+    radix_tree_node_t *node = tree->root;
+
+    for (uint32_t level = tree->height - 1; level > 0; --level)
+    {
+        node = (radix_tree_node_t *)node->slots[radix_tree_slot(index, level)];
+
+        if (!node)
+        {
+            return NULL;
+        }
+    }
+
+    return node->slots[radix_tree_slot(index, 0)];
+}
+
+int radix_tree_insert(radix_tree_t *tree, uint64_t index, void *item)
+{
+    if (!tree->root)
+    {
+        tree->root = radix_tree_node_alloc();
+
+        if (!tree->root)
+        {
+            return -1;
+        }
+
+        tree->height = 1;
+    }
+
+    while (!radix_tree_fits(tree, index))
+    {
+        radix_tree_node_t *root = radix_tree_node_alloc();
+
+        if (!root)
+        {
+            return -1;
+        }
+
+        root->slots[0] = tree->root;
+        root->count = 1;
+
+        tree->root = root;
+        tree->height++;
+    }
+
+    radix_tree_node_t *node = tree->root;
+
+    for (uint32_t level = tree->height - 1; level > 0; --level)
+    {
+        uint32_t slot = radix_tree_slot(index, level);
+
+        if (!node->slots[slot])
+        {
+            radix_tree_node_t *child = radix_tree_node_alloc();
+
+            if (!child)
+            {
+                return -1;
+            }
+
+            node->slots[slot] = child;
+            node->count++;
+        }
+
+        node = (radix_tree_node_t *)node->slots[slot];
+    }
+
+    uint32_t slot = radix_tree_slot(index, 0);
+
+    if (node->slots[slot])
+    {
+        return -1;
+    }
+
+    node->slots[slot] = item;
+    node->count++;
+
+    return 0;
+}
+
+void *radix_tree_delete(radix_tree_t *tree, uint64_t index)
+{
+    if (!tree->root || !radix_tree_fits(tree, index))
+    {
+        return NULL;
+    }
+
+    radix_tree_node_t *path[RADIX_TREE_MAX_HEIGHT];
+
+    radix_tree_node_t *node = tree->root;
+
+    for (uint32_t level = tree->height - 1; level > 0; --level)
+    {
+        path[level] = node;
+
+        node = (radix_tree_node_t *)node->slots[radix_tree_slot(index, level)];
+
+        if (!node)
+        {
+            return NULL;
+        }
+    }
+
+    path[0] = node;
+
+    uint32_t slot = radix_tree_slot(index, 0);
+
+    void *item = node->slots[slot];
+
+    if (!item)
+    {
+        return NULL;
+    }
+
+    node->slots[slot] = NULL;
+    node->count--;
+
+    for (uint32_t level = 0;
+         level + 1 < tree->height && path[level]->count == 0;
+         ++level)
+    {
+        free(path[level]);
+
+        radix_tree_node_t *parent = path[level + 1];
+
+        parent->slots[radix_tree_slot(index, level + 1)] = NULL;
+        parent->count--;
+    }
+
+    if (tree->root->count == 0)
+    {
+        free(tree->root);
+
+        tree->root = NULL;
+        tree->height = 0;
+    }
+
+    return item;
+}
+
+size_t radix_tree_gang_lookup(radix_tree_t *tree,
+                              uint64_t first,
+                              void **items,
+                              uint64_t *indices,
+                              size_t max)
+{
+    if (!tree->root || !max || !radix_tree_fits(tree, first))
+    {
+        return 0;
+    }
+
+    return radix_tree_gang(
+        tree->root, tree->height - 1, 0, first, items, indices, max, 0);
+}
+
+void radix_tree_destroy(radix_tree_t *tree)
+{
+    if (tree->root)
+    {
+        radix_tree_free_node(tree->root, tree->height - 1);
+    }
+
+    radix_tree_init(tree);
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -6,6 +6,7 @@ kernel_source(huffman.c)
 kernel_source(link.c)
 kernel_source(list.c)
 kernel_source(mmio.c)
+kernel_source(radix_tree.c)
 kernel_source(sha512.c)
 kernel_source(tree.c)
-kernel_source(vector.c)
+kernel_source(vector.c)
\ No newline at end of file
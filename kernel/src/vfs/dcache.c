@@ -0,0 +1,541 @@
+/**
+ * @file dcache.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Directory entry cache
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vfs/dcache.h>
+
+#include <sync/spinlock.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct _dentry
+{
+    // Directory the entry is in
+    void *device;
+    uint32_t parent;
+    finddir_func_t finddir;
+
+    char *name;
+    uint32_t hash;
+
+    // Node the name refers to, NULL for a negative entry
+    fs_node_t *node;
+
+    struct _dentry *hash_prev;
+    struct _dentry *hash_next;
+
+    // Chained by the node the entry refers to, positive entries only
+    struct _dentry *node_prev;
+    struct _dentry *node_next;
+
+    struct _dentry *lru_prev;
+    struct _dentry *lru_next;
+} dentry_t;
+
+static dentry_t *dcache_buckets[DCACHE_BUCKETS];
+static dentry_t *dcache_node_buckets[DCACHE_BUCKETS];
+
+// Most recently used first
+static dentry_t *dcache_lru_head = NULL;
+static dentry_t *dcache_lru_tail = NULL;
+
+static dcache_stats_t dcache_stats;
+
+// Bumped on every invalidation, so that a lookup that raced with one does
+// not insert what it read from the file system.
+static uint64_t dcache_generation = 0;
+
+static spinlock_t dcache_lock = {0, 0};
+
+//=============================================================================
+// Hashing
+//=============================================================================
+
+static uint32_t dcache_hash_key(void *device, uint32_t inode)
+{
+    uint64_t key = (uint64_t)(uintptr_t)device ^ ((uint64_t)inode << 32);
+
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+
+    return (uint32_t)key;
+}
+
+static uint32_t dcache_hash_name(void *device,
+                                 uint32_t parent,
+                                 const char *name)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+
+    while (*name)
+    {
+        hash ^= (uint8_t)*name++;
+        hash *= 16777619u;
+    }
+
+    return hash ^ dcache_hash_key(device, parent);
+}
+
+static int dcache_match(dentry_t *entry,
+                        fs_node_t *parent,
+                        uint32_t hash,
+                        const char *name)
+{
+    return entry->hash == hash &&
+           entry->device == parent->device &&
+           entry->parent == parent->inode &&
+           entry->finddir == parent->finddir &&
+           !strcmp(entry->name, name);
+}
+
+//=============================================================================
+// Lists
+//=============================================================================
+
+static void dcache_lru_unlink(dentry_t *entry)
+{
+    if (entry->lru_prev)
+    {
+        entry->lru_prev->lru_next = entry->lru_next;
+    }
+    else
+    {
+        dcache_lru_head = entry->lru_next;
+    }
+
+    if (entry->lru_next)
+    {
+        entry->lru_next->lru_prev = entry->lru_prev;
+    }
+    else
+    {
+        dcache_lru_tail = entry->lru_prev;
+    }
+
+    entry->lru_prev = NULL;
+    entry->lru_next = NULL;
+}
+
+static void dcache_lru_push(dentry_t *entry)
+{
+    entry->lru_prev = NULL;
+    entry->lru_next = dcache_lru_head;
+
+    if (dcache_lru_head)
+    {
+        dcache_lru_head->lru_prev = entry;
+    }
+    else
+    {
+        dcache_lru_tail = entry;
+    }
+
+    dcache_lru_head = entry;
+}
+
+static void dcache_link(dentry_t *entry)
+{
+    dentry_t **bucket = &dcache_buckets[entry->hash & (DCACHE_BUCKETS - 1)];
+
+    entry->hash_prev = NULL;
+    entry->hash_next = *bucket;
+
+    if (*bucket)
+    {
+        (*bucket)->hash_prev = entry;
+    }
+
+    *bucket = entry;
+
+    entry->node_prev = NULL;
+    entry->node_next = NULL;
+
+    if (entry->node)
+    {
+        uint32_t node_hash =
+            dcache_hash_key(entry->node->device, entry->node->inode);
+
+        bucket = &dcache_node_buckets[node_hash & (DCACHE_BUCKETS - 1)];
+
+        entry->node_next = *bucket;
+
+        if (*bucket)
+        {
+            (*bucket)->node_prev = entry;
+        }
+
+        *bucket = entry;
+    }
+
+    dcache_lru_push(entry);
+
+    ++dcache_stats.entries;
+}
+
+static void dcache_unlink(dentry_t *entry)
+{
+    if (entry->hash_prev)
+    {
+        entry->hash_prev->hash_next = entry->hash_next;
+    }
+    else
+    {
+        dcache_buckets[entry->hash & (DCACHE_BUCKETS - 1)] = entry->hash_next;
+    }
+
+    if (entry->hash_next)
+    {
+        entry->hash_next->hash_prev = entry->hash_prev;
+    }
+
+    if (entry->node)
+    {
+        if (entry->node_prev)
+        {
+            entry->node_prev->node_next = entry->node_next;
+        }
+        else
+        {
+            uint32_t node_hash =
+                dcache_hash_key(entry->node->device, entry->node->inode);
+
+            dcache_node_buckets[node_hash & (DCACHE_BUCKETS - 1)] =
+                entry->node_next;
+        }
+
+        if (entry->node_next)
+        {
+            entry->node_next->node_prev = entry->node_prev;
+        }
+    }
+
+    dcache_lru_unlink(entry);
+
+    --dcache_stats.entries;
+}
+
+static void dcache_free(dentry_t *entry)
+{
+    if (entry->node)
+    {
+        free(entry->node);
+    }
+
+    free(entry->name);
+    free(entry);
+}
+
+static dentry_t *dcache_find(fs_node_t *parent,
+                             uint32_t hash,
+                             const char *name)
+{
+    dentry_t *entry = dcache_buckets[hash & (DCACHE_BUCKETS - 1)];
+
+    while (entry)
+    {
+        if (dcache_match(entry, parent, hash, name))
+        {
+            return entry;
+        }
+
+        entry = entry->hash_next;
+    }
+
+    return NULL;
+}
+
+//=============================================================================
+// Interface functions
+//=============================================================================
+
+fs_node_t *dcache_finddir(fs_node_t *parent, char *name)
+{
+    uint32_t hash = dcache_hash_name(parent->device, parent->inode, name);
+
+    spinlock_lock(&dcache_lock);
+
+    dentry_t *entry = dcache_find(parent, hash, name);
+
+    if (entry)
+    {
+        dcache_lru_unlink(entry);
+        dcache_lru_push(entry);
+
+        fs_node_t *ret = NULL;
+
+        if (entry->node)
+        {
+            ret = malloc(sizeof(fs_node_t));
+
+            if (ret)
+            {
+                memcpy(ret, entry->node, sizeof(fs_node_t));
+            }
+
+            ++dcache_stats.hits;
+        }
+        else
+        {
+            ++dcache_stats.negative_hits;
+        }
+
+        spinlock_unlock(&dcache_lock);
+
+        return ret;
+    }
+
+    ++dcache_stats.misses;
+
+    uint64_t generation = dcache_generation;
+
+    spinlock_unlock(&dcache_lock);
+
+    fs_node_t *node = parent->finddir(parent, name);
+
+    // Build the entry before taking the lock again. If it can not be
+    // allocated, the lookup still succeeds, it is just not cached.
+    dentry_t *new_entry = malloc(sizeof(dentry_t));
+    fs_node_t *copy = node ? malloc(sizeof(fs_node_t)) : NULL;
+    char *name_copy = strdup(name);
+
+    if (!new_entry || !name_copy || (node && !copy))
+    {
+        free(new_entry);
+        free(copy);
+        free(name_copy);
+
+        return node;
+    }
+
+    if (node)
+    {
+        memcpy(copy, node, sizeof(fs_node_t));
+    }
+
+    memset(new_entry, 0, sizeof(dentry_t));
+
+    new_entry->device = parent->device;
+    new_entry->parent = parent->inode;
+    new_entry->finddir = parent->finddir;
+    new_entry->name = name_copy;
+    new_entry->hash = hash;
+    new_entry->node = copy;
+
+    dentry_t *evicted = NULL;
+
+    spinlock_lock(&dcache_lock);
+
+    if (generation != dcache_generation || dcache_find(parent, hash, name))
+    {
+        spinlock_unlock(&dcache_lock);
+
+        dcache_free(new_entry);
+
+        return node;
+    }
+
+    dcache_link(new_entry);
+
+    if (dcache_stats.entries > DCACHE_MAX_ENTRIES)
+    {
+        evicted = dcache_lru_tail;
+
+        dcache_unlink(evicted);
+
+        ++dcache_stats.evictions;
+    }
+
+    spinlock_unlock(&dcache_lock);
+
+    if (evicted)
+    {
+        dcache_free(evicted);
+    }
+
+    return node;
+}
+
+void dcache_invalidate(fs_node_t *parent, const char *name)
+{
+    if (!parent || !name)
+    {
+        return;
+    }
+
+    uint32_t hash = dcache_hash_name(parent->device, parent->inode, name);
+
+    spinlock_lock(&dcache_lock);
+
+    ++dcache_generation;
+
+    dentry_t *entry = dcache_find(parent, hash, name);
+
+    if (entry)
+    {
+        dcache_unlink(entry);
+
+        ++dcache_stats.invalidations;
+    }
+
+    spinlock_unlock(&dcache_lock);
+
+    if (entry)
+    {
+        dcache_free(entry);
+    }
+}
+
+void dcache_invalidate_node(fs_node_t *node)
+{
+    if (!node)
+    {
+        return;
+    }
+
+    uint32_t node_hash = dcache_hash_key(node->device, node->inode);
+
+    dentry_t *dropped = NULL;
+
+    spinlock_lock(&dcache_lock);
+
+    ++dcache_generation;
+
+    dentry_t *entry = dcache_node_buckets[node_hash & (DCACHE_BUCKETS - 1)];
+
+    while (entry)
+    {
+        dentry_t *next = entry->node_next;
+
+        if (entry->node->device == node->device &&
+            entry->node->inode == node->inode)
+        {
+            dcache_unlink(entry);
+
+            // The LRU links are free once unlinked
+            entry->lru_next = dropped;
+            dropped = entry;
+
+            ++dcache_stats.invalidations;
+        }
+
+        entry = next;
+    }
+
+    spinlock_unlock(&dcache_lock);
+
+    while (dropped)
+    {
+        dentry_t *next = dropped->lru_next;
+
+        dcache_free(dropped);
+
+        dropped = next;
+    }
+}
+
+void dcache_invalidate_dir(fs_node_t *dir)
+{
+    if (!dir)
+    {
+        return;
+    }
+
+    dentry_t *dropped = NULL;
+
+    spinlock_lock(&dcache_lock);
+
+    ++dcache_generation;
+
+    dentry_t *entry = dcache_lru_head;
+
+    while (entry)
+    {
+        dentry_t *next = entry->lru_next;
+
+        if (entry->device == dir->device && entry->parent == dir->inode &&
+            entry->finddir == dir->finddir)
+        {
+            dcache_unlink(entry);
+
+            entry->lru_next = dropped;
+            dropped = entry;
+
+            ++dcache_stats.invalidations;
+        }
+
+        entry = next;
+    }
+
+    spinlock_unlock(&dcache_lock);
+
+    while (dropped)
+    {
+        dentry_t *next = dropped->lru_next;
+
+        dcache_free(dropped);
+
+        dropped = next;
+    }
+}
+
+void dcache_flush()
+{
+    spinlock_lock(&dcache_lock);
+
+    ++dcache_generation;
+
+    dentry_t *dropped = dcache_lru_head;
+
+    memset(dcache_buckets, 0, sizeof(dcache_buckets));
+    memset(dcache_node_buckets, 0, sizeof(dcache_node_buckets));
+
+    dcache_lru_head = NULL;
+    dcache_lru_tail = NULL;
+
+    dcache_stats.entries = 0;
+
+    spinlock_unlock(&dcache_lock);
+
+    while (dropped)
+    {
+        dentry_t *next = dropped->lru_next;
+
+        dcache_free(dropped);
+
+        dropped = next;
+    }
+}
+
+void dcache_get_stats(dcache_stats_t *stats)
+{
+    spinlock_lock(&dcache_lock);
+
+    memcpy(stats, &dcache_stats, sizeof(dcache_stats_t));
+
+    spinlock_unlock(&dcache_lock);
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -0,0 +1,536 @@
+/**
+ * @file epoll.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Event polling with kernel side interest lists
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vfs/epoll.h>
+
+#include <arch/arch.h>
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+//=============================================================================
+// Local definitions
+//=============================================================================
+
+// Number of buckets of the watched node hash, a power of two
+#define EPOLL_WATCH_BUCKETS 64
+
+//=============================================================================
+// Local data
+//=============================================================================
+
+// Items of all instances by watched node, used to drop the items of a node
+// when it is closed
+static epoll_item_t *epoll_watches[EPOLL_WATCH_BUCKETS];
+
+//=============================================================================
+// Ready list
+//=============================================================================
+
+// Called with interrupts disabled
+static void epoll_ready_append(epoll_t *ep, epoll_item_t *item)
+{
+    if (item->ready)
+    {
+        return;
+    }
+
+    item->ready = 1;
+    item->ready_next = NULL;
+
+    if (ep->ready_last)
+    {
+        ep->ready_last->ready_next = item;
+    }
+    else
+    {
+        ep->ready_first = item;
+    }
+
+    ep->ready_last = item;
+}
+
+// Called with interrupts disabled
+static void epoll_ready_remove(epoll_t *ep, epoll_item_t *item)
+{
+    if (!item->ready)
+    {
+        return;
+    }
+
+    epoll_item_t *prev = NULL;
+    epoll_item_t *it = ep->ready_first;
+
+    while (it && it != item)
+    {
+        prev = it;
+        it = it->ready_next;
+    }
+
+    if (prev)
+    {
+        prev->ready_next = item->ready_next;
+    }
+    else
+    {
+        ep->ready_first = item->ready_next;
+    }
+
+    if (ep->ready_last == item)
+    {
+        ep->ready_last = prev;
+    }
+
+    item->ready = 0;
+    item->ready_next = NULL;
+}
+
+// Errors and hangups are reported even if not asked for, but not for disabled
+// one-shot items
+static uint32_t epoll_reported(epoll_item_t *item)
+{
+    uint32_t watched = item->events & ~(EPOLLET | EPOLLONESHOT);
+
+    return watched ? watched | EPOLLERR | EPOLLHUP : 0;
+}
+
+static void epoll_notify(poll_entry_t *entry, int events)
+{
+    epoll_item_t *item = (epoll_item_t *)entry->data;
+
+    if (!(events & epoll_reported(item)))
+    {
+        return;
+    }
+
+    epoll_ready_append(item->ep, item);
+    wait_queue_wake_all(&item->ep->waiters);
+}
+
+static void epoll_check_ready(epoll_item_t *item)
+{
+    uint64_t flags = irq_save();
+
+    if (poll_node_events(item->node, item->mode) & epoll_reported(item))
+    {
+        epoll_ready_append(item->ep, item);
+        wait_queue_wake_all(&item->ep->waiters);
+    }
+
+    irq_restore(flags);
+}
+
+// Called with interrupts disabled
+static int epoll_collect(epoll_t *ep, struct epoll_event *events, int maxevents)
+{
+    int count = 0;
+
+    // Level triggered items are appended again, so only walk the items that
+    // were on the list when we started
+    epoll_item_t *item = ep->ready_first;
+
+    ep->ready_first = NULL;
+    ep->ready_last = NULL;
+
+    while (item)
+    {
+        epoll_item_t *next = item->ready_next;
+
+        item->ready = 0;
+        item->ready_next = NULL;
+
+        if (count == maxevents)
+        {
+            epoll_ready_append(ep, item);
+            item = next;
+            continue;
+        }
+
+        uint32_t revents =
+            poll_node_events(item->node, item->mode) & epoll_reported(item);
+
+        if (revents)
+        {
+            events[count].events = revents;
+            events[count].data = item->data;
+            ++count;
+
+            if (item->events & EPOLLONESHOT)
+            {
+                item->events &= EPOLLET | EPOLLONESHOT;
+            }
+            else if (!(item->events & EPOLLET))
+            {
+                epoll_ready_append(ep, item);
+            }
+        }
+
+        item = next;
+    }
+
+    return count;
+}
+
+//=============================================================================
+// Watched nodes
+//=============================================================================
+
+static epoll_item_t **epoll_watch_bucket(fs_node_t *node)
+{
+    // Nodes are heap allocated, the low bits are always the same
+    return &epoll_watches[((uintptr_t)node >> 4) & (EPOLL_WATCH_BUCKETS - 1)];
+}
+
+static void epoll_watch_add(epoll_item_t *item)
+{
+    uint64_t flags = irq_save();
+
+    epoll_item_t **bucket = epoll_watch_bucket(item->node);
+
+    item->watch_prev = NULL;
+    item->watch_next = *bucket;
+
+    if (*bucket)
+    {
+        (*bucket)->watch_prev = item;
+    }
+
+    *bucket = item;
+
+    irq_restore(flags);
+}
+
+// Called with interrupts disabled
+static void epoll_watch_remove(epoll_item_t *item)
+{
+    if (item->watch_prev)
+    {
+        item->watch_prev->watch_next = item->watch_next;
+    }
+    else
+    {
+        *epoll_watch_bucket(item->node) = item->watch_next;
+    }
+
+    if (item->watch_next)
+    {
+        item->watch_next->watch_prev = item->watch_prev;
+    }
+
+    item->watch_prev = NULL;
+    item->watch_next = NULL;
+}
+
+//=============================================================================
+// Items
+//=============================================================================
+
+static epoll_item_t *epoll_find(epoll_t *ep, int fd, fs_node_t *node)
+{
+    for (epoll_item_t *item = ep->items; item; item = item->next)
+    {
+        if (item->fd == fd && item->node == node)
+        {
+            return item;
+        }
+    }
+
+    return NULL;
+}
+
+// Frees an item that has been unlinked from the interest list
+static void epoll_item_free(epoll_t *ep, epoll_item_t *item)
+{
+    poll_head_remove(&item->entry);
+
+    uint64_t flags = irq_save();
+    epoll_ready_remove(ep, item);
+    epoll_watch_remove(item);
+    irq_restore(flags);
+
+    free(item);
+}
+
+static int epoll_add(epoll_t *ep,
+                     int fd,
+                     fs_node_t *target,
+                     int mode,
+                     struct epoll_event *event)
+{
+    if (epoll_find(ep, fd, target))
+    {
+        return -EEXIST;
+    }
+
+    epoll_item_t *item = malloc(sizeof(epoll_item_t));
+
+    if (!item)
+    {
+        return -ENOMEM;
+    }
+
+    memset(item, 0, sizeof(epoll_item_t));
+
+    item->ep = ep;
+    item->fd = fd;
+    item->node = target;
+    item->mode = mode;
+    item->events = event->events;
+    item->data = event->data;
+
+    item->entry.notify = epoll_notify;
+    item->entry.data = item;
+
+    uint64_t flags = irq_save();
+
+    item->next = ep->items;
+    ep->items = item;
+
+    irq_restore(flags);
+
+    epoll_watch_add(item);
+
+    // Nodes that never block have nothing to register, they are found ready
+    // by the check below and stay on the ready list.
+    selectwait_fs(target, &item->entry);
+
+    epoll_check_ready(item);
+
+    return 0;
+}
+
+// Called with interrupts disabled
+static void epoll_unlink(epoll_t *ep, epoll_item_t *item)
+{
+    epoll_item_t **link = &ep->items;
+
+    while (*link != item)
+    {
+        link = &(*link)->next;
+    }
+
+    *link = item->next;
+}
+
+static int epoll_del(epoll_t *ep, int fd, fs_node_t *target)
+{
+    epoll_item_t *item = epoll_find(ep, fd, target);
+
+    if (!item)
+    {
+        return -ENOENT;
+    }
+
+    uint64_t flags = irq_save();
+    epoll_unlink(ep, item);
+    irq_restore(flags);
+
+    epoll_item_free(ep, item);
+
+    return 0;
+}
+
+//=============================================================================
+// VFS operations
+//=============================================================================
+
+static void close_epoll(fs_node_t *node)
+{
+    epoll_t *ep = (epoll_t *)node->device;
+
+    while (ep->items)
+    {
+        uint64_t flags = irq_save();
+
+        epoll_item_t *item = ep->items;
+        ep->items = item->next;
+
+        irq_restore(flags);
+
+        epoll_item_free(ep, item);
+    }
+
+    free(ep);
+    free(node);
+}
+
+//=============================================================================
+// Interface functions
+//=============================================================================
+
+int epoll_create(fs_node_t **node)
+{
+    epoll_t *ep = malloc(sizeof(epoll_t));
+
+    if (!ep)
+    {
+        return -ENOMEM;
+    }
+
+    memset(ep, 0, sizeof(epoll_t));
+
+    wait_queue_init(&ep->waiters);
+
+    fs_node_t *ep_node = malloc(sizeof(fs_node_t));
+
+    if (!ep_node)
+    {
+        free(ep);
+        return -ENOMEM;
+    }
+
+    memset(ep_node, 0, sizeof(fs_node_t));
+
+    strcpy(ep_node->name, "[epoll]");
+
+    ep_node->device = ep;
+    ep_node->flags = FS_FILE;
+    ep_node->permissions = 0600;
+    ep_node->refcount = 1;
+    ep_node->nlink = 1;
+
+    ep_node->close = close_epoll;
+
+    *node = ep_node;
+
+    return 0;
+}
+
+int epoll_is_epoll(fs_node_t *node)
+{
+    return node && node->close == close_epoll;
+}
+
+int epoll_ctl(fs_node_t *epoll,
+              int op,
+              int fd,
+              fs_node_t *target,
+              int mode,
+              struct epoll_event *event)
+{
+    epoll_t *ep = (epoll_t *)epoll->device;
+
+    if (target == epoll)
+    {
+        return -EINVAL;
+    }
+
+    if (op != EPOLL_CTL_DEL && !event)
+    {
+        return -EFAULT;
+    }
+
+    switch (op)
+    {
+    case EPOLL_CTL_ADD:
+        return epoll_add(ep, fd, target, mode, event);
+
+    case EPOLL_CTL_DEL:
+        return epoll_del(ep, fd, target);
+
+    case EPOLL_CTL_MOD:
+    {
+        epoll_item_t *item = epoll_find(ep, fd, target);
+
+        if (!item)
+        {
+            return -ENOENT;
+        }
+
+        item->events = event->events;
+        item->data = event->data;
+
+        epoll_check_ready(item);
+
+        return 0;
+    }
+
+    default:
+        return -EINVAL;
+    }
+}
+
+int epoll_wait(fs_node_t *epoll,
+               struct epoll_event *events,
+               int maxevents,
+               int timeout)
+{
+    epoll_t *ep = (epoll_t *)epoll->device;
+
+    uint64_t flags = irq_save();
+
+    int count = epoll_collect(ep, events, maxevents);
+
+    while (count == 0 && timeout != 0)
+    {
+        if (timeout < 0)
+        {
+            wait_queue_sleep(&ep->waiters);
+        }
+        else if (!wait_queue_sleep_timeout(&ep->waiters, (uint64_t)timeout))
+        {
+            // One last look, the timer may have raced with an event
+            count = epoll_collect(ep, events, maxevents);
+            break;
+        }
+
+        count = epoll_collect(ep, events, maxevents);
+    }
+
+    irq_restore(flags);
+
+    return count;
+}
+
+void epoll_node_closed(fs_node_t *node)
+{
+    while (1)
+    {
+        uint64_t flags = irq_save();
+
+        epoll_item_t *item = *epoll_watch_bucket(node);
+
+        while (item && item->node != node)
+        {
+            item = item->watch_next;
+        }
+
+        if (item)
+        {
+            epoll_unlink(item->ep, item);
+        }
+
+        irq_restore(flags);
+
+        if (!item)
+        {
+            break;
+        }
+
+        epoll_item_free(item->ep, item);
+    }
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
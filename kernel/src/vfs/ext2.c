@@ -23,8 +23,10 @@
 #include <cmos/cmos_rtc.h>
 #include <debug/backtrace.h>
 #include <logging/logging.h>
+#include <process/process.h>
 #include <vfs/ext2.h>
 
+#include <errno.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -52,20 +54,27 @@
 // Block cache
 //=============================================================================
 
-static uint32_t get_cache_time(ext2_fs_t *this);
-static int cache_flush_dirty(ext2_fs_t *this, uint32_t entry);
+static uint32_t cache_flush_batch(ext2_fs_t *this);
+static ext2_disk_cache_entry_t *cache_get(ext2_fs_t *this,
+                                          uint32_t block_no,
+                                          int read);
 
 //=============================================================================
 // Superblock
 //=============================================================================
 
 static int rewrite_superblock(ext2_fs_t *this);
+static void rewrite_block_groups(ext2_fs_t *this);
 
 //=============================================================================
 // Block IO
 //=============================================================================
 
 static int read_block(ext2_fs_t *this, uint32_t block_no, uint8_t *buffer);
+static int read_blocks(ext2_fs_t *this,
+                       uint32_t block_no,
+                       uint32_t count,
+                       uint8_t *buffer);
 static int write_block(ext2_fs_t *this, uint32_t block_no, uint8_t *buffer);
 static int ext2_sync(ext2_fs_t *this);
 static int set_block_number(ext2_fs_t *this,
@@ -76,7 +85,13 @@ static int set_block_number(ext2_fs_t *this,
 static int get_block_number(ext2_fs_t *this,
                             ext2_inodetable_t *inode,
                             uint32_t iblock);
-static int allocate_block(ext2_fs_t *this);
+static uint32_t allocate_blocks(ext2_fs_t *this,
+                                uint32_t goal,
+                                uint32_t count,
+                                uint32_t *allocated);
+static int allocate_block(ext2_fs_t *this, uint32_t goal);
+static void free_blocks(ext2_fs_t *this, uint32_t block_no, uint32_t count);
+static void clear_block(ext2_fs_t *this, uint32_t block_no);
 
 //=============================================================================
 // Inode
@@ -85,6 +100,10 @@ static int allocate_block(ext2_fs_t *this);
 static int write_inode(ext2_fs_t *this,
                        ext2_inodetable_t *inode,
                        uint32_t index);
+static int flush_inode(ext2_fs_t *this,
+                       ext2_inodetable_t *inode,
+                       uint32_t index);
+static void discard_prealloc(ext2_fs_t *this, ext2_inodetable_t *inode);
 static int allocate_inode_block(ext2_fs_t *this,
                                 ext2_inodetable_t *inode,
                                 uint32_t inode_no,
@@ -103,6 +122,12 @@ static void refresh_inode(ext2_fs_t *this,
                           ext2_inodetable_t *inodet,
                           uint32_t inode);
 static ext2_inodetable_t *read_inode(ext2_fs_t *this, uint32_t inode);
+static void release_inode(ext2_fs_t *this, ext2_inodetable_t *inode);
+static uint32_t read_inode_buffer(ext2_fs_t *this,
+                                  ext2_inodetable_t *inode,
+                                  uint64_t offset,
+                                  uint32_t size,
+                                  uint8_t *buffer);
 static uint32_t write_inode_buffer(ext2_fs_t *this,
                                    ext2_inodetable_t *inode,
                                    uint32_t inode_number,
@@ -136,10 +161,27 @@ static uint32_t write_ext2(fs_node_t *node,
                            uint64_t offset,
                            uint32_t size,
                            uint8_t *buffer);
+static uint32_t readv_ext2(fs_node_t *node,
+                           uint64_t offset,
+                           const struct iovec *iov,
+                           int iovcnt);
+static uint32_t writev_ext2(fs_node_t *node,
+                            uint64_t offset,
+                            const struct iovec *iov,
+                            int iovcnt);
+static uint32_t copy_range_ext2(fs_node_t *src,
+                                uint64_t src_offset,
+                                fs_node_t *dst,
+                                uint64_t dst_offset,
+                                uint32_t size);
 static int truncate_ext2(fs_node_t *node);
 static void open_ext2(fs_node_t *node, uint32_t flags);
 static void close_ext2(fs_node_t *node);
 static struct dirent *readdir_ext2(fs_node_t *node, uint32_t index);
+static int getdents_ext2(fs_node_t *node,
+                         uint64_t *cursor,
+                         uint8_t *buffer,
+                         size_t size);
 static int symlink_ext2(fs_node_t *parent, char *target, char *name);
 static int readlink_ext2(fs_node_t *node, char *buffer, size_t size);
 
@@ -150,7 +192,9 @@ static int readlink_ext2(fs_node_t *node, char *buffer, size_t size);
 static uint32_t ext2_root(ext2_fs_t *this,
                           ext2_inodetable_t *inode,
                           fs_node_t *fnode);
-static fs_node_t *mount_ext2(fs_node_t *block_device, int flags);
+static fs_node_t *mount_ext2(fs_node_t *block_device,
+                             int flags,
+                             uint32_t cache_entries);
 
 //=============================================================================
 //=============================================================================
@@ -168,441 +212,684 @@ static fs_node_t *mount_ext2(fs_node_t *block_device, int flags);
 #define BLOCKBYTE(n) (bg_buffer[((n) >> 3)])
 #define SETBIT(n) (1 << (((n) % 8)))
 
+#define INODE_ENTRY(inode) (((ext2_inode_cache_entry_t *)(inode)) - 1)
+#define INODE_DATA(entry) ((ext2_inodetable_t *)((entry) + 1))
+
 #undef _symlink
 #define _symlink(inode) ((char *)(inode)->block)
 
 //=============================================================================
-//=============================================================================
-// Implementation
-//=============================================================================
-//=============================================================================
-
-//=============================================================================
-// Block cache
+// Local data
 //=============================================================================
 
-static uint32_t get_cache_time(ext2_fs_t *this)
-{
-    return this->cache_time++;
-}
+// Mounted file systems
+static ext2_fs_t *ext2_mounts = NULL;
 
-static int cache_flush_dirty(ext2_fs_t *this, uint32_t entry)
-{
-    write_fs(this->block_device,
-             (DC[entry].block_no) * this->block_size,
-             this->block_size,
-             (uint8_t *)(DC[entry].block));
+static int ext2_flusher_started = 0;
 
-    DC[entry].dirty = 0;
+static workqueue_t *ext2_readahead_queue = NULL;
 
-    return 0;
-}
+static ext2_readahead_stats_t ext2_readahead_stats;
 
 //=============================================================================
-// Superblock
 //=============================================================================
-
-static int rewrite_superblock(ext2_fs_t *this)
-{
-    write_fs(
-        this->block_device, 1024, sizeof(ext2_superblock_t), (uint8_t *)SB);
-
-    return 0;
-}
+// Implementation
+//=============================================================================
+//=============================================================================
 
 //=============================================================================
-// Block IO
+// Block cache
 //=============================================================================
 
-static int read_block(ext2_fs_t *this, uint32_t block_no, uint8_t *buffer)
+static void cache_list_remove(ext2_cache_list_t *list,
+                              ext2_disk_cache_entry_t *entry)
 {
-    if (!block_no)
+    if (entry->prev)
     {
-        return -1;
+        entry->prev->next = entry->next;
+    }
+    else
+    {
+        list->head = entry->next;
     }
 
-    spinlock_lock(&this->lock);
-
-    if (!DC)
+    if (entry->next)
     {
-        int ret;
+        entry->next->prev = entry->prev;
+    }
+    else
+    {
+        list->tail = entry->prev;
+    }
 
-        ret = read_fs(this->block_device,
-                      block_no * this->block_size,
-                      this->block_size,
-                      (uint8_t *)buffer);
+    entry->prev = NULL;
+    entry->next = NULL;
 
-        if (ret != 0)
-        {
-            log_error("[EXT2] Error reading block from block device");
-        }
+    list->count--;
+}
 
-        spinlock_unlock(&this->lock);
+static void cache_list_push(ext2_cache_list_t *list,
+                            ext2_disk_cache_entry_t *entry)
+{
+    entry->prev = NULL;
+    entry->next = list->head;
 
-        return ret;
+    if (list->head)
+    {
+        list->head->prev = entry;
+    }
+    else
+    {
+        list->tail = entry;
     }
 
-    int oldest = -1;
+    list->head = entry;
+    list->count++;
+}
 
-    unsigned int oldest_age = UINT32_MAX;
+static void cache_list_append(ext2_cache_list_t *list,
+                              ext2_disk_cache_entry_t *entry)
+{
+    entry->next = NULL;
+    entry->prev = list->tail;
 
-    for (unsigned int i = 0; i < this->cache_entries; ++i)
+    if (list->tail)
     {
-        if (DC[i].block_no == block_no)
-        {
-            DC[i].last_use = get_cache_time(this);
-
-            memcpy(buffer, DC[i].block, this->block_size);
+        list->tail->next = entry;
+    }
+    else
+    {
+        list->head = entry;
+    }
 
-            spinlock_unlock(&this->lock);
+    list->tail = entry;
+    list->count++;
+}
 
-            return 0;
-        }
+static ext2_disk_cache_entry_t **cache_bucket(ext2_fs_t *this,
+                                              uint32_t block_no)
+{
+    return &this->cache_buckets[block_no & (this->cache_bucket_count - 1)];
+}
 
-        if (DC[i].last_use < oldest_age)
-        {
-            oldest = i;
-            oldest_age = DC[i].last_use;
-        }
-    }
+static ext2_disk_cache_entry_t *cache_find(ext2_fs_t *this, uint32_t block_no)
+{
+    ext2_disk_cache_entry_t *entry = *cache_bucket(this, block_no);
 
-    if (DC[oldest].dirty)
+    while (entry && entry->block_no != block_no)
     {
-        cache_flush_dirty(this, oldest);
+        entry = entry->hash_next;
     }
 
-    int ret;
+    return entry;
+}
 
-    ret = read_fs(this->block_device,
-                  block_no * this->block_size,
-                  this->block_size,
-                  (uint8_t *)DC[oldest].block);
+static void cache_hash_remove(ext2_fs_t *this, ext2_disk_cache_entry_t *entry)
+{
+    ext2_disk_cache_entry_t **link = cache_bucket(this, entry->block_no);
 
-    if (ret == 0)
+    while (*link != entry)
     {
-        memcpy(buffer, DC[oldest].block, this->block_size);
-
-        DC[oldest].block_no = block_no;
-        DC[oldest].last_use = get_cache_time(this);
-        DC[oldest].dirty = 0;
+        link = &(*link)->hash_next;
     }
 
-    spinlock_unlock(&this->lock);
+    *link = entry->hash_next;
 
-    return 0;
+    entry->hash_next = NULL;
 }
 
-static int write_block(ext2_fs_t *this, uint32_t block_no, uint8_t *buffer)
+static void cache_mark_dirty(ext2_fs_t *this, ext2_disk_cache_entry_t *entry)
 {
-    if (!block_no)
-    {
-        log_error("[EXT2] Error: Invalid block number");
-        backtrace();
-        return -1;
-    }
-
-    spinlock_unlock(&this->lock);
+    entry->write_seq++;
 
-    if (!DC)
+    if (!entry->dirty)
     {
-        write_fs(this->block_device,
-                 block_no * this->block_size,
-                 this->block_size,
-                 buffer);
+        cache_list_remove(&this->clean, entry);
 
-        spinlock_unlock(&this->lock);
+        entry->dirty = 1;
 
-        return 0;
+        cache_list_append(&this->dirty, entry);
     }
 
-    int oldest = -1;
+    if (this->flusher_running && this->dirty.count >= this->cache_entries / 2)
+    {
+        wait_queue_wake_one(&this->flusher_wait);
+    }
+}
 
-    unsigned int oldest_age = UINT32_MAX;
+typedef struct
+{
+    ext2_disk_cache_entry_t *entry;
+    uint32_t block_no;
+    uint32_t write_seq;
+} cache_flush_item_t;
 
-    for (unsigned int i = 0; i < this->cache_entries; ++i)
-    {
-        if (DC[i].block_no == block_no)
-        {
-            DC[i].last_use = get_cache_time(this);
+/**
+ * @brief Writes back the oldest dirty blocks.
+ *
+ * The batch is sorted by block number, so adjacent blocks are written with a
+ * single request. The blocks are copied to the flush buffer first, so they
+ * may be written again while the batch is written back.
+ *
+ * @return Number of blocks that are clean after the write back.
+ */
+static uint32_t cache_flush_batch(ext2_fs_t *this)
+{
+    cache_flush_item_t items[EXT2_FLUSH_BATCH];
 
-            memcpy(DC[i].block, buffer, this->block_size);
+    spinlock_lock(&this->flush_lock);
+    spinlock_lock(&this->lock);
 
-            spinlock_unlock(&this->lock);
+    uint32_t count = 0;
 
-            return 0;
-        }
+    for (ext2_disk_cache_entry_t *entry = this->dirty.head;
+         entry && count < EXT2_FLUSH_BATCH;
+         entry = entry->next)
+    {
+        uint32_t i = count++;
 
-        if (DC[i].last_use < oldest_age)
+        while (i > 0 && items[i - 1].block_no > entry->block_no)
         {
-            oldest = i;
-            oldest_age = DC[i].last_use;
+            items[i] = items[i - 1];
+            --i;
         }
+
+        items[i].entry = entry;
+        items[i].block_no = entry->block_no;
+        items[i].write_seq = entry->write_seq;
     }
 
-    if (DC[oldest].dirty)
+    for (uint32_t i = 0; i < count; ++i)
     {
-        cache_flush_dirty(this, oldest);
+        memcpy(this->flush_buffer + i * this->block_size,
+               items[i].entry->block,
+               this->block_size);
     }
 
-    memcpy(DC[oldest].block, buffer, this->block_size);
-
-    DC[oldest].block_no = block_no;
-    DC[oldest].last_use = get_cache_time(this);
-    DC[oldest].dirty = 0;
-
     spinlock_unlock(&this->lock);
 
-    return 0;
-}
-
-static int ext2_sync(ext2_fs_t *this)
-{
-    if (!this->disk_cache)
-    {
-        return 0;
-    }
+    uint8_t written[EXT2_FLUSH_BATCH];
 
-    spinlock_lock(&this->lock);
+    uint32_t start = 0;
 
-    for (unsigned int i = 0; i < this->cache_entries; ++i)
+    while (start < count)
     {
-        if (DC[i].dirty)
+        uint32_t end = start + 1;
+
+        while (end < count &&
+               items[end].block_no == items[end - 1].block_no + 1)
         {
-            cache_flush_dirty(this, i);
+            ++end;
         }
-    }
-
-    spinlock_unlock(&this->lock);
-
-    return 0;
-}
-
-static int set_block_number(ext2_fs_t *this,
-                            ext2_inodetable_t *inode,
-                            uint32_t inode_no,
-                            uint32_t iblock,
-                            uint32_t rblock)
-{
-    uint32_t p = this->pointers_per_block;
 
-    uint32_t a;
-    uint32_t b;
-    uint32_t c;
-    uint32_t d;
-    uint32_t e;
-    uint32_t f;
-    uint32_t g;
+        uint32_t ret =
+            write_fs(this->block_device,
+                     (uint64_t)items[start].block_no * this->block_size,
+                     (end - start) * this->block_size,
+                     this->flush_buffer + start * this->block_size);
 
-    uint8_t *tmp;
+        if (ret != 0)
+        {
+            log_error("[EXT2] Error writing blocks %d-%d",
+                      (int64_t)items[start].block_no,
+                      (int64_t)items[end - 1].block_no);
+        }
 
-    if (iblock < EXT2_DIRECT_BLOCKS)
-    {
-        inode->block[iblock] = rblock;
+        for (uint32_t i = start; i < end; ++i)
+        {
+            written[i] = ret == 0;
+        }
 
-        return 0;
+        start = end;
     }
 
-    if (iblock < EXT2_DIRECT_BLOCKS + p)
-    {
-        if (!inode->block[EXT2_DIRECT_BLOCKS])
-        {
-            uint32_t block_no = allocate_block(this);
+    uint32_t cleaned = 0;
 
-            if (!block_no)
-            {
-                log_error("[EXT2] Error: Invalid block number");
-                backtrace();
-                return -1;
-            }
+    spinlock_lock(&this->lock);
 
-            inode->block[EXT2_DIRECT_BLOCKS] = block_no;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        ext2_disk_cache_entry_t *entry = items[i].entry;
 
-            write_inode(this, inode, inode_no);
+        // Blocks written again since they were copied stay dirty
+        if (!written[i] || entry->write_seq != items[i].write_seq)
+        {
+            continue;
         }
 
-        tmp = malloc(this->block_size);
+        cache_list_remove(&this->dirty, entry);
 
-        if (!tmp)
-        {
-            return -1;
-        }
+        entry->dirty = 0;
 
-        read_block(this, inode->block[EXT2_DIRECT_BLOCKS], tmp);
+        cache_list_push(&this->clean, entry);
 
-        ((uint32_t *)tmp)[iblock - EXT2_DIRECT_BLOCKS] = rblock;
+        ++cleaned;
+    }
 
-        write_block(this, inode->block[EXT2_DIRECT_BLOCKS], tmp);
+    spinlock_unlock(&this->lock);
+    spinlock_unlock(&this->flush_lock);
 
-        free(tmp);
+    return cleaned;
+}
 
-        return 1;
-    }
+/**
+ * @brief Gets the cache entry of a block, evicting the least recently used
+ * clean block if it is not cached.
+ *
+ * Must be called with the lock held, which is released while dirty blocks are
+ * written back if there are no clean blocks to evict.
+ *
+ * @param read Nonzero if the block should be read from the disk when it is
+ * not cached.
+ *
+ * @return The entry, or NULL if the block could not be read.
+ */
+static ext2_disk_cache_entry_t *cache_get(ext2_fs_t *this,
+                                          uint32_t block_no,
+                                          int read)
+{
+    ext2_disk_cache_entry_t *entry;
 
-    if (iblock < EXT2_DIRECT_BLOCKS + p + p * p)
+    while (1)
     {
-        a = iblock - EXT2_DIRECT_BLOCKS;
-        b = a - p;
-        c = b / p;
-        d = b - c * p;
+        entry = cache_find(this, block_no);
 
-        if (!inode->block[EXT2_DIRECT_BLOCKS + 1])
+        if (entry)
         {
-            uint32_t block_no = allocate_block(this);
-
-            if (!block_no)
+            if (!entry->dirty)
             {
-                log_error("[EXT2] Error: Invalid block number");
-                backtrace();
-                return -1;
+                cache_list_remove(&this->clean, entry);
+                cache_list_push(&this->clean, entry);
             }
 
-            inode->block[EXT2_DIRECT_BLOCKS + 1] = block_no;
-
-            write_inode(this, inode, inode_no);
+            return entry;
         }
 
-        tmp = malloc(this->block_size);
-
-        if (!tmp)
+        if (this->clean.tail)
         {
-            log_error("[EXT2] Error: Could not allocate memory");
-            backtrace();
-            return -1;
+            break;
         }
 
-        read_block(this, inode->block[EXT2_DIRECT_BLOCKS + 1], (uint8_t *)tmp);
-
-        if (!((uint32_t *)tmp)[c])
-        {
-            uint32_t block_no = allocate_block(this);
+        // Every block is dirty, so write back a batch here instead of
+        // waiting for the flusher.
+        spinlock_unlock(&this->lock);
 
-            if (!block_no)
-            {
-                goto no_space_free;
-            }
+        uint32_t cleaned = cache_flush_batch(this);
 
-            ((uint32_t *)tmp)[c] = block_no;
+        spinlock_lock(&this->lock);
 
-            write_block(
-                this, inode->block[EXT2_DIRECT_BLOCKS + 1], (uint8_t *)tmp);
+        if (!cleaned && !this->clean.tail)
+        {
+            return NULL;
         }
+    }
 
-        uint32_t nblock = ((uint32_t *)tmp)[c];
-        read_block(this, nblock, (uint8_t *)tmp);
-
-        ((uint32_t *)tmp)[d] = rblock;
-        write_block(this, nblock, (uint8_t *)tmp);
+    entry = this->clean.tail;
 
-        free(tmp);
+    if (entry->block_no)
+    {
+        cache_hash_remove(this, entry);
 
-        return 0;
+        entry->block_no = 0;
     }
 
-    if (iblock < EXT2_DIRECT_BLOCKS + p + p * p + p)
+    if (read)
     {
-        a = iblock - EXT2_DIRECT_BLOCKS;
+        int ret = read_fs(this->block_device,
+                          (uint64_t)block_no * this->block_size,
+                          this->block_size,
+                          entry->block);
 
-        b = a - p;
+        if (ret != 0)
+        {
+            log_error("[EXT2] Error reading block from block device");
 
-        c = b - p * p;
+            return NULL;
+        }
+    }
 
-        d = c / (p * p);
+    entry->block_no = block_no;
 
-        e = c - d * p * p;
+    ext2_disk_cache_entry_t **bucket = cache_bucket(this, block_no);
 
-        f = e / p;
+    entry->hash_next = *bucket;
+    *bucket = entry;
 
-        g = e - f * p;
+    cache_list_remove(&this->clean, entry);
+    cache_list_push(&this->clean, entry);
 
-        if (!inode->block[EXT2_DIRECT_BLOCKS + 2])
-        {
-            unsigned int block_no = allocate_block(this);
+    return entry;
+}
 
-            if (!block_no)
-            {
-                log_error("[EXT2] Error: Invalid block number");
-                backtrace();
-                return -1;
-            }
+static int ext2_flusher(void *arg)
+{
+    ext2_fs_t *this = (ext2_fs_t *)arg;
 
-            inode->block[EXT2_DIRECT_BLOCKS + 2] = block_no;
+    while (1)
+    {
+        wait_queue_sleep_timeout(&this->flusher_wait, EXT2_FLUSH_INTERVAL_MS);
 
-            write_inode(this, inode, inode_no);
+        while (cache_flush_batch(this))
+        {
         }
+    }
 
-        tmp = malloc(this->block_size);
+    return 0;
+}
 
-        if (!tmp)
+static void ext2_start_fs_flusher(ext2_fs_t *this)
+{
+    if (!DC || this->flusher_running)
+    {
+        return;
+    }
+
+    if (!kthread_create("[ext2 flush]", ext2_flusher, this))
+    {
+        log_error("[EXT2] Failed to start flusher");
+        return;
+    }
+
+    this->flusher_running = 1;
+}
+
+//=============================================================================
+// Superblock
+//=============================================================================
+
+static int rewrite_superblock(ext2_fs_t *this)
+{
+    write_fs(
+        this->block_device, 1024, sizeof(ext2_superblock_t), (uint8_t *)SB);
+
+    return 0;
+}
+
+static void rewrite_block_groups(ext2_fs_t *this)
+{
+    for (int i = 0; i < this->bgd_block_span; ++i)
+    {
+        write_block(this,
+                    this->bgd_offset + i,
+                    (uint8_t *)((uint64_t)BGD + this->block_size * i));
+    }
+}
+
+//=============================================================================
+// Block map
+//=============================================================================
+
+/**
+ * @brief Maps a logical block in the block map of an inode, or drops the
+ * mapping if @p block_no is 0. Called with the block map lock held.
+ */
+static void block_map_insert(ext2_inode_cache_entry_t *entry,
+                             uint32_t iblock,
+                             uint32_t block_no)
+{
+    if (radix_tree_delete(&entry->block_map, iblock))
+    {
+        entry->block_map_count--;
+    }
+
+    if (!block_no)
+    {
+        return;
+    }
+
+    if (entry->block_map_count >= EXT2_BLOCK_MAP_SIZE)
+    {
+        radix_tree_destroy(&entry->block_map);
+        entry->block_map_count = 0;
+    }
+
+    if (radix_tree_insert(&entry->block_map,
+                          iblock,
+                          (void *)(uintptr_t)block_no) == 0)
+    {
+        entry->block_map_count++;
+    }
+}
+
+/**
+ * @brief Gets the physical block of a logical block beyond the direct
+ * blocks from the block map, or 0 if it is not mapped there.
+ */
+static uint32_t block_map_lookup(ext2_inodetable_t *inode, uint32_t iblock)
+{
+    ext2_inode_cache_entry_t *entry = INODE_ENTRY(inode);
+
+    spinlock_lock(&entry->block_map_lock);
+
+    uint32_t block_no =
+        (uint32_t)(uintptr_t)radix_tree_lookup(&entry->block_map, iblock);
+
+    spinlock_unlock(&entry->block_map_lock);
+
+    return block_no;
+}
+
+/**
+ * @brief Maps all blocks pointed to by an indirect block at once, so that
+ * the indirect chain is walked once per indirect block rather than once per
+ * data block.
+ *
+ * @param first Logical block of the first pointer.
+ * @param pointers Contents of the indirect block.
+ */
+static void block_map_fill(ext2_fs_t *this,
+                           ext2_inodetable_t *inode,
+                           uint32_t first,
+                           uint32_t *pointers)
+{
+    ext2_inode_cache_entry_t *entry = INODE_ENTRY(inode);
+
+    spinlock_lock(&entry->block_map_lock);
+
+    for (uint32_t i = 0; i < this->pointers_per_block; ++i)
+    {
+        if (pointers[i] &&
+            !radix_tree_lookup(&entry->block_map, first + i))
         {
-            log_error("[EXT2] Failed to allocate memory");
-            return -1;
+            block_map_insert(entry, first + i, pointers[i]);
         }
+    }
 
-        read_block(this, inode->block[EXT2_DIRECT_BLOCKS + 2], (uint8_t *)tmp);
+    spinlock_unlock(&entry->block_map_lock);
+}
 
-        if (!((uint32_t *)tmp)[d])
-        {
-            unsigned int block_no = allocate_block(this);
+static void block_map_set(ext2_inodetable_t *inode,
+                          uint32_t iblock,
+                          uint32_t block_no)
+{
+    ext2_inode_cache_entry_t *entry = INODE_ENTRY(inode);
 
-            if (!block_no)
-            {
-                goto no_space_free;
-            }
+    spinlock_lock(&entry->block_map_lock);
 
-            ((uint32_t *)tmp)[d] = block_no;
+    block_map_insert(entry, iblock, block_no);
 
-            write_block(
-                this, inode->block[EXT2_DIRECT_BLOCKS + 2], (uint8_t *)tmp);
+    spinlock_unlock(&entry->block_map_lock);
+}
+
+static void block_map_clear(ext2_inodetable_t *inode)
+{
+    ext2_inode_cache_entry_t *entry = INODE_ENTRY(inode);
+
+    spinlock_lock(&entry->block_map_lock);
+
+    radix_tree_destroy(&entry->block_map);
+    entry->block_map_count = 0;
+
+    spinlock_unlock(&entry->block_map_lock);
+}
+
+//=============================================================================
+// Block IO
+//=============================================================================
+
+static int read_block(ext2_fs_t *this, uint32_t block_no, uint8_t *buffer)
+{
+    if (!block_no)
+    {
+        return -1;
+    }
+
+    spinlock_lock(&this->lock);
+
+    if (!DC)
+    {
+        int ret;
+
+        ret = read_fs(this->block_device,
+                      block_no * this->block_size,
+                      this->block_size,
+                      (uint8_t *)buffer);
+
+        if (ret != 0)
+        {
+            log_error("[EXT2] Error reading block from block device");
         }
 
-        uint32_t nblock = ((uint32_t *)tmp)[d];
+        spinlock_unlock(&this->lock);
 
-        read_block(this, nblock, (uint8_t *)tmp);
+        return ret;
+    }
 
-        if (!((uint32_t *)tmp)[f])
+    ext2_disk_cache_entry_t *entry = cache_get(this, block_no, 1);
+
+    if (!entry)
+    {
+        spinlock_unlock(&this->lock);
+
+        return -1;
+    }
+
+    memcpy(buffer, entry->block, this->block_size);
+
+    spinlock_unlock(&this->lock);
+
+    return 0;
+}
+
+/**
+ * @brief Reads adjacent blocks.
+ *
+ * Runs of blocks that are not in the disk cache are read with a single
+ * request straight into the buffer, and are not added to the cache.
+ */
+static int read_blocks(ext2_fs_t *this,
+                       uint32_t block_no,
+                       uint32_t count,
+                       uint8_t *buffer)
+{
+    if (!block_no)
+    {
+        return -1;
+    }
+
+    spinlock_lock(&this->lock);
+
+    uint32_t i = 0;
+
+    while (i < count)
+    {
+        ext2_disk_cache_entry_t *entry =
+            DC ? cache_find(this, block_no + i) : NULL;
+
+        if (entry)
         {
-            unsigned int block_no = allocate_block(this);
+            memcpy(buffer + i * this->block_size,
+                   entry->block,
+                   this->block_size);
 
-            if (!block_no)
-            {
-                goto no_space_free;
-            }
+            ++i;
 
-            ((uint32_t *)tmp)[f] = block_no;
+            continue;
+        }
 
-            write_block(this, nblock, (uint8_t *)tmp);
+        uint32_t run = 1;
+
+        while (i + run < count &&
+               !(DC && cache_find(this, block_no + i + run)))
+        {
+            ++run;
         }
 
-        nblock = ((uint32_t *)tmp)[f];
+        int ret = read_fs(this->block_device,
+                          (uint64_t)(block_no + i) * this->block_size,
+                          run * this->block_size,
+                          buffer + i * this->block_size);
 
-        read_block(this, nblock, (uint8_t *)tmp);
+        if (ret != 0)
+        {
+            log_error("[EXT2] Error reading blocks from block device");
 
-        ((uint32_t *)tmp)[g] = nblock;
+            spinlock_unlock(&this->lock);
 
-        write_block(this, nblock, (uint8_t *)tmp);
+            return -1;
+        }
 
-        free(tmp);
+        i += run;
+    }
+
+    spinlock_unlock(&this->lock);
+
+    return 0;
+}
+
+static int write_block(ext2_fs_t *this, uint32_t block_no, uint8_t *buffer)
+{
+    if (!block_no)
+    {
+        log_error("[EXT2] Error: Invalid block number");
+        backtrace();
+        return -1;
+    }
+
+    spinlock_lock(&this->lock);
+
+    ext2_disk_cache_entry_t *entry = DC ? cache_get(this, block_no, 0) : NULL;
+
+    if (!entry)
+    {
+        spinlock_unlock(&this->lock);
+
+        write_fs(this->block_device,
+                 block_no * this->block_size,
+                 this->block_size,
+                 buffer);
 
         return 0;
     }
 
-    log_error("[EXT2] Tried to access too high block number");
+    memcpy(entry->block, buffer, this->block_size);
 
-    return -1;
+    cache_mark_dirty(this, entry);
 
-no_space_free:
+    spinlock_unlock(&this->lock);
 
-    log_error("[EXT2] Error: No free space");
-    backtrace();
+    return 0;
+}
 
-    free(tmp);
+static int ext2_sync(ext2_fs_t *this)
+{
+    if (!this->disk_cache)
+    {
+        return 0;
+    }
 
-    return -1;
+    while (cache_flush_batch(this))
+    {
+    }
+
+    return 0;
 }
 
-static int get_block_number(ext2_fs_t *this,
+static int set_block_number(ext2_fs_t *this,
                             ext2_inodetable_t *inode,
-                            uint32_t iblock)
+                            uint32_t inode_no,
+                            uint32_t iblock,
+                            uint32_t rblock)
 {
     uint32_t p = this->pointers_per_block;
 
@@ -618,116 +905,734 @@ static int get_block_number(ext2_fs_t *this,
 
     if (iblock < EXT2_DIRECT_BLOCKS)
     {
-        return inode->block[iblock];
+        inode->block[iblock] = rblock;
+
+        return 0;
     }
-    else if (iblock < EXT2_DIRECT_BLOCKS + p)
-    {
-        tmp = malloc(this->block_size);
 
-        if (!tmp)
+    if (iblock < EXT2_DIRECT_BLOCKS + p)
+    {
+        if (!inode->block[EXT2_DIRECT_BLOCKS])
         {
-            log_error("[EXT2] Error: Could not allocate memory");
-            backtrace();
-            return -1;
-        }
+            uint32_t block_no = allocate_block(this, rblock);
+
+            if (!block_no)
+            {
+                log_error("[EXT2] Error: Invalid block number");
+                backtrace();
+                return -1;
+            }
+
+            inode->block[EXT2_DIRECT_BLOCKS] = block_no;
+
+            write_inode(this, inode, inode_no);
+        }
+
+        tmp = malloc(this->block_size);
+
+        if (!tmp)
+        {
+            return -1;
+        }
+
+        read_block(this, inode->block[EXT2_DIRECT_BLOCKS], tmp);
+
+        ((uint32_t *)tmp)[iblock - EXT2_DIRECT_BLOCKS] = rblock;
+
+        write_block(this, inode->block[EXT2_DIRECT_BLOCKS], tmp);
+
+        free(tmp);
+
+        block_map_set(inode, iblock, rblock);
+
+        return 1;
+    }
+
+    if (iblock < EXT2_DIRECT_BLOCKS + p + p * p)
+    {
+        a = iblock - EXT2_DIRECT_BLOCKS;
+        b = a - p;
+        c = b / p;
+        d = b - c * p;
+
+        if (!inode->block[EXT2_DIRECT_BLOCKS + 1])
+        {
+            uint32_t block_no = allocate_block(this, rblock);
+
+            if (!block_no)
+            {
+                log_error("[EXT2] Error: Invalid block number");
+                backtrace();
+                return -1;
+            }
+
+            inode->block[EXT2_DIRECT_BLOCKS + 1] = block_no;
+
+            write_inode(this, inode, inode_no);
+        }
+
+        tmp = malloc(this->block_size);
+
+        if (!tmp)
+        {
+            log_error("[EXT2] Error: Could not allocate memory");
+            backtrace();
+            return -1;
+        }
+
+        read_block(this, inode->block[EXT2_DIRECT_BLOCKS + 1], (uint8_t *)tmp);
+
+        if (!((uint32_t *)tmp)[c])
+        {
+            uint32_t block_no = allocate_block(this, rblock);
+
+            if (!block_no)
+            {
+                goto no_space_free;
+            }
+
+            ((uint32_t *)tmp)[c] = block_no;
+
+            write_block(
+                this, inode->block[EXT2_DIRECT_BLOCKS + 1], (uint8_t *)tmp);
+        }
+
+        uint32_t nblock = ((uint32_t *)tmp)[c];
+        read_block(this, nblock, (uint8_t *)tmp);
+
+        ((uint32_t *)tmp)[d] = rblock;
+        write_block(this, nblock, (uint8_t *)tmp);
+
+        free(tmp);
+
+        block_map_set(inode, iblock, rblock);
+
+        return 0;
+    }
+
+    if (iblock < EXT2_DIRECT_BLOCKS + p + p * p + p)
+    {
+        a = iblock - EXT2_DIRECT_BLOCKS;
+
+        b = a - p;
+
+        c = b - p * p;
+
+        d = c / (p * p);
+
+        e = c - d * p * p;
+
+        f = e / p;
+
+        g = e - f * p;
+
+        if (!inode->block[EXT2_DIRECT_BLOCKS + 2])
+        {
+            unsigned int block_no = allocate_block(this, rblock);
+
+            if (!block_no)
+            {
+                log_error("[EXT2] Error: Invalid block number");
+                backtrace();
+                return -1;
+            }
+
+            inode->block[EXT2_DIRECT_BLOCKS + 2] = block_no;
+
+            write_inode(this, inode, inode_no);
+        }
+
+        tmp = malloc(this->block_size);
+
+        if (!tmp)
+        {
+            log_error("[EXT2] Failed to allocate memory");
+            return -1;
+        }
+
+        read_block(this, inode->block[EXT2_DIRECT_BLOCKS + 2], (uint8_t *)tmp);
+
+        if (!((uint32_t *)tmp)[d])
+        {
+            unsigned int block_no = allocate_block(this, rblock);
+
+            if (!block_no)
+            {
+                goto no_space_free;
+            }
+
+            ((uint32_t *)tmp)[d] = block_no;
+
+            write_block(
+                this, inode->block[EXT2_DIRECT_BLOCKS + 2], (uint8_t *)tmp);
+        }
+
+        uint32_t nblock = ((uint32_t *)tmp)[d];
+
+        read_block(this, nblock, (uint8_t *)tmp);
+
+        if (!((uint32_t *)tmp)[f])
+        {
+            unsigned int block_no = allocate_block(this, rblock);
+
+            if (!block_no)
+            {
+                goto no_space_free;
+            }
+
+            ((uint32_t *)tmp)[f] = block_no;
+
+            write_block(this, nblock, (uint8_t *)tmp);
+        }
+
+        nblock = ((uint32_t *)tmp)[f];
+
+        read_block(this, nblock, (uint8_t *)tmp);
+
+        ((uint32_t *)tmp)[g] = rblock;
+
+        write_block(this, nblock, (uint8_t *)tmp);
+
+        free(tmp);
+
+        block_map_set(inode, iblock, rblock);
+
+        return 0;
+    }
+
+    log_error("[EXT2] Tried to access too high block number");
+
+    return -1;
+
+no_space_free:
+
+    log_error("[EXT2] Error: No free space");
+    backtrace();
+
+    free(tmp);
+
+    return -1;
+}
+
+static int get_block_number(ext2_fs_t *this,
+                            ext2_inodetable_t *inode,
+                            uint32_t iblock)
+{
+    uint32_t p = this->pointers_per_block;
+
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+    uint32_t d;
+    uint32_t e;
+    uint32_t f;
+    uint32_t g;
+
+    uint8_t *tmp;
+
+    if (iblock < EXT2_DIRECT_BLOCKS)
+    {
+        return inode->block[iblock];
+    }
+
+    uint32_t mapped = block_map_lookup(inode, iblock);
+
+    if (mapped)
+    {
+        return mapped;
+    }
+
+    if (iblock < EXT2_DIRECT_BLOCKS + p)
+    {
+        tmp = malloc(this->block_size);
+
+        if (!tmp)
+        {
+            log_error("[EXT2] Error: Could not allocate memory");
+            backtrace();
+            return -1;
+        }
+
+        read_block(this, inode->block[EXT2_DIRECT_BLOCKS], (uint8_t *)tmp);
+
+        block_map_fill(this, inode, EXT2_DIRECT_BLOCKS, (uint32_t *)tmp);
+
+        uint32_t out = ((uint32_t *)tmp)[iblock - EXT2_DIRECT_BLOCKS];
+
+        free(tmp);
+
+        return out;
+    }
+    else if (iblock < EXT2_DIRECT_BLOCKS + p + p * p)
+    {
+        a = iblock - EXT2_DIRECT_BLOCKS;
+        b = a - p;
+        c = b / p;
+        d = b - c * p;
+
+        tmp = malloc(this->block_size);
+
+        if (!tmp)
+        {
+            log_error("[EXT2] Error: Could not allocate memory");
+            backtrace();
+            return -1;
+        }
+
+        read_block(this, inode->block[EXT2_DIRECT_BLOCKS + 1], (uint8_t *)tmp);
+
+        uint32_t nblock = ((uint32_t *)tmp)[c];
+
+        read_block(this, nblock, (uint8_t *)tmp);
+
+        block_map_fill(this, inode, iblock - d, (uint32_t *)tmp);
+
+        uint32_t out = ((uint32_t *)tmp)[d];
+
+        free(tmp);
+
+        return out;
+    }
+    else if (iblock < EXT2_DIRECT_BLOCKS + p + p * p + p)
+    {
+        a = iblock - EXT2_DIRECT_BLOCKS;
+        b = a - p;
+        c = b - p * p;
+        d = c / (p * p);
+        e = c - d * p * p;
+        f = e / p;
+        g = e - f * p;
+
+        tmp = malloc(this->block_size);
+
+        if (!tmp)
+        {
+            log_error("[EXT2] Error: Could not allocate memory");
+            backtrace();
+            return -1;
+        }
+
+        read_block(this, inode->block[EXT2_DIRECT_BLOCKS + 2], (uint8_t *)tmp);
+
+        uint32_t nblock = ((uint32_t *)tmp)[d];
+
+        read_block(this, nblock, (uint8_t *)tmp);
+
+        nblock = ((uint32_t *)tmp)[f];
+
+        read_block(this, nblock, (uint8_t *)tmp);
+
+        block_map_fill(this, inode, iblock - g, (uint32_t *)tmp);
+
+        uint32_t out = ((uint32_t *)tmp)[g];
+
+        free(tmp);
+
+        return out;
+    }
+
+    log_error("[EXT2] Error: tried to access too high block number");
+    backtrace();
+    return -1;
+}
+
+/**
+ * @brief Allocates a run of up to @p count free blocks, as close after
+ * @p goal as possible.
+ *
+ * The search starts at the goal, continues to the end of its block group and
+ * then wraps around the rest of the disk a group at a time. Groups without
+ * free blocks are skipped without reading their bitmap. The run is extended
+ * for as long as the following blocks of the group are free.
+ *
+ * @param goal Preferred block, 0 for none.
+ * @param allocated Set to the number of blocks in the run, may be NULL.
+ *
+ * @return First block of the run, or 0 if the disk is full.
+ */
+static uint32_t allocate_blocks(ext2_fs_t *this,
+                                uint32_t goal,
+                                uint32_t count,
+                                uint32_t *allocated)
+{
+    uint32_t first_block = SB->first_data_block;
+    uint32_t per_group = SB->blocks_per_group;
+
+    if (goal < first_block || goal >= SB->blocks_count)
+    {
+        goal = first_block;
+    }
+
+    uint32_t goal_group = (goal - first_block) / per_group;
+
+    uint8_t *bg_buffer = malloc(this->block_size);
+
+    if (!bg_buffer)
+    {
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < BGDS; ++i)
+    {
+        uint32_t group = (goal_group + i) % BGDS;
+
+        if (BGD[group].free_blocks_count == 0)
+        {
+            continue;
+        }
+
+        uint32_t group_start = first_block + group * per_group;
+        uint32_t group_blocks = SB->blocks_count - group_start;
+
+        if (group_blocks > per_group)
+        {
+            group_blocks = per_group;
+        }
+
+        uint32_t start = group == goal_group ? goal - group_start : 0;
+        uint32_t block_offset = start;
+
+        read_block(this, BGD[group].block_bitmap, (uint8_t *)bg_buffer);
+
+        while (block_offset < group_blocks && BLOCKBIT(block_offset))
+        {
+            ++block_offset;
+        }
+
+        if (block_offset == group_blocks)
+        {
+            block_offset = 0;
+
+            while (block_offset < start && BLOCKBIT(block_offset))
+            {
+                ++block_offset;
+            }
+
+            if (block_offset == start)
+            {
+                continue;
+            }
+        }
+
+        uint32_t run = 0;
+
+        while (run < count && block_offset + run < group_blocks &&
+               !BLOCKBIT(block_offset + run))
+        {
+            BLOCKBYTE(block_offset + run) |= SETBIT(block_offset + run);
+
+            ++run;
+        }
+
+        write_block(this, BGD[group].block_bitmap, (uint8_t *)bg_buffer);
+
+        free(bg_buffer);
+
+        BGD[group].free_blocks_count -= run;
+        rewrite_block_groups(this);
+
+        SB->free_blocks_count -= run;
+        rewrite_superblock(this);
+
+        if (allocated)
+        {
+            *allocated = run;
+        }
+
+        return group_start + block_offset;
+    }
+
+    free(bg_buffer);
+
+    return 0;
+}
+
+/**
+ * @brief Allocates a single block near @p goal and fills it with zeroes.
+ *
+ * @return The block, or 0 if the disk is full.
+ */
+static int allocate_block(ext2_fs_t *this, uint32_t goal)
+{
+    uint32_t block_no = allocate_blocks(this, goal, 1, NULL);
+
+    if (!block_no)
+    {
+        log_error("[EXT2] Error: No free blocks");
+        backtrace();
+
+        return 0;
+    }
+
+    clear_block(this, block_no);
+
+    return block_no;
+}
+
+/**
+ * @brief Frees a run of blocks within one block group.
+ */
+static void free_blocks(ext2_fs_t *this, uint32_t block_no, uint32_t count)
+{
+    uint32_t group = (block_no - SB->first_data_block) / SB->blocks_per_group;
+    uint32_t block_offset =
+        (block_no - SB->first_data_block) - group * SB->blocks_per_group;
+
+    uint8_t *bg_buffer = malloc(this->block_size);
+
+    if (!bg_buffer)
+    {
+        return;
+    }
+
+    read_block(this, BGD[group].block_bitmap, (uint8_t *)bg_buffer);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        BLOCKBYTE(block_offset + i) &= ~SETBIT(block_offset + i);
+    }
+
+    write_block(this, BGD[group].block_bitmap, (uint8_t *)bg_buffer);
+
+    free(bg_buffer);
+
+    BGD[group].free_blocks_count += count;
+    rewrite_block_groups(this);
+
+    SB->free_blocks_count += count;
+    rewrite_superblock(this);
+}
+
+static void clear_block(ext2_fs_t *this, uint32_t block_no)
+{
+    uint8_t *zero = malloc(this->block_size);
+
+    memset(zero, 0x00, this->block_size);
+
+    write_block(this, block_no, zero);
+
+    free(zero);
+}
+
+//=============================================================================
+// Inode
+//=============================================================================
+
+static int write_inode(ext2_fs_t *this,
+                       ext2_inodetable_t *inode,
+                       uint32_t index)
+{
+    (void)this;
+    (void)index;
+
+    // Written back by release_inode, once for all the changes made while the
+    // inode was held.
+    __atomic_store_n(&INODE_ENTRY(inode)->dirty, 1, __ATOMIC_RELAXED);
+
+    return 0;
+}
+
+static int flush_inode(ext2_fs_t *this,
+                       ext2_inodetable_t *inode,
+                       uint32_t index)
+{
+    uint32_t group = index / this->inodes_per_group;
+
+    if (group > BGDS)
+    {
+        log_error("[EXT2] Group too high\n");
+        return -1;
+    }
+
+    uint32_t inode_table_block = BGD[group].inode_table;
+
+    index -= group * this->inodes_per_group;
+
+    uint32_t block_offset = ((index - 1) * this->inode_size) / this->block_size;
+    uint32_t offset_in_block =
+        (index - 1) - block_offset * (this->block_size / this->inode_size);
+
+    ext2_inodetable_t *inodet = malloc(this->block_size);
+
+    read_block(this, inode_table_block + block_offset, (uint8_t *)inodet);
+
+    memcpy((uint8_t *)((uint64_t)inodet + offset_in_block * this->inode_size),
+           inode,
+           this->inode_size);
+
+    write_block(this, inode_table_block + block_offset, (uint8_t *)inodet);
+
+    free(inodet);
+
+    return 0;
+}
+
+/**
+ * @brief Frees the blocks preallocated for an inode and not used.
+ */
+static void discard_prealloc(ext2_fs_t *this, ext2_inodetable_t *inode)
+{
+    ext2_inode_cache_entry_t *entry = INODE_ENTRY(inode);
+
+    if (entry->prealloc_count)
+    {
+        free_blocks(this, entry->prealloc_block, entry->prealloc_count);
+
+        entry->prealloc_count = 0;
+    }
+}
+
+/**
+ * @brief Allocates the block following the last one of an inode.
+ *
+ * The block is placed right after the previous block of the file, or at the
+ * start of the block group of the inode for the first block. Regular files
+ * allocate EXT2_PREALLOC_BLOCKS more blocks after it, which are handed out
+ * to the following appends so that the file stays contiguous even when
+ * other files grow at the same time.
+ */
+static int allocate_inode_block(ext2_fs_t *this,
+                                ext2_inodetable_t *inode,
+                                uint32_t inode_no,
+                                uint32_t block)
+{
+    ext2_inode_cache_entry_t *entry = INODE_ENTRY(inode);
 
-        read_block(this, inode->block[EXT2_DIRECT_BLOCKS], (uint8_t *)tmp);
+    uint32_t goal = SB->first_data_block +
+                    ((inode_no - 1) / this->inodes_per_group) *
+                        SB->blocks_per_group;
 
-        uint32_t out = ((uint32_t *)tmp)[iblock - EXT2_DIRECT_BLOCKS];
+    if (block > 0)
+    {
+        uint32_t previous = get_block_number(this, inode, block - 1);
 
-        free(tmp);
+        if (previous)
+        {
+            goal = previous + 1;
+        }
+    }
 
-        return out;
+    uint32_t block_no;
+
+    if (entry->prealloc_count && entry->prealloc_block == goal)
+    {
+        block_no = entry->prealloc_block++;
+        entry->prealloc_count--;
     }
-    else if (iblock < EXT2_DIRECT_BLOCKS + p + p * p)
+    else
     {
-        a = iblock - EXT2_DIRECT_BLOCKS;
-        b = a - p;
-        c = b / p;
-        d = b - c * p;
+        discard_prealloc(this, inode);
 
-        tmp = malloc(this->block_size);
+        uint32_t count = 1;
+        uint32_t allocated = 0;
 
-        if (!tmp)
+        if ((inode->mode & EXT2_S_IFREG) == EXT2_S_IFREG)
         {
-            log_error("[EXT2] Error: Could not allocate memory");
-            backtrace();
-            return -1;
+            count += EXT2_PREALLOC_BLOCKS;
         }
 
-        read_block(this, inode->block[EXT2_DIRECT_BLOCKS + 1], (uint8_t *)tmp);
+        block_no = allocate_blocks(this, goal, count, &allocated);
 
-        uint32_t nblock = ((uint32_t *)tmp)[c];
+        if (block_no && allocated > 1)
+        {
+            entry->prealloc_block = block_no + 1;
+            entry->prealloc_count = allocated - 1;
+        }
+    }
 
-        read_block(this, nblock, (uint8_t *)tmp);
+    if (!block_no)
+    {
+        log_error("[EXT2] Error: Could not allocate block");
+        backtrace();
+        return -1;
+    }
 
-        uint32_t out = ((uint32_t *)tmp)[d];
+    clear_block(this, block_no);
 
-        free(tmp);
+    set_block_number(this, inode, inode_no, block, block_no);
 
-        return out;
-    }
-    else if (iblock < EXT2_DIRECT_BLOCKS + p + p * p + p)
+    uint32_t t = (block + 1) * (this->block_size / 512);
+
+    if (inode->blocks < t)
     {
-        a = iblock - EXT2_DIRECT_BLOCKS;
-        b = a - p;
-        c = b - p * p;
-        d = c / (p * p);
-        e = c - d * p * p;
-        f = e / p;
-        g = e - f * p;
+        inode->blocks = t;
+    }
 
-        tmp = malloc(this->block_size);
+    write_inode(this, inode, inode_no);
 
-        if (!tmp)
-        {
-            log_error("[EXT2] Error: Could not allocate memory");
-            backtrace();
-            return -1;
-        }
+    return 0;
+}
 
-        read_block(this, inode->block[EXT2_DIRECT_BLOCKS + 2], (uint8_t *)tmp);
+static uint32_t inode_read_block(ext2_fs_t *this,
+                                 ext2_inodetable_t *inode,
+                                 uint32_t block,
+                                 uint8_t *buffer)
+{
+    if (block >= inode->blocks / (this->block_size / 512))
+    {
+        memset(buffer, 0x00, this->block_size);
+        return 0;
+    }
 
-        uint32_t nblock = ((uint32_t *)tmp)[d];
+    unsigned int real_block = get_block_number(this, inode, block);
 
-        read_block(this, nblock, (uint8_t *)tmp);
+    read_block(this, real_block, buffer);
 
-        nblock = ((uint32_t *)tmp)[f];
+    return real_block;
+}
 
-        read_block(this, nblock, (uint8_t *)tmp);
+static uint32_t inode_write_block(ext2_fs_t *this,
+                                  ext2_inodetable_t *inode,
+                                  uint32_t inode_no,
+                                  uint32_t block,
+                                  uint8_t *buffer)
+{
+    if (block >= inode->blocks / (this->block_size / 512))
+    {
+        log_warn(
+            "[EXT2] Error: attempting to write beyond the allocated nodes for "
+            "this inode");
+    }
 
-        uint32_t out = ((uint32_t *)tmp)[g];
+    char *empty = NULL;
 
-        free(tmp);
+    while (block >= inode->blocks / (this->block_size / 512))
+    {
+        allocate_inode_block(
+            this, inode, inode_no, inode->blocks / (this->block_size / 512));
+    }
 
-        return out;
+    if (empty)
+    {
+        free(empty);
     }
 
-    log_error("[EXT2] Error: tried to access too high block number");
-    backtrace();
-    return -1;
+    unsigned int real_block = get_block_number(this, inode, block);
+
+    write_block(this, real_block, buffer);
+
+    return real_block;
 }
 
-static int allocate_block(ext2_fs_t *this)
+static uint32_t allocate_inode(ext2_fs_t *this)
 {
-    uint32_t block_no = 0;
-    uint32_t block_offset = 0;
+    uint32_t node_no = 0;
+    uint32_t node_offset = 0;
     uint32_t group = 0;
-
     uint8_t *bg_buffer = malloc(this->block_size);
 
     for (uint32_t i = 0; i < BGDS; ++i)
     {
-        if (BGD[i].free_blocks_count > 0)
+        if (BGD[i].free_inodes_count > 0)
         {
-            read_block(this, BGD[i].block_bitmap, (uint8_t *)bg_buffer);
+            read_block(this, BGD[i].inode_bitmap, (uint8_t *)bg_buffer);
 
-            while (BLOCKBIT(block_offset))
+            while (BLOCKBIT(node_offset))
             {
-                ++block_offset;
+                node_offset++;
             }
 
-            block_no = block_offset + SB->blocks_per_group * i;
+            node_no = node_offset + i * this->inodes_per_group + 1;
 
             group = i;
 
@@ -735,20 +1640,20 @@ static int allocate_block(ext2_fs_t *this)
         }
     }
 
-    if (!block_no)
+    if (!node_no)
     {
-        log_error("[EXT2] Error: Invalid block number");
+        log_error("[EXT2] Error: Invalid node_no");
         backtrace();
-        free(bg_buffer);
-
         return -1;
     }
 
-    BLOCKBYTE(block_offset) |= SETBIT(block_offset);
+    BLOCKBYTE(node_offset) |= SETBIT(node_offset);
 
-    write_block(this, BGD[group].block_bitmap, (uint8_t *)bg_buffer);
+    write_block(this, BGD[group].inode_bitmap, (uint8_t *)bg_buffer);
 
-    BGD[group].free_blocks_count--;
+    free(bg_buffer);
+
+    BGD[group].free_inodes_count--;
 
     for (int i = 0; i < this->bgd_block_span; ++i)
     {
@@ -757,248 +1662,380 @@ static int allocate_block(ext2_fs_t *this)
                     (uint8_t *)((uint64_t)BGD + this->block_size * i));
     }
 
-    SB->free_blocks_count--;
-    rewrite_superblock(this);
-
-    memset(bg_buffer, 0x00, this->block_size);
-
-    write_block(this, block_no, bg_buffer);
+    SB->free_inodes_count--;
 
-    free(bg_buffer);
+    rewrite_superblock(this);
 
-    return block_no;
+    return node_no;
 }
 
-//=============================================================================
-// Inode
-//=============================================================================
-
-static int write_inode(ext2_fs_t *this,
-                       ext2_inodetable_t *inode,
-                       uint32_t index)
+static void refresh_inode(ext2_fs_t *this,
+                          ext2_inodetable_t *inodet,
+                          uint32_t inode)
 {
-    uint32_t group = index / this->inodes_per_group;
+    if (this->inodes_per_group == 0)
+    {
+        log_error("[EXT2] Inodes per group zero");
+        return;
+    }
+
+    if (this->block_size == 0)
+    {
+        log_error("[EXT2] Block size zero");
+        return;
+    }
+
+    uint32_t group = inode / this->inodes_per_group;
 
     if (group > BGDS)
     {
-        log_error("[EXT2] Group too high\n");
-        return -1;
+        log_error("[EXT2] Error: Invalid group");
+        backtrace();
+        return;
     }
 
     uint32_t inode_table_block = BGD[group].inode_table;
 
-    index -= group * this->inodes_per_group;
+    inode -= group * this->inodes_per_group;
 
-    uint32_t block_offset = ((index - 1) * this->inode_size) / this->block_size;
+    uint32_t block_offset = ((inode - 1) * this->inode_size) / this->block_size;
     uint32_t offset_in_block =
-        (index - 1) - block_offset * (this->block_size / this->inode_size);
+        (inode - 1) - block_offset * (this->block_size / this->inode_size);
 
-    ext2_inodetable_t *inodet = malloc(this->block_size);
+    uint8_t *buf = malloc(this->block_size);
 
-    read_block(this, inode_table_block + block_offset, (uint8_t *)inodet);
+    memset(buf, 0, this->block_size);
 
-    memcpy((uint8_t *)((uint64_t)inodet + offset_in_block * this->inode_size),
-           inode,
+    read_block(this, inode_table_block + block_offset, buf);
+
+    ext2_inodetable_t *inodes = (ext2_inodetable_t *)buf;
+
+    memcpy(inodet,
+           (uint8_t *)((uint64_t)inodes + offset_in_block * this->inode_size),
            this->inode_size);
 
-    write_block(this, inode_table_block + block_offset, (uint8_t *)inodet);
+    free(buf);
+}
 
-    free(inodet);
+//=============================================================================
+// Inode cache
+//=============================================================================
 
-    return 0;
+static ext2_inode_cache_entry_t **inode_cache_bucket(ext2_fs_t *this,
+                                                     uint32_t inode)
+{
+    return &this->inode_cache[inode & (EXT2_INODE_CACHE_BUCKETS - 1)];
 }
 
-static int allocate_inode_block(ext2_fs_t *this,
-                                ext2_inodetable_t *inode,
-                                uint32_t inode_no,
-                                uint32_t block)
+static ext2_inode_cache_entry_t *inode_cache_find(ext2_fs_t *this,
+                                                  uint32_t inode)
 {
-    uint32_t block_no = allocate_block(this);
+    ext2_inode_cache_entry_t *entry = *inode_cache_bucket(this, inode);
 
-    if (!block_no)
+    while (entry && entry->inode_no != inode)
     {
-        log_error("[EXT2] Error: Could not allocate block");
-        backtrace();
-        return -1;
+        entry = entry->hash_next;
     }
 
-    set_block_number(this, inode, inode_no, block, block_no);
+    return entry;
+}
 
-    uint32_t t = (block + 1) * (this->block_size / 512);
+static void inode_cache_lru_remove(ext2_fs_t *this,
+                                   ext2_inode_cache_entry_t *entry)
+{
+    if (entry->lru_prev)
+    {
+        entry->lru_prev->lru_next = entry->lru_next;
+    }
+    else
+    {
+        this->inode_lru_head = entry->lru_next;
+    }
 
-    if (inode->blocks < t)
+    if (entry->lru_next)
     {
-        inode->blocks = t;
+        entry->lru_next->lru_prev = entry->lru_prev;
+    }
+    else
+    {
+        this->inode_lru_tail = entry->lru_prev;
     }
 
-    write_inode(this, inode, inode_no);
+    entry->lru_prev = NULL;
+    entry->lru_next = NULL;
 
-    return 0;
+    this->inode_cache_unused--;
 }
 
-static uint32_t inode_read_block(ext2_fs_t *this,
-                                 ext2_inodetable_t *inode,
-                                 uint32_t block,
-                                 uint8_t *buffer)
+static void inode_cache_lru_push(ext2_fs_t *this,
+                                 ext2_inode_cache_entry_t *entry)
 {
-    if (block >= inode->blocks / (this->block_size / 512))
+    entry->lru_prev = NULL;
+    entry->lru_next = this->inode_lru_head;
+
+    if (this->inode_lru_head)
     {
-        memset(buffer, 0x00, this->block_size);
-        return 0;
+        this->inode_lru_head->lru_prev = entry;
+    }
+    else
+    {
+        this->inode_lru_tail = entry;
+    }
+
+    this->inode_lru_head = entry;
+
+    this->inode_cache_unused++;
+}
+
+static void inode_cache_remove(ext2_fs_t *this,
+                               ext2_inode_cache_entry_t *entry)
+{
+    ext2_inode_cache_entry_t **link = inode_cache_bucket(this, entry->inode_no);
+
+    while (*link != entry)
+    {
+        link = &(*link)->hash_next;
+    }
+
+    *link = entry->hash_next;
+
+    inode_cache_lru_remove(this, entry);
+}
+
+/**
+ * @brief Gets the cached copy of an inode, reading it from the disk if it is
+ * not cached.
+ *
+ * Every caller shares the same copy. It must be released with release_inode
+ * and not freed.
+ */
+static ext2_inodetable_t *read_inode(ext2_fs_t *this, uint32_t inode)
+{
+    spinlock_lock(&this->inode_lock);
+
+    ext2_inode_cache_entry_t *entry = inode_cache_find(this, inode);
+
+    if (entry)
+    {
+        if (entry->refcount++ == 0)
+        {
+            inode_cache_lru_remove(this, entry);
+        }
+
+        spinlock_unlock(&this->inode_lock);
+
+        return INODE_DATA(entry);
     }
 
-    unsigned int real_block = get_block_number(this, inode, block);
+    spinlock_unlock(&this->inode_lock);
 
-    read_block(this, real_block, buffer);
+    ext2_inode_cache_entry_t *new_entry =
+        malloc(sizeof(ext2_inode_cache_entry_t) + this->inode_size);
 
-    return real_block;
-}
+    memset(new_entry, 0, sizeof(ext2_inode_cache_entry_t));
 
-static uint32_t inode_write_block(ext2_fs_t *this,
-                                  ext2_inodetable_t *inode,
-                                  uint32_t inode_no,
-                                  uint32_t block,
-                                  uint8_t *buffer)
-{
-    if (block >= inode->blocks / (this->block_size / 512))
-    {
-        log_warn(
-            "[EXT2] Error: attempting to write beyond the allocated nodes for "
-            "this inode");
-    }
+    new_entry->inode_no = inode;
+    new_entry->refcount = 1;
 
-    char *empty = NULL;
+    page_cache_init(&new_entry->pages);
 
-    while (block >= inode->blocks / (this->block_size / 512))
-    {
-        allocate_inode_block(
-            this, inode, inode_no, inode->blocks / (this->block_size / 512));
+    radix_tree_init(&new_entry->block_map);
+    spinlock_init(&new_entry->block_map_lock);
 
-        refresh_inode(this, inode, inode_no);
-    }
+    refresh_inode(this, INODE_DATA(new_entry), inode);
 
-    if (empty)
+    spinlock_lock(&this->inode_lock);
+
+    // Someone else may have read the inode while the lock was not held
+    entry = inode_cache_find(this, inode);
+
+    if (entry)
     {
-        free(empty);
+        if (entry->refcount++ == 0)
+        {
+            inode_cache_lru_remove(this, entry);
+        }
+
+        spinlock_unlock(&this->inode_lock);
+
+        free(new_entry);
+
+        return INODE_DATA(entry);
     }
 
-    unsigned int real_block = get_block_number(this, inode, block);
+    ext2_inode_cache_entry_t **bucket = inode_cache_bucket(this, inode);
 
-    write_block(this, real_block, buffer);
+    new_entry->hash_next = *bucket;
+    *bucket = new_entry;
 
-    return real_block;
+    spinlock_unlock(&this->inode_lock);
+
+    return INODE_DATA(new_entry);
 }
 
-static uint32_t allocate_inode(ext2_fs_t *this)
+/**
+ * @brief Releases an inode gotten from read_inode.
+ *
+ * The last reference writes the inode back if it is dirty, so unreferenced
+ * entries are always clean and can be evicted without touching the disk.
+ */
+static void release_inode(ext2_fs_t *this, ext2_inodetable_t *inode)
 {
-    uint32_t node_no = 0;
-    uint32_t node_offset = 0;
-    uint32_t group = 0;
-    uint8_t *bg_buffer = malloc(this->block_size);
+    ext2_inode_cache_entry_t *entry = INODE_ENTRY(inode);
+    ext2_inode_cache_entry_t *evicted = NULL;
 
-    for (uint32_t i = 0; i < BGDS; ++i)
+    spinlock_lock(&this->inode_lock);
+
+    while (entry->refcount == 1 && entry->dirty)
     {
-        if (BGD[i].free_inodes_count > 0)
-        {
-            read_block(this, BGD[i].inode_bitmap, (uint8_t *)bg_buffer);
+        entry->dirty = 0;
 
-            while (BLOCKBIT(node_offset))
-            {
-                node_offset++;
-            }
+        spinlock_unlock(&this->inode_lock);
 
-            node_no = node_offset + i * this->inodes_per_group + 1;
+        flush_inode(this, inode, entry->inode_no);
 
-            group = i;
+        spinlock_lock(&this->inode_lock);
+    }
 
-            break;
+    if (--entry->refcount == 0)
+    {
+        inode_cache_lru_push(this, entry);
+
+        if (this->inode_cache_unused > EXT2_INODE_CACHE_SIZE)
+        {
+            evicted = this->inode_lru_tail;
+
+            inode_cache_remove(this, evicted);
         }
     }
 
-    if (!node_no)
+    spinlock_unlock(&this->inode_lock);
+
+    if (evicted)
     {
-        log_error("[EXT2] Error: Invalid node_no");
-        backtrace();
-        return -1;
+        discard_prealloc(this, INODE_DATA(evicted));
+        page_cache_destroy(&evicted->pages);
+        radix_tree_destroy(&evicted->block_map);
+        free(evicted);
     }
+}
 
-    BLOCKBYTE(node_offset) |= SETBIT(node_offset);
-
-    write_block(this, BGD[group].inode_bitmap, (uint8_t *)bg_buffer);
+typedef struct
+{
+    ext2_fs_t *this;
+    ext2_inodetable_t *inode;
+} inode_page_t;
+
+static int fill_inode_page(void *arg,
+                           uint64_t index,
+                           uint32_t count,
+                           uint8_t *pages)
+{
+    inode_page_t *ctx = (inode_page_t *)arg;
+    ext2_fs_t *this = ctx->this;
 
-    free(bg_buffer);
+    if (this->block_size > PAGE_SIZE)
+    {
+        uint8_t *buf = malloc(this->block_size);
 
-    BGD[group].free_inodes_count--;
+        if (!buf)
+        {
+            return -1;
+        }
 
-    for (int i = 0; i < this->bgd_block_span; ++i)
-    {
-        write_block(this,
-                    this->bgd_offset + i,
-                    (uint8_t *)((uint64_t)BGD + this->block_size * i));
-    }
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            uint64_t offset = (index + i) * PAGE_SIZE;
 
-    SB->free_inodes_count--;
+            inode_read_block(this, ctx->inode, offset / this->block_size, buf);
 
-    rewrite_superblock(this);
+            memcpy(pages + i * PAGE_SIZE,
+                   buf + offset % this->block_size,
+                   PAGE_SIZE);
+        }
 
-    return node_no;
-}
+        free(buf);
 
-static void refresh_inode(ext2_fs_t *this,
-                          ext2_inodetable_t *inodet,
-                          uint32_t inode)
-{
-    if (this->inodes_per_group == 0)
-    {
-        log_error("[EXT2] Inodes per group zero");
-        return;
+        return 0;
     }
 
-    if (this->block_size == 0)
-    {
-        log_error("[EXT2] Block size zero");
-        return;
-    }
+    uint32_t per_page = PAGE_SIZE / this->block_size;
+    uint32_t first = index * per_page;
+    uint32_t blocks = count * per_page;
+    uint32_t allocated = ctx->inode->blocks / (this->block_size / 512);
 
-    uint32_t group = inode / this->inodes_per_group;
+    // Blocks that follow each other on the disk are read with one request,
+    // straight into the pages
+    uint32_t i = 0;
 
-    if (group > BGDS)
+    while (i < blocks)
     {
-        log_error("[EXT2] Error: Invalid group");
-        backtrace();
-        return;
-    }
+        uint8_t *dest = pages + i * this->block_size;
 
-    uint32_t inode_table_block = BGD[group].inode_table;
+        uint32_t real_block =
+            first + i < allocated
+                ? (uint32_t)get_block_number(this, ctx->inode, first + i)
+                : 0;
 
-    inode -= group * this->inodes_per_group;
+        if (!real_block)
+        {
+            memset(dest, 0, this->block_size);
 
-    uint32_t block_offset = ((inode - 1) * this->inode_size) / this->block_size;
-    uint32_t offset_in_block =
-        (inode - 1) - block_offset * (this->block_size / this->inode_size);
+            ++i;
 
-    uint8_t *buf = malloc(this->block_size);
+            continue;
+        }
 
-    memset(buf, 0, this->block_size);
+        uint32_t run = 1;
 
-    read_block(this, inode_table_block + block_offset, buf);
+        while (i + run < blocks && first + i + run < allocated &&
+               (uint32_t)get_block_number(this, ctx->inode, first + i + run) ==
+                   real_block + run)
+        {
+            ++run;
+        }
 
-    ext2_inodetable_t *inodes = (ext2_inodetable_t *)buf;
+        if (read_blocks(this, real_block, run, dest) != 0)
+        {
+            return -1;
+        }
 
-    memcpy(inodet,
-           (uint8_t *)((uint64_t)inodes + offset_in_block * this->inode_size),
-           this->inode_size);
+        i += run;
+    }
 
-    free(buf);
+    return 0;
 }
 
-static ext2_inodetable_t *read_inode(ext2_fs_t *this, uint32_t inode)
+static uint32_t read_inode_buffer(ext2_fs_t *this,
+                                  ext2_inodetable_t *inode,
+                                  uint64_t offset,
+                                  uint32_t size,
+                                  uint8_t *buffer)
 {
-    ext2_inodetable_t *inodet = malloc(this->inode_size);
+    if (offset >= inode->size || size == 0)
+    {
+        return 0;
+    }
+
+    if (offset + size > inode->size)
+    {
+        size = inode->size - offset;
+    }
 
-    refresh_inode(this, inodet, inode);
+    if (this->block_size == 0)
+    {
+        log_error("[EXT2] Invalid block size");
+        return 0;
+    }
+
+    inode_page_t ctx = {this, inode};
 
-    return inodet;
+    return page_cache_read(&INODE_ENTRY(inode)->pages,
+                           offset,
+                           size,
+                           buffer,
+                           fill_inode_page,
+                           &ctx);
 }
 
 static uint32_t write_inode_buffer(ext2_fs_t *this,
@@ -1011,13 +2048,6 @@ static uint32_t write_inode_buffer(ext2_fs_t *this,
 {
     uint32_t end = offset + size;
 
-    if (end > inode->size)
-    {
-        inode->size = end;
-
-        write_inode(this, inode, inode_number);
-    }
-
     uint32_t start_block = offset / this->block_size;
     uint32_t end_block = end / this->block_size;
     uint32_t end_size = end - end_block * this->block_size;
@@ -1046,7 +2076,7 @@ static uint32_t write_inode_buffer(ext2_fs_t *this,
         {
             if (block_offset == start_block)
             {
-                int b = inode_read_block(this, inode, block_offset, buf);
+                inode_read_block(this, inode, block_offset, buf);
 
                 memcpy((uint8_t *)(((uint64_t)buf) +
                                    ((uintptr_t)offset % this->block_size)),
@@ -1054,27 +2084,16 @@ static uint32_t write_inode_buffer(ext2_fs_t *this,
                        this->block_size - (offset % this->block_size));
 
                 inode_write_block(this, inode, inode_number, block_offset, buf);
-
-                if (!b)
-                {
-                    refresh_inode(this, inode, inode_number);
-                }
             }
             else
             {
-                int b = inode_read_block(this, inode, block_offset, buf);
-
+                // Overwritten completely, so there is nothing to read first
                 memcpy(buf,
                        buffer + this->block_size * blocks_read -
                            (offset % this->block_size),
                        this->block_size);
 
                 inode_write_block(this, inode, inode_number, block_offset, buf);
-
-                if (!b)
-                {
-                    refresh_inode(this, inode, inode_number);
-                }
             }
         }
 
@@ -1092,6 +2111,17 @@ static uint32_t write_inode_buffer(ext2_fs_t *this,
     }
     free(buf);
 
+    page_cache_write(&INODE_ENTRY(inode)->pages, offset, size, buffer);
+
+    // Only grow the file once the data is there, so that readers never fill
+    // the cache from blocks that are still being written.
+    if (end > inode->size)
+    {
+        inode->size = end;
+
+        write_inode(this, inode, inode_number);
+    }
+
     return size_to_read;
 }
 
@@ -1105,7 +2135,7 @@ static int create_entry(fs_node_t *parent, char *name, uint32_t inode)
     {
         log_error("[EXT2] Error: Invalid name");
         backtrace();
-        free(pinode);
+        release_inode(this, pinode);
         return -1;
     }
 
@@ -1174,6 +2204,8 @@ static int create_entry(fs_node_t *parent, char *name, uint32_t inode)
     {
         log_error("[EXT2] Error: Not modify or replace");
         backtrace();
+        free(block);
+        release_inode(this, pinode);
         return -1;
     }
 
@@ -1184,6 +2216,7 @@ static int create_entry(fs_node_t *parent, char *name, uint32_t inode)
             log_error("[EXT2] Error: Access outside block size");
             backtrace();
             free(block);
+            release_inode(this, pinode);
             return -1;
         }
         else
@@ -1209,7 +2242,7 @@ static int create_entry(fs_node_t *parent, char *name, uint32_t inode)
     inode_write_block(this, pinode, parent->inode, block_nr, block);
 
     free(block);
-    free(pinode);
+    release_inode(this, pinode);
 
     return 0;
 }
@@ -1244,6 +2277,9 @@ static uint32_t node_from_file(fs_node_t *this,
         fnode->flags |= FS_FILE;
         fnode->read = read_ext2;
         fnode->write = write_ext2;
+        fnode->readv = readv_ext2;
+        fnode->writev = writev_ext2;
+        fnode->copy_range = copy_range_ext2;
         fnode->create = NULL;
         fnode->mkdir = NULL;
         fnode->readdir = NULL;
@@ -1259,6 +2295,7 @@ static uint32_t node_from_file(fs_node_t *this,
         fnode->create = create_ext2;
         fnode->mkdir = mkdir_ext2;
         fnode->readdir = readdir_ext2;
+        fnode->getdents = getdents_ext2;
         fnode->finddir = finddir_ext2;
         fnode->unlink = unlink_ext2;
         fnode->write = NULL;
@@ -1273,36 +2310,166 @@ static uint32_t node_from_file(fs_node_t *this,
 
     if ((inode->mode & EXT2_S_IFCHR) == EXT2_S_IFCHR)
     {
-        fnode->flags |= FS_CHARDEVICE;
+        fnode->flags |= FS_CHARDEVICE;
+    }
+
+    if ((inode->mode & EXT2_S_IFIFO) == EXT2_S_IFIFO)
+    {
+        fnode->flags |= FS_PIPE;
+    }
+
+    if ((inode->mode & EXT2_S_IFLNK) == EXT2_S_IFLNK)
+    {
+        fnode->flags |= FS_SYMLINK;
+        fnode->read = NULL;
+        fnode->write = NULL;
+        fnode->create = NULL;
+        fnode->mkdir = NULL;
+        fnode->readdir = NULL;
+        fnode->finddir = NULL;
+        fnode->readlink = readlink_ext2;
+    }
+
+    fnode->atime = inode->atime;
+    fnode->mtime = inode->mtime;
+    fnode->ctime = inode->ctime;
+
+    fnode->chmod = chmod_ext2;
+    fnode->open = open_ext2;
+    fnode->close = close_ext2;
+    fnode->ioctl = NULL;
+
+    return 1;
+}
+
+//=============================================================================
+// Readahead
+//=============================================================================
+
+static void ext2_readahead_put(ext2_readahead_t *ra)
+{
+    spinlock_lock(&ra->lock);
+
+    uint32_t refs = --ra->refs;
+
+    spinlock_unlock(&ra->lock);
+
+    if (!refs)
+    {
+        free(ra);
+    }
+}
+
+static void ext2_readahead_work(void *arg)
+{
+    ext2_readahead_t *ra = (ext2_readahead_t *)arg;
+    ext2_fs_t *this = ra->fs;
+
+    spinlock_lock(&ra->lock);
+
+    uint64_t offset = ra->work_offset;
+    uint32_t size = ra->work_size;
+
+    spinlock_unlock(&ra->lock);
+
+    ext2_inodetable_t *inode = read_inode(this, ra->inode);
+
+    if (offset < inode->size)
+    {
+        if (offset + size > inode->size)
+        {
+            size = inode->size - offset;
+        }
+
+        inode_page_t ctx = {this, inode};
+
+        page_cache_prefetch(
+            &INODE_ENTRY(inode)->pages, offset, size, fill_inode_page, &ctx);
+    }
+
+    release_inode(this, inode);
+
+    ext2_readahead_put(ra);
+}
+
+/**
+ * @brief Accounts a read of an open file, queueing the next readahead window
+ * if the reader is sequential and has reached the last one.
+ */
+static void ext2_readahead(fs_node_t *node, uint64_t offset, uint32_t size)
+{
+    ext2_readahead_t *ra = (ext2_readahead_t *)node->private_data;
+
+    if (!ra || !ext2_readahead_queue || !size)
+    {
+        return;
+    }
+
+    spinlock_lock(&ra->lock);
+
+    uint64_t end = offset + size;
+
+    if (offset != ra->next_offset)
+    {
+        ra->next_offset = end;
+        ra->window = 0;
+
+        spinlock_unlock(&ra->lock);
+
+        __atomic_add_fetch(&ext2_readahead_stats.random, 1, __ATOMIC_RELAXED);
+
+        return;
+    }
+
+    __atomic_add_fetch(&ext2_readahead_stats.sequential, 1, __ATOMIC_RELAXED);
+
+    ra->next_offset = end;
+
+    uint64_t start;
+    uint32_t window;
+
+    if (!ra->window)
+    {
+        start = end;
+        window = EXT2_READAHEAD_MIN;
+    }
+    else if (end > ra->window_start)
+    {
+        start = ra->window_start + ra->window;
+        window = ra->window * 2 < EXT2_READAHEAD_MAX ? ra->window * 2
+                                                     : EXT2_READAHEAD_MAX;
+
+        if (start < end)
+        {
+            start = end;
+        }
+    }
+    else
+    {
+        spinlock_unlock(&ra->lock);
+
+        return;
     }
 
-    if ((inode->mode & EXT2_S_IFIFO) == EXT2_S_IFIFO)
+    ra->work_offset = start;
+    ra->work_size = window;
+    ra->refs++;
+
+    // While the previous window is still being read the state is left as is,
+    // so that the next read tries again.
+    if (workqueue_queue(ext2_readahead_queue, &ra->work))
     {
-        fnode->flags |= FS_PIPE;
-    }
+        ra->window_start = start;
+        ra->window = window;
 
-    if ((inode->mode & EXT2_S_IFLNK) == EXT2_S_IFLNK)
+        __atomic_add_fetch(&ext2_readahead_stats.windows, 1, __ATOMIC_RELAXED);
+    }
+    else
     {
-        fnode->flags |= FS_SYMLINK;
-        fnode->read = NULL;
-        fnode->write = NULL;
-        fnode->create = NULL;
-        fnode->mkdir = NULL;
-        fnode->readdir = NULL;
-        fnode->finddir = NULL;
-        fnode->readlink = readlink_ext2;
+        ra->refs--;
     }
 
-    fnode->atime = inode->atime;
-    fnode->mtime = inode->mtime;
-    fnode->ctime = inode->ctime;
-
-    fnode->chmod = chmod_ext2;
-    fnode->open = open_ext2;
-    fnode->close = close_ext2;
-    fnode->ioctl = NULL;
-
-    return 1;
+    spinlock_unlock(&ra->lock);
 }
 
 //=============================================================================
@@ -1343,6 +2510,7 @@ static int mkdir_ext2(fs_node_t *parent, char *name, uint16_t permission)
     inode->dtime = 0;
 
     memset(inode->block, 0, sizeof(inode->block));
+    block_map_clear(inode);
 
     inode->blocks = 0;
     inode->size = 0;
@@ -1393,7 +2561,7 @@ static int mkdir_ext2(fs_node_t *parent, char *name, uint16_t permission)
 
     inode_write_block(this, inode, inode_no, 0, tmp);
 
-    free(inode);
+    release_inode(this, inode);
     free(tmp);
 
     ext2_inodetable_t *pinode = read_inode(this, parent->inode);
@@ -1402,7 +2570,7 @@ static int mkdir_ext2(fs_node_t *parent, char *name, uint16_t permission)
 
     write_inode(this, pinode, parent->inode);
 
-    free(pinode);
+    release_inode(this, pinode);
 
     uint32_t group = inode_no / this->inodes_per_group;
 
@@ -1459,6 +2627,7 @@ static int create_ext2(fs_node_t *parent, char *name, uint16_t permission)
     inode->dtime = 0;
 
     memset(inode->block, 0x00, sizeof(inode->block));
+    block_map_clear(inode);
     inode->blocks = 0;
     inode->size = 0;
 
@@ -1483,7 +2652,7 @@ static int create_ext2(fs_node_t *parent, char *name, uint16_t permission)
 
     create_entry(parent, name, inode_no);
 
-    free(inode);
+    release_inode(this, inode);
 
     ext2_sync(this);
 
@@ -1500,9 +2669,9 @@ static int chmod_ext2(fs_node_t *parent, int mode)
 
     write_inode(this, inode, parent->inode);
 
-    ext2_sync(this);
+    release_inode(this, inode);
 
-    free(inode);
+    ext2_sync(this);
 
     return 0;
 }
@@ -1607,7 +2776,7 @@ static fs_node_t *finddir_ext2(fs_node_t *node, char *name)
         total_offset += d_ent->rec_len;
     }
 
-    free(inode);
+    release_inode(this, inode);
 
     if (!direntry)
     {
@@ -1625,11 +2794,13 @@ static fs_node_t *finddir_ext2(fs_node_t *node, char *name)
     {
         log_error("[EXT2] Could not get node from file");
 
+        release_inode(this, inode);
+
         return 0;
     }
 
     free(direntry);
-    free(inode);
+    release_inode(this, inode);
     free(block);
 
     return outnode;
@@ -1687,10 +2858,9 @@ static int unlink_ext2(fs_node_t *node, char *name)
         total_offset += d_ent->rec_len;
     }
 
-    free(inode);
-
     if (!direntry)
     {
+        release_inode(this, inode);
         free(block);
         return -1;
     }
@@ -1699,6 +2869,7 @@ static int unlink_ext2(fs_node_t *node, char *name)
 
     inode_write_block(this, inode, node->inode, block_nr, block);
 
+    release_inode(this, inode);
     free(block);
 
     ext2_sync(this);
@@ -1713,106 +2884,162 @@ static uint32_t read_ext2(fs_node_t *node,
 {
     ext2_fs_t *this = (ext2_fs_t *)node->device;
 
+    ext2_readahead(node, offset, size);
+
     ext2_inodetable_t *inode = read_inode(this, node->inode);
 
-    uint32_t end;
+    uint32_t rv = read_inode_buffer(this, inode, offset, size, buffer);
 
-    if (inode->size == 0)
-    {
-        free(inode);
-        return 0;
-    }
+    release_inode(this, inode);
 
-    if (offset + size > inode->size)
-    {
-        end = inode->size;
-    }
-    else
-    {
-        end = offset + size;
-    }
+    return rv;
+}
 
-    if (this->block_size == 0)
+static uint32_t write_ext2(fs_node_t *node,
+                           uint64_t offset,
+                           uint32_t size,
+                           uint8_t *buffer)
+{
+    ext2_fs_t *this = (ext2_fs_t *)node->device;
+
+    ext2_inodetable_t *inode = read_inode(this, node->inode);
+
+    uint32_t rv =
+        write_inode_buffer(this, inode, node->inode, offset, size, buffer);
+
+    release_inode(this, inode);
+
+    return rv;
+}
+
+static uint32_t readv_ext2(fs_node_t *node,
+                           uint64_t offset,
+                           const struct iovec *iov,
+                           int iovcnt)
+{
+    ext2_fs_t *this = (ext2_fs_t *)node->device;
+
+    uint32_t total = 0;
+
+    for (int i = 0; i < iovcnt; ++i)
     {
-        free(inode);
-        log_error("[EXT2] Invalid block size");
-        return 0;
+        total += iov[i].iov_len;
     }
 
-    uint32_t start_block = offset / this->block_size;
-    uint32_t end_block = end / this->block_size;
-    uint32_t end_size = end - end_block * this->block_size;
-    uint32_t size_to_read = end - offset;
+    ext2_readahead(node, offset, total);
 
-    uint8_t *buf = malloc(this->block_size);
+    // The inode is only read once for the whole vector
+    ext2_inodetable_t *inode = read_inode(this, node->inode);
 
-    if (start_block == end_block)
-    {
-        inode_read_block(this, inode, start_block, buf);
+    total = 0;
 
-        memcpy(buffer,
-               (uint8_t *)(((uint64_t)buf) +
-                           ((uintptr_t)offset % this->block_size)),
-               size_to_read);
-    }
-    else
+    for (int i = 0; i < iovcnt; ++i)
     {
-        uint32_t block_offset;
-        uint32_t blocks_read = 0;
+        uint32_t rv = read_inode_buffer(this,
+                                        inode,
+                                        offset + total,
+                                        iov[i].iov_len,
+                                        (uint8_t *)iov[i].iov_base);
 
-        for (block_offset = start_block; block_offset < end_block;
-             block_offset++, blocks_read++)
+        total += rv;
+
+        if (rv < iov[i].iov_len)
         {
-            if (block_offset == start_block)
-            {
-                inode_read_block(this, inode, block_offset, buf);
+            break;
+        }
+    }
 
-                memcpy(buffer,
-                       (uint8_t *)(((uint64_t)buf) +
-                                   ((uintptr_t)offset % this->block_size)),
-                       this->block_size - (offset % this->block_size));
-            }
-            else
-            {
-                inode_read_block(this, inode, block_offset, buf);
+    release_inode(this, inode);
 
-                memcpy(buffer + this->block_size * blocks_read -
-                           (offset % this->block_size),
-                       buf,
-                       this->block_size);
-            }
-        }
-        if (end_size)
+    return total;
+}
+
+static uint32_t writev_ext2(fs_node_t *node,
+                            uint64_t offset,
+                            const struct iovec *iov,
+                            int iovcnt)
+{
+    ext2_fs_t *this = (ext2_fs_t *)node->device;
+
+    ext2_inodetable_t *inode = read_inode(this, node->inode);
+
+    uint32_t total = 0;
+
+    for (int i = 0; i < iovcnt; ++i)
+    {
+        if (iov[i].iov_len == 0)
         {
-            inode_read_block(this, inode, end_block, buf);
+            continue;
+        }
 
-            memcpy(buffer + this->block_size * blocks_read -
-                       (offset % this->block_size),
-                   buf,
-                   end_size);
+        // write_inode_buffer keeps the inode up to date as the file grows
+        uint32_t rv = write_inode_buffer(this,
+                                         inode,
+                                         node->inode,
+                                         offset + total,
+                                         iov[i].iov_len,
+                                         (uint8_t *)iov[i].iov_base);
+
+        total += rv;
+
+        if (rv < iov[i].iov_len)
+        {
+            break;
         }
     }
 
-    free(inode);
-    free(buf);
-    return size_to_read;
+    release_inode(this, inode);
+
+    return total;
 }
 
-static uint32_t write_ext2(fs_node_t *node,
-                           uint64_t offset,
-                           uint32_t size,
-                           uint8_t *buffer)
+static uint32_t copy_range_ext2(fs_node_t *src,
+                                uint64_t src_offset,
+                                fs_node_t *dst,
+                                uint64_t dst_offset,
+                                uint32_t size)
 {
-    ext2_fs_t *this = (ext2_fs_t *)node->device;
+    ext2_fs_t *this = (ext2_fs_t *)src->device;
 
-    ext2_inodetable_t *inode = read_inode(this, node->inode);
+    // ext2 has no way to share blocks between files, so the data is copied
+    // through the block cache, reading both inodes once for the whole copy.
+    ext2_inodetable_t *src_inode = read_inode(this, src->inode);
+    ext2_inodetable_t *dst_inode = read_inode(this, dst->inode);
 
-    uint32_t rv =
-        write_inode_buffer(this, inode, node->inode, offset, size, buffer);
+    uint32_t chunk = this->block_size * 16;
 
-    free(inode);
+    uint8_t *buffer = malloc(chunk);
 
-    return rv;
+    uint32_t total = 0;
+
+    while (total < size)
+    {
+        uint32_t count = size - total < chunk ? size - total : chunk;
+
+        uint32_t in = read_inode_buffer(
+            this, src_inode, src_offset + total, count, buffer);
+
+        if (in == 0)
+        {
+            break;
+        }
+
+        uint32_t out = write_inode_buffer(
+            this, dst_inode, dst->inode, dst_offset + total, in, buffer);
+
+        total += out;
+
+        if (out < in || in < count)
+        {
+            break;
+        }
+    }
+
+    free(buffer);
+    release_inode(this, dst_inode);
+    release_inode(this, src_inode);
+
+    return total;
 }
 
 static int truncate_ext2(fs_node_t *node)
@@ -1825,20 +3052,60 @@ static int truncate_ext2(fs_node_t *node)
 
     write_inode(this, inode, node->inode);
 
-    free(inode);
+    page_cache_truncate(&INODE_ENTRY(inode)->pages, 0);
+    block_map_clear(inode);
+    discard_prealloc(this, inode);
+
+    release_inode(this, inode);
 
     return 0;
 }
 
 static void open_ext2(fs_node_t *node, uint32_t flags)
 {
-    (void)node;
     (void)flags;
+
+    if (!(node->flags & FS_FILE) || node->private_data)
+    {
+        return;
+    }
+
+    ext2_readahead_t *ra = malloc(sizeof(ext2_readahead_t));
+
+    if (!ra)
+    {
+        return;
+    }
+
+    memset(ra, 0, sizeof(ext2_readahead_t));
+
+    ra->fs = (ext2_fs_t *)node->device;
+    ra->inode = node->inode;
+    ra->refs = 1;
+
+    spinlock_init(&ra->lock);
+    work_init(&ra->work, ext2_readahead_work, ra);
+
+    node->private_data = ra;
 }
 
 static void close_ext2(fs_node_t *node)
 {
-    (void)node;
+    ext2_readahead_t *ra = (ext2_readahead_t *)node->private_data;
+
+    if (ra)
+    {
+        node->private_data = NULL;
+
+        ext2_readahead_put(ra);
+
+        ext2_fs_t *this = (ext2_fs_t *)node->device;
+        ext2_inodetable_t *inode = read_inode(this, node->inode);
+
+        discard_prealloc(this, inode);
+
+        release_inode(this, inode);
+    }
 }
 
 static struct dirent *readdir_ext2(fs_node_t *node, uint32_t index)
@@ -1851,7 +3118,7 @@ static struct dirent *readdir_ext2(fs_node_t *node, uint32_t index)
 
     if (!direntry)
     {
-        free(inode);
+        release_inode(this, inode);
         return NULL;
     }
 
@@ -1863,11 +3130,103 @@ static struct dirent *readdir_ext2(fs_node_t *node, uint32_t index)
     dirent->ino = direntry->inode;
 
     free(direntry);
-    free(inode);
+    release_inode(this, inode);
 
     return dirent;
 }
 
+static uint8_t dirent_type_ext2(uint8_t file_type)
+{
+    // Only set when the file system has the filetype feature
+    switch (file_type)
+    {
+    case 1:
+        return DT_REG;
+    case 2:
+        return DT_DIR;
+    case 3:
+        return DT_CHR;
+    case 4:
+        return DT_BLK;
+    case 5:
+        return DT_FIFO;
+    case 6:
+        return DT_SOCK;
+    case 7:
+        return DT_LNK;
+    default:
+        return DT_UNKNOWN;
+    }
+}
+
+static int getdents_ext2(fs_node_t *node,
+                         uint64_t *cursor,
+                         uint8_t *buffer,
+                         size_t size)
+{
+    ext2_fs_t *this = (ext2_fs_t *)node->device;
+
+    ext2_inodetable_t *inode = read_inode(this, node->inode);
+
+    uint8_t *block = malloc(this->block_size);
+
+    // The cursor is the byte offset of the next entry in the directory, so
+    // every block is only read once while listing the directory.
+    uint64_t offset = *cursor;
+    uint32_t current_block = (uint32_t)-1;
+
+    size_t used = 0;
+    int full = 0;
+
+    while (offset < inode->size)
+    {
+        uint32_t block_nr = offset / this->block_size;
+
+        if (block_nr != current_block)
+        {
+            inode_read_block(this, inode, block_nr, block);
+            current_block = block_nr;
+        }
+
+        ext2_dir_t *d_ent =
+            (ext2_dir_t *)((uintptr_t)block + offset % this->block_size);
+
+        if (d_ent->rec_len == 0)
+        {
+            log_error("[EXT2] getdents: Corrupt entry in inode %d",
+                      node->inode);
+            break;
+        }
+
+        if (d_ent->inode &&
+            !vfs_dirent_emit(buffer,
+                             size,
+                             &used,
+                             d_ent->inode,
+                             dirent_type_ext2(d_ent->file_type),
+                             d_ent->name,
+                             d_ent->name_len))
+        {
+            full = 1;
+            break;
+        }
+
+        offset += d_ent->rec_len;
+    }
+
+    *cursor = offset;
+
+    free(block);
+    release_inode(this, inode);
+
+    if (full && used == 0)
+    {
+        return -EINVAL;
+    }
+
+    return (int)used;
+}
+
 static int symlink_ext2(fs_node_t *parent, char *target, char *name)
 {
     if (!name)
@@ -1901,6 +3260,7 @@ static int symlink_ext2(fs_node_t *parent, char *target, char *name)
     inode->dtime = 0;
 
     memset(inode->block, 0x00, sizeof(inode->block));
+    block_map_clear(inode);
     inode->blocks = 0;
     inode->size = 0;
 
@@ -1942,7 +3302,7 @@ static int symlink_ext2(fs_node_t *parent, char *target, char *name)
             parent->device, inode, inode_no, 0, target_len, (uint8_t *)target);
     }
 
-    free(inode);
+    release_inode(this, inode);
 
     ext2_sync(this);
 
@@ -1971,7 +3331,7 @@ static int readlink_ext2(fs_node_t *node, char *buffer, size_t size)
         buffer[read_size] = '\0';
     }
 
-    free(inode);
+    release_inode(this, inode);
 
     return read_size;
 }
@@ -2052,6 +3412,7 @@ static uint32_t ext2_root(ext2_fs_t *this,
     fnode->open = open_ext2;
     fnode->close = close_ext2;
     fnode->readdir = readdir_ext2;
+    fnode->getdents = getdents_ext2;
     fnode->finddir = finddir_ext2;
     fnode->ioctl = NULL;
     fnode->create = create_ext2;
@@ -2061,7 +3422,17 @@ static uint32_t ext2_root(ext2_fs_t *this,
     return 0;
 }
 
-static fs_node_t *mount_ext2(fs_node_t *block_device, int flags)
+/**
+ * @brief Mounts an ext2 file system.
+ *
+ * @param block_device Device holding the file system.
+ * @param flags EXT2_FLAG_* flags.
+ * @param cache_entries Number of blocks in the disk cache, or 0 for the
+ * default.
+ */
+static fs_node_t *mount_ext2(fs_node_t *block_device,
+                             int flags,
+                             uint32_t cache_entries)
 {
     ext2_fs_t *this = malloc(sizeof(ext2_fs_t));
 
@@ -2092,11 +3463,16 @@ static fs_node_t *mount_ext2(fs_node_t *block_device, int flags)
 
     this->block_size = 1024 << SB->log_block_size;
 
-    this->cache_entries = 1024;
+    this->cache_entries = cache_entries;
 
-    if (this->block_size > 2048)
+    if (!this->cache_entries)
     {
-        this->cache_entries /= 4;
+        this->cache_entries = EXT2_CACHE_ENTRIES;
+
+        if (this->block_size > 2048)
+        {
+            this->cache_entries /= 4;
+        }
     }
 
     this->pointers_per_block = this->block_size / 4;
@@ -2135,13 +3511,40 @@ static fs_node_t *mount_ext2(fs_node_t *block_device, int flags)
 
         memset(this->cache_data, 0, this->block_size * this->cache_entries);
 
+        this->cache_bucket_count = 1;
+
+        while (this->cache_bucket_count < this->cache_entries)
+        {
+            this->cache_bucket_count <<= 1;
+        }
+
+        this->cache_buckets = malloc(sizeof(ext2_disk_cache_entry_t *) *
+                                     this->cache_bucket_count);
+
+        this->flush_buffer = malloc(this->block_size * EXT2_FLUSH_BATCH);
+
+        if (!this->cache_buckets || !this->flush_buffer)
+        {
+            log_error("[EXT2] Could not allocate cache index");
+
+            for (;;)
+                ;
+        }
+
+        memset(this->cache_buckets,
+               0,
+               sizeof(ext2_disk_cache_entry_t *) * this->cache_bucket_count);
+
+        memset(DC, 0, sizeof(ext2_disk_cache_entry_t) * this->cache_entries);
+
         for (uint32_t i = 0; i < this->cache_entries; ++i)
         {
-            DC[i].block_no = 0;
-            DC[i].dirty = 0;
-            DC[i].last_use = 0;
             DC[i].block = this->cache_data + i * this->block_size;
+
+            cache_list_append(&this->clean, &DC[i]);
         }
+
+        wait_queue_init(&this->flusher_wait);
     }
     else
     {
@@ -2170,14 +3573,26 @@ static fs_node_t *mount_ext2(fs_node_t *block_device, int flags)
     ext2_inodetable_t *root_inode = read_inode(this, 2);
 
     RN = (fs_node_t *)malloc(sizeof(fs_node_t));
+    memset(RN, 0, sizeof(fs_node_t));
 
     if (ext2_root(this, root_inode, RN))
     {
         log_error("[EXT2] mount_ext2: ext2_root returned non-zero");
+        release_inode(this, root_inode);
         free(RN);
         return NULL;
     }
 
+    release_inode(this, root_inode);
+
+    this->next = ext2_mounts;
+    ext2_mounts = this;
+
+    if (ext2_flusher_started)
+    {
+        ext2_start_fs_flusher(this);
+    }
+
     return RN;
 }
 
@@ -2204,11 +3619,11 @@ int ext2_initialize()
         return -1;
     }
 
-    int flags = EXT2_FLAG_NOCACHE;
+    int flags = 0;
 
     log_info("[EXT2] Mounting \"%s\" at \"%s\"", devicePath, mountPath);
 
-    fs_node_t *fs = mount_ext2(dev, flags);
+    fs_node_t *fs = mount_ext2(dev, flags, EXT2_CACHE_ENTRIES);
 
     if (!fs)
     {
@@ -2223,8 +3638,45 @@ int ext2_initialize()
     return 0;
 }
 
+void ext2_start_flusher()
+{
+    ext2_readahead_queue = workqueue_create("[ext2 readahead]");
+
+    ext2_flusher_started = 1;
+
+    for (ext2_fs_t *this = ext2_mounts; this; this = this->next)
+    {
+        ext2_start_fs_flusher(this);
+    }
+}
+
+void ext2_readahead_get_stats(ext2_readahead_stats_t *stats)
+{
+    stats->sequential =
+        __atomic_load_n(&ext2_readahead_stats.sequential, __ATOMIC_RELAXED);
+    stats->random =
+        __atomic_load_n(&ext2_readahead_stats.random, __ATOMIC_RELAXED);
+    stats->windows =
+        __atomic_load_n(&ext2_readahead_stats.windows, __ATOMIC_RELAXED);
+}
+
 int ext2_finalize()
 {
+    for (ext2_fs_t *this = ext2_mounts; this; this = this->next)
+    {
+        for (uint32_t i = 0; i < EXT2_INODE_CACHE_BUCKETS; ++i)
+        {
+            ext2_inode_cache_entry_t *entry = this->inode_cache[i];
+
+            for (; entry; entry = entry->hash_next)
+            {
+                discard_prealloc(this, INODE_DATA(entry));
+            }
+        }
+
+        ext2_sync(this);
+    }
+
     return 0;
 }
 
@@ -0,0 +1,569 @@
+/**
+ * @file pipe.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Anonymous pipes
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vfs/pipe.h>
+
+#include <arch/arch.h>
+#include <logging/logging.h>
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+//=============================================================================
+// End locks
+//=============================================================================
+
+static void pipe_lock_end(volatile uint8_t *locked, wait_queue_t *wait)
+{
+    uint64_t flags = irq_save();
+
+    while (*locked)
+    {
+        wait_queue_sleep(wait);
+    }
+
+    *locked = 1;
+
+    irq_restore(flags);
+}
+
+static void pipe_unlock_end(volatile uint8_t *locked, wait_queue_t *wait)
+{
+    uint64_t flags = irq_save();
+
+    *locked = 0;
+
+    wait_queue_wake_one(wait);
+
+    irq_restore(flags);
+}
+
+static void pipe_lock_read(pipe_t *pipe)
+{
+    pipe_lock_end(&pipe->read_locked, &pipe->read_lock_wait);
+}
+
+static void pipe_unlock_read(pipe_t *pipe)
+{
+    pipe_unlock_end(&pipe->read_locked, &pipe->read_lock_wait);
+}
+
+static void pipe_lock_write(pipe_t *pipe)
+{
+    pipe_lock_end(&pipe->write_locked, &pipe->write_lock_wait);
+}
+
+static void pipe_unlock_write(pipe_t *pipe)
+{
+    pipe_unlock_end(&pipe->write_locked, &pipe->write_lock_wait);
+}
+
+//=============================================================================
+// Ring buffer
+//=============================================================================
+
+static int pipe_wait_writable(pipe_t *pipe)
+{
+    uint64_t flags = irq_save();
+
+    while (!pipe->read_closed && pipe->head - pipe->tail == pipe->size)
+    {
+        wait_queue_sleep(&pipe->writers);
+    }
+
+    irq_restore(flags);
+
+    return pipe->read_closed ? -EPIPE : 0;
+}
+
+static int pipe_wait_readable(pipe_t *pipe)
+{
+    uint64_t flags = irq_save();
+
+    while (!pipe->write_closed && pipe->head == pipe->tail)
+    {
+        wait_queue_sleep(&pipe->readers);
+    }
+
+    irq_restore(flags);
+
+    // Once the write end is closed, an empty pipe means end of file
+    return pipe->head != pipe->tail;
+}
+
+static uint32_t pipe_write_space(pipe_t *pipe, uint8_t **ptr)
+{
+    uint64_t index = pipe->head & (pipe->size - 1);
+    uint64_t space = pipe->size - (pipe->head - pipe->tail);
+    uint64_t contiguous = pipe->size - index;
+
+    *ptr = pipe->buffer + index;
+
+    return (uint32_t)(space < contiguous ? space : contiguous);
+}
+
+static uint32_t pipe_read_space(pipe_t *pipe, uint8_t **ptr)
+{
+    uint64_t index = pipe->tail & (pipe->size - 1);
+    uint64_t available = pipe->head - pipe->tail;
+    uint64_t contiguous = pipe->size - index;
+
+    *ptr = pipe->buffer + index;
+
+    return (uint32_t)(available < contiguous ? available : contiguous);
+}
+
+static void pipe_commit_write(pipe_t *pipe, uint32_t count)
+{
+    // The data must be visible before the new head
+    __sync_synchronize();
+
+    uint64_t flags = irq_save();
+
+    // Readers only sleep on an empty pipe, so there is nobody to wake unless
+    // this write made it non-empty.
+    int was_empty = pipe->head == pipe->tail;
+
+    pipe->head += count;
+
+    if (was_empty)
+    {
+        wait_queue_wake_all(&pipe->readers);
+        poll_head_notify(&pipe->read_poll, POLLIN);
+    }
+
+    irq_restore(flags);
+}
+
+static void pipe_commit_read(pipe_t *pipe, uint32_t count)
+{
+    __sync_synchronize();
+
+    uint64_t flags = irq_save();
+
+    int was_full = pipe->head - pipe->tail == pipe->size;
+
+    pipe->tail += count;
+
+    if (was_full)
+    {
+        wait_queue_wake_all(&pipe->writers);
+        poll_head_notify(&pipe->write_poll, POLLOUT);
+    }
+
+    irq_restore(flags);
+}
+
+//=============================================================================
+// VFS operations
+//=============================================================================
+
+static uint32_t read_pipe(fs_node_t *node,
+                          uint64_t offset,
+                          uint32_t size,
+                          uint8_t *buffer)
+{
+    (void)offset;
+
+    pipe_t *pipe = (pipe_t *)node->device;
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    pipe_lock_read(pipe);
+
+    if (!pipe_wait_readable(pipe))
+    {
+        pipe_unlock_read(pipe);
+
+        return 0;
+    }
+
+    // Return whatever is available instead of waiting for the whole request
+    uint32_t done = 0;
+
+    while (done < size)
+    {
+        uint8_t *ptr;
+        uint32_t count = pipe_read_space(pipe, &ptr);
+
+        if (count == 0)
+        {
+            break;
+        }
+
+        if (count > size - done)
+        {
+            count = size - done;
+        }
+
+        memcpy(buffer + done, ptr, count);
+
+        pipe_commit_read(pipe, count);
+
+        done += count;
+    }
+
+    pipe_unlock_read(pipe);
+
+    return done;
+}
+
+static uint32_t write_pipe(fs_node_t *node,
+                           uint64_t offset,
+                           uint32_t size,
+                           uint8_t *buffer)
+{
+    (void)offset;
+
+    pipe_t *pipe = (pipe_t *)node->device;
+
+    uint32_t done = 0;
+
+    // Holding the write end for the whole request keeps the data of writers
+    // from interleaving.
+    pipe_lock_write(pipe);
+
+    while (done < size)
+    {
+        int ret = pipe_wait_writable(pipe);
+
+        if (ret < 0)
+        {
+            pipe_unlock_write(pipe);
+
+            return done ? done : (uint32_t)ret;
+        }
+
+        uint8_t *ptr;
+        uint32_t count = pipe_write_space(pipe, &ptr);
+
+        if (count > size - done)
+        {
+            count = size - done;
+        }
+
+        memcpy(ptr, buffer + done, count);
+
+        pipe_commit_write(pipe, count);
+
+        done += count;
+    }
+
+    pipe_unlock_write(pipe);
+
+    return done;
+}
+
+static void close_pipe(fs_node_t *node)
+{
+    pipe_t *pipe = (pipe_t *)node->device;
+
+    uint64_t flags = irq_save();
+
+    if (node == pipe->read_node)
+    {
+        pipe->read_closed = 1;
+        wait_queue_wake_all(&pipe->writers);
+        poll_head_notify(&pipe->write_poll, POLLOUT | POLLERR);
+    }
+    else
+    {
+        pipe->write_closed = 1;
+        wait_queue_wake_all(&pipe->readers);
+        poll_head_notify(&pipe->read_poll, POLLIN | POLLHUP);
+    }
+
+    int unused = pipe->read_closed && pipe->write_closed;
+
+    irq_restore(flags);
+
+    if (unused)
+    {
+        free(pipe->read_node);
+        free(pipe->write_node);
+        free(pipe->buffer);
+        free(pipe);
+    }
+}
+
+static int selectcheck_pipe(fs_node_t *node)
+{
+    pipe_t *pipe = (pipe_t *)node->device;
+
+    // 0 if an operation on the node would not block
+    if (node == pipe->read_node)
+    {
+        return (pipe->head != pipe->tail || pipe->write_closed) ? 0 : 1;
+    }
+
+    return (pipe->head - pipe->tail < pipe->size || pipe->read_closed) ? 0 : 1;
+}
+
+static int selectwait_pipe(fs_node_t *node, poll_entry_t *entry)
+{
+    pipe_t *pipe = (pipe_t *)node->device;
+
+    if (node == pipe->read_node)
+    {
+        poll_head_add(&pipe->read_poll, entry);
+    }
+    else
+    {
+        poll_head_add(&pipe->write_poll, entry);
+    }
+
+    return 0;
+}
+
+static fs_node_t *pipe_create_node(pipe_t *pipe, const char *name)
+{
+    fs_node_t *node = malloc(sizeof(fs_node_t));
+
+    if (!node)
+    {
+        return NULL;
+    }
+
+    memset(node, 0, sizeof(fs_node_t));
+
+    strcpy(node->name, name);
+
+    node->device = pipe;
+    node->flags = FS_PIPE;
+    node->permissions = 0600;
+    node->refcount = 1;
+    node->nlink = 1;
+
+    node->close = close_pipe;
+    node->selectcheck = selectcheck_pipe;
+    node->selectwait = selectwait_pipe;
+
+    return node;
+}
+
+//=============================================================================
+// Interface functions
+//=============================================================================
+
+int pipe_create(fs_node_t **read_node, fs_node_t **write_node)
+{
+    pipe_t *pipe = malloc(sizeof(pipe_t));
+
+    if (!pipe)
+    {
+        return -ENOMEM;
+    }
+
+    memset(pipe, 0, sizeof(pipe_t));
+
+    pipe->size = PIPE_SIZE;
+    pipe->buffer = malloc(pipe->size);
+
+    wait_queue_init(&pipe->readers);
+    wait_queue_init(&pipe->writers);
+    wait_queue_init(&pipe->read_lock_wait);
+    wait_queue_init(&pipe->write_lock_wait);
+
+    poll_head_init(&pipe->read_poll);
+    poll_head_init(&pipe->write_poll);
+
+    pipe->read_node = pipe_create_node(pipe, "[pipe:r]");
+    pipe->write_node = pipe_create_node(pipe, "[pipe:w]");
+
+    if (!pipe->buffer || !pipe->read_node || !pipe->write_node)
+    {
+        free(pipe->read_node);
+        free(pipe->write_node);
+        free(pipe->buffer);
+        free(pipe);
+
+        return -ENOMEM;
+    }
+
+    pipe->read_node->read = read_pipe;
+    pipe->write_node->write = write_pipe;
+
+    *read_node = pipe->read_node;
+    *write_node = pipe->write_node;
+
+    return 0;
+}
+
+int pipe_is_pipe(fs_node_t *node)
+{
+    return node && node->close == close_pipe;
+}
+
+int pipe_hangup_events(fs_node_t *node)
+{
+    pipe_t *pipe = (pipe_t *)node->device;
+
+    if (node == pipe->read_node)
+    {
+        return pipe->write_closed ? POLLHUP : 0;
+    }
+
+    return pipe->read_closed ? POLLERR : 0;
+}
+
+int pipe_splice_from(fs_node_t *pipe_node,
+                     fs_node_t *src,
+                     uint64_t offset,
+                     uint32_t size)
+{
+    pipe_t *pipe = (pipe_t *)pipe_node->device;
+
+    if (pipe_node != pipe->write_node)
+    {
+        return -EBADF;
+    }
+
+    pipe_lock_write(pipe);
+
+    int ret = pipe_wait_writable(pipe);
+
+    if (ret < 0)
+    {
+        pipe_unlock_write(pipe);
+
+        return ret;
+    }
+
+    // Only wait for room once, then move as much as fits
+    uint32_t done = 0;
+
+    while (done < size)
+    {
+        uint8_t *ptr;
+        uint32_t count = pipe_write_space(pipe, &ptr);
+
+        if (count == 0)
+        {
+            break;
+        }
+
+        if (count > size - done)
+        {
+            count = size - done;
+        }
+
+        uint32_t in = read_fs(src, offset + done, count, ptr);
+
+        if (in == 0 || (int32_t)in < 0)
+        {
+            break;
+        }
+
+        pipe_commit_write(pipe, in);
+
+        done += in;
+
+        if (in < count)
+        {
+            break;
+        }
+    }
+
+    pipe_unlock_write(pipe);
+
+    return (int)done;
+}
+
+int pipe_splice_to(fs_node_t *pipe_node,
+                   fs_node_t *dst,
+                   uint64_t offset,
+                   uint32_t size)
+{
+    pipe_t *pipe = (pipe_t *)pipe_node->device;
+
+    if (pipe_node != pipe->read_node)
+    {
+        return -EBADF;
+    }
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    pipe_lock_read(pipe);
+
+    if (!pipe_wait_readable(pipe))
+    {
+        pipe_unlock_read(pipe);
+
+        return 0;
+    }
+
+    uint32_t done = 0;
+
+    while (done < size)
+    {
+        uint8_t *ptr;
+        uint32_t count = pipe_read_space(pipe, &ptr);
+
+        if (count == 0)
+        {
+            break;
+        }
+
+        if (count > size - done)
+        {
+            count = size - done;
+        }
+
+        uint32_t out = write_fs(dst, offset + done, count, ptr);
+
+        if (out == 0 || (int32_t)out < 0)
+        {
+            if (!done && (int32_t)out < 0)
+            {
+                pipe_unlock_read(pipe);
+
+                return (int32_t)out;
+            }
+
+            break;
+        }
+
+        pipe_commit_read(pipe, out);
+
+        done += out;
+
+        if (out < count)
+        {
+            break;
+        }
+    }
+
+    pipe_unlock_read(pipe);
+
+    return (int)done;
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -0,0 +1,132 @@
+/**
+ * @file poll.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief Readiness notification
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vfs/poll.h>
+
+#include <arch/arch.h>
+#include <vfs/pipe.h>
+
+#include <stddef.h>
+
+void poll_head_init(poll_head_t *head)
+{
+    head->first = NULL;
+}
+
+void poll_head_add(poll_head_t *head, poll_entry_t *entry)
+{
+    uint64_t flags = irq_save();
+
+    entry->head = head;
+    entry->prev = NULL;
+    entry->next = head->first;
+
+    if (head->first)
+    {
+        head->first->prev = entry;
+    }
+
+    head->first = entry;
+
+    irq_restore(flags);
+}
+
+void poll_head_remove(poll_entry_t *entry)
+{
+    uint64_t flags = irq_save();
+
+    poll_head_t *head = entry->head;
+
+    if (head)
+    {
+        if (entry->prev)
+        {
+            entry->prev->next = entry->next;
+        }
+        else
+        {
+            head->first = entry->next;
+        }
+
+        if (entry->next)
+        {
+            entry->next->prev = entry->prev;
+        }
+
+        entry->head = NULL;
+        entry->prev = NULL;
+        entry->next = NULL;
+    }
+
+    irq_restore(flags);
+}
+
+void poll_head_notify(poll_head_t *head, int events)
+{
+    uint64_t flags = irq_save();
+
+    poll_entry_t *entry = head->first;
+
+    while (entry)
+    {
+        // The callback may remove its own entry
+        poll_entry_t *next = entry->next;
+
+        entry->notify(entry, events);
+
+        entry = next;
+    }
+
+    irq_restore(flags);
+}
+
+int poll_node_events(fs_node_t *node, int mode)
+{
+    int events = 0;
+
+    if (pipe_is_pipe(node))
+    {
+        events |= pipe_hangup_events(node);
+    }
+
+    // Nodes without a selectcheck operation never block
+    if (selectcheck_fs(node) > 0)
+    {
+        return events;
+    }
+
+    if (mode & 01)
+    {
+        events |= POLLIN;
+    }
+
+    if (mode & 02)
+    {
+        events |= POLLOUT;
+    }
+
+    return events;
+}
+
+//=============================================================================
+// End of file
+//=============================================================================
@@ -1,4 +1,8 @@
+kernel_source(dcache.c)
+kernel_source(epoll.c)
 kernel_source(ext2.c)
 kernel_source(nulldev.c)
+kernel_source(pipe.c)
+kernel_source(poll.c)
 kernel_source(vfs.c)
 kernel_source(zerodev.c)
\ No newline at end of file
@@ -27,10 +27,13 @@
 #include <sync/spinlock.h>
 #include <util/list.h>
 #include <util/tree.h>
+#include <vfs/dcache.h>
+#include <vfs/epoll.h>
 #include <vfs/nulldev.h>
 #include <vfs/vfs.h>
 #include <vfs/zerodev.h>
 
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -49,6 +52,18 @@ int has_permissions(fs_node_t *node, int permission_bit)
     return 1;
 }
 
+// The dentry cache keeps a copy of the attributes of the nodes it has looked
+// up, which are stale once the node has been changed.
+static void vfs_node_changed(fs_node_t *node)
+{
+    if (node->flags & (FS_CHARDEVICE | FS_BLOCKDEVICE | FS_PIPE))
+    {
+        return;
+    }
+
+    dcache_invalidate_node(node);
+}
+
 uint32_t read_fs(fs_node_t *node,
                  uint64_t offset,
                  uint32_t size,
@@ -72,12 +87,160 @@ uint32_t write_fs(fs_node_t *node,
     if (node && node->write)
     {
         uint32_t ret = node->write(node, offset, size, buffer);
+
+        if (ret)
+        {
+            vfs_node_changed(node);
+        }
+
         return ret;
     }
 
     return 0;
 }
 
+uint32_t readv_fs(fs_node_t *node,
+                  uint64_t offset,
+                  const struct iovec *iov,
+                  int iovcnt)
+{
+    if (!node)
+    {
+        return 0;
+    }
+
+    if (node->readv)
+    {
+        return node->readv(node, offset, iov, iovcnt);
+    }
+
+    uint32_t total = 0;
+
+    for (int i = 0; i < iovcnt; ++i)
+    {
+        uint32_t ret = read_fs(node,
+                               offset + total,
+                               iov[i].iov_len,
+                               (uint8_t *)iov[i].iov_base);
+
+        total += ret;
+
+        if (ret < iov[i].iov_len)
+        {
+            break;
+        }
+    }
+
+    return total;
+}
+
+uint32_t writev_fs(fs_node_t *node,
+                   uint64_t offset,
+                   const struct iovec *iov,
+                   int iovcnt)
+{
+    if (!node)
+    {
+        return 0;
+    }
+
+    if (node->writev)
+    {
+        uint32_t ret = node->writev(node, offset, iov, iovcnt);
+
+        if (ret)
+        {
+            vfs_node_changed(node);
+        }
+
+        return ret;
+    }
+
+    uint32_t total = 0;
+
+    for (int i = 0; i < iovcnt; ++i)
+    {
+        uint32_t ret = write_fs(node,
+                                offset + total,
+                                iov[i].iov_len,
+                                (uint8_t *)iov[i].iov_base);
+
+        total += ret;
+
+        if (ret < iov[i].iov_len)
+        {
+            break;
+        }
+    }
+
+    return total;
+}
+
+// Largest chunk copied at a time when the file system can not copy by itself
+#define COPY_RANGE_CHUNK 0x10000
+
+uint32_t copy_range_fs(fs_node_t *src,
+                       uint64_t src_offset,
+                       fs_node_t *dst,
+                       uint64_t dst_offset,
+                       uint32_t size)
+{
+    if (!src || !dst || !size)
+    {
+        return 0;
+    }
+
+    if (src->copy_range && src->copy_range == dst->copy_range &&
+        src->device == dst->device)
+    {
+        uint32_t ret =
+            src->copy_range(src, src_offset, dst, dst_offset, size);
+
+        if (ret)
+        {
+            vfs_node_changed(dst);
+        }
+
+        return ret;
+    }
+
+    uint32_t chunk = size < COPY_RANGE_CHUNK ? size : COPY_RANGE_CHUNK;
+
+    uint8_t *buffer = malloc(chunk);
+
+    if (!buffer)
+    {
+        return 0;
+    }
+
+    uint32_t total = 0;
+
+    while (total < size)
+    {
+        uint32_t count = size - total < chunk ? size - total : chunk;
+
+        uint32_t in = read_fs(src, src_offset + total, count, buffer);
+
+        if (in == 0)
+        {
+            break;
+        }
+
+        uint32_t out = write_fs(dst, dst_offset + total, in, buffer);
+
+        total += out;
+
+        if (out < in || in < count)
+        {
+            break;
+        }
+    }
+
+    free(buffer);
+
+    return total;
+}
+
 void open_fs(fs_node_t *node, uint32_t flags)
 {
     if (!node)
@@ -121,6 +284,8 @@ void close_fs(fs_node_t *node)
 
     if (node->refcount == 0)
     {
+        epoll_node_closed(node);
+
         if (node->close)
         {
             node->close(node);
@@ -141,6 +306,88 @@ struct dirent *readdir_fs(fs_node_t *node, uint32_t index)
     return (struct dirent *)NULL;
 }
 
+int vfs_dirent_emit(uint8_t *buffer,
+                    size_t size,
+                    size_t *used,
+                    uint32_t ino,
+                    uint8_t type,
+                    const char *name,
+                    size_t name_len)
+{
+    size_t reclen = offsetof(struct vfs_dirent, d_name) + name_len + 1;
+    reclen = (reclen + 7) & ~7UL;
+
+    if (*used + reclen > size)
+    {
+        return 0;
+    }
+
+    struct vfs_dirent *dirent = (struct vfs_dirent *)(buffer + *used);
+
+    dirent->d_ino = ino;
+    dirent->d_reclen = (uint16_t)reclen;
+    dirent->d_type = type;
+    dirent->reserved = 0;
+
+    memcpy(dirent->d_name, name, name_len);
+    memset(dirent->d_name + name_len,
+           0,
+           reclen - offsetof(struct vfs_dirent, d_name) - name_len);
+
+    *used += reclen;
+
+    return 1;
+}
+
+int getdents_fs(fs_node_t *node,
+                uint64_t *cursor,
+                uint8_t *buffer,
+                size_t size)
+{
+    if (!node || !(node->flags & FS_DIRECTORY))
+    {
+        return -ENOTDIR;
+    }
+
+    if (node->getdents)
+    {
+        return node->getdents(node, cursor, buffer, size);
+    }
+
+    // Fall back to one readdir call per entry, with the cursor used as the
+    // entry index.
+    size_t used = 0;
+
+    while (1)
+    {
+        struct dirent *entry = readdir_fs(node, (uint32_t)*cursor);
+
+        if (!entry)
+        {
+            break;
+        }
+
+        int added = vfs_dirent_emit(buffer,
+                                    size,
+                                    &used,
+                                    entry->ino,
+                                    DT_UNKNOWN,
+                                    entry->name,
+                                    strlen(entry->name));
+
+        free(entry);
+
+        if (!added)
+        {
+            return used ? (int)used : -EINVAL;
+        }
+
+        (*cursor)++;
+    }
+
+    return (int)used;
+}
+
 fs_node_t *finddir_fs(fs_node_t *node, char *name)
 {
     if (!node)
@@ -150,7 +397,7 @@ fs_node_t *finddir_fs(fs_node_t *node, char *name)
 
     if ((node->flags & FS_DIRECTORY) && node->finddir)
     {
-        fs_node_t *ret = node->finddir(node, name);
+        fs_node_t *ret = dcache_finddir(node, name);
 
         return ret;
     }
@@ -234,6 +481,11 @@ int mkdir_fs(char *name, uint16_t permission)
     if (parent->mkdir)
     {
         ret = parent->mkdir(parent, f_path, permission);
+
+        // Drops the negative entry left by the lookup above, and the parent,
+        // whose link count changed
+        dcache_invalidate(parent, f_path);
+        vfs_node_changed(parent);
     }
     else
     {
@@ -308,6 +560,9 @@ int create_file_fs(char *name, uint16_t permission)
     if ((node->flags & FS_DIRECTORY) && node->mkdir)
     {
         node->create(node, dir_name + i, permission);
+
+        dcache_invalidate(node, dir_name + i);
+        vfs_node_changed(node);
     }
 
     free(node);
@@ -549,7 +804,11 @@ int chmod_fs(fs_node_t *node, int mode)
 
     if (node->chmod)
     {
-        return node->chmod(node, mode);
+        int ret = node->chmod(node, mode);
+
+        vfs_node_changed(node);
+
+        return ret;
     }
 
     return 0;
@@ -564,7 +823,11 @@ int chown_fs(fs_node_t *node, int uid, int gid)
 
     if (node->chown)
     {
-        return node->chown(node, uid, gid);
+        int ret = node->chown(node, uid, gid);
+
+        vfs_node_changed(node);
+
+        return ret;
     }
 
     return 0;
@@ -617,7 +880,26 @@ int unlink_fs(char *name)
 
     if (parent->unlink)
     {
+        // Other links to the node and the entries in it, if it is a
+        // directory, must go as well
+        fs_node_t *target = finddir_fs(parent, f_path);
+
         ret = parent->unlink(parent, f_path);
+
+        dcache_invalidate(parent, f_path);
+        vfs_node_changed(parent);
+
+        if (target)
+        {
+            vfs_node_changed(target);
+
+            if (target->flags & FS_DIRECTORY)
+            {
+                dcache_invalidate_dir(target);
+            }
+
+            free(target);
+        }
     }
     else
     {
@@ -671,6 +953,9 @@ int symlink_fs(char *target, char *name)
     if (parent->symlink)
     {
         ret = parent->symlink(parent, target, f_path);
+
+        dcache_invalidate(parent, f_path);
+        vfs_node_changed(parent);
     }
     else
     {
@@ -715,7 +1000,7 @@ int selectcheck_fs(fs_node_t *node)
     return -1;
 }
 
-int selectwait_fs(fs_node_t *node, void *process)
+int selectwait_fs(fs_node_t *node, struct poll_entry *entry)
 {
     if (!node)
     {
@@ -724,7 +1009,7 @@ int selectwait_fs(fs_node_t *node, void *process)
 
     if (node->selectwait)
     {
-        int ret = node->selectwait(node, process);
+        int ret = node->selectwait(node, entry);
 
         return ret;
     }
@@ -742,6 +1027,8 @@ void truncate_fs(fs_node_t *node)
     if (node->truncate)
     {
         node->truncate(node);
+
+        vfs_node_changed(node);
     }
 }
 
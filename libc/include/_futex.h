@@ -0,0 +1,58 @@
+/**
+ * @file _futex.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief Futex helpers
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#ifndef _LIBC_FUTEX_H
+#define _LIBC_FUTEX_H
+
+#include <_cheader.h>
+
+_c_header_begin;
+
+#define FUTEX_WAIT 0
+#define FUTEX_WAKE 1
+#define FUTEX_REQUEUE 3
+
+/**
+ * @brief Sleeps until woken, unless *addr no longer equals val
+ * 
+ */
+int _futex_wait(volatile int *addr, int val);
+
+/**
+ * @brief Wakes up to count threads sleeping on addr
+ * 
+ */
+int _futex_wake(volatile int *addr, int count);
+
+/**
+ * @brief Wakes up to wake_count threads sleeping on addr, and moves up to
+ * requeue_count of the remaining ones to addr2
+ * 
+ */
+int _futex_requeue(volatile int *addr,
+                   int wake_count,
+                   volatile int *addr2,
+                   int requeue_count);
+
+_c_header_end;
+
+#endif
\ No newline at end of file
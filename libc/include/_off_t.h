@@ -0,0 +1,39 @@
+/**
+ * @file _off_t.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#ifndef _LIBC__OFF_T_H
+#define _LIBC__OFF_T_H
+
+#include <_cheader.h>
+
+_c_header_begin;
+
+/**
+ * @brief File offset type
+ * 
+ * 
+ */
+typedef long off_t;
+
+_c_header_end;
+
+#endif
\ No newline at end of file
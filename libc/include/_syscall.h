@@ -67,10 +67,59 @@ _c_header_begin;
 #define SYSCALL_CHDIR 27
 #define SYSCALL_GETCWD 28
 
+#define SYSCALL_FUTEX 31
+
+#define SYSCALL_SPAWN 32
+
+#define SYSCALL_READV 33
+#define SYSCALL_WRITEV 34
+#define SYSCALL_PREAD 35
+#define SYSCALL_PWRITE 36
+
+#define SYSCALL_IO_RING_SETUP 37
+#define SYSCALL_IO_RING_ENTER 38
+
+#define SYSCALL_GETDENTS 39
+
+#define SYSCALL_COPY_FILE_RANGE 40
+#define SYSCALL_SENDFILE 41
+
+#define SYSCALL_PIPE 42
+#define SYSCALL_SPLICE 43
+
+#define SYSCALL_SHM_OPEN 44
+#define SYSCALL_SHM_UNLINK 45
+#define SYSCALL_FTRUNCATE 46
+#define SYSCALL_MMAP 47
+#define SYSCALL_MUNMAP 48
+
+#define SYSCALL_POLL 49
+#define SYSCALL_EPOLL_CREATE 50
+#define SYSCALL_EPOLL_CTL 51
+#define SYSCALL_EPOLL_WAIT 52
+
 int64_t do_syscall0(int64_t syscall);
 int64_t do_syscall1(int64_t syscall, int64_t arg1);
 int64_t do_syscall2(int64_t syscall, int64_t arg1, int64_t arg2);
 int64_t do_syscall3(int64_t syscall, int64_t arg1, int64_t arg2, int64_t arg3);
+int64_t do_syscall4(int64_t syscall,
+                    int64_t arg1,
+                    int64_t arg2,
+                    int64_t arg3,
+                    int64_t arg4);
+int64_t do_syscall5(int64_t syscall,
+                    int64_t arg1,
+                    int64_t arg2,
+                    int64_t arg3,
+                    int64_t arg4,
+                    int64_t arg5);
+int64_t do_syscall6(int64_t syscall,
+                    int64_t arg1,
+                    int64_t arg2,
+                    int64_t arg3,
+                    int64_t arg4,
+                    int64_t arg5,
+                    int64_t arg6);
 
 _c_header_end;
 
@@ -0,0 +1,74 @@
+/**
+ * @file _vdso.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief Data page shared with the kernel
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#ifndef _LIBC_VDSO_H
+#define _LIBC_VDSO_H
+
+#include <_cheader.h>
+#include <_pid_t.h>
+
+#include <stdint.h>
+
+_c_header_begin;
+
+/**
+ * @brief Address where the kernel maps the data page
+ * 
+ */
+#define _VDSO_DATA_ADDR 0x7FE00000
+
+/**
+ * @brief Layout of the data page. Must match kernel/include/process/vdso.h.
+ * 
+ * The clock fields are only consistent when seq is even and unchanged across
+ * the read.
+ * 
+ */
+typedef struct _vdso_data
+{
+    volatile uint32_t seq;
+    uint32_t tsc_valid;
+    uint64_t tsc_base;
+    uint64_t mono_base_ns;
+    uint64_t tsc_mult;
+    uint32_t tsc_shift;
+    uint32_t reserved;
+    int64_t boot_time;
+    volatile pid_t pid;
+    volatile pid_t tid;
+} _vdso_data_t;
+
+#define _vdso_data ((const _vdso_data_t *)_VDSO_DATA_ADDR)
+
+/**
+ * @brief Reads the clock from the data page without entering the kernel
+ * 
+ * @param realtime Nonzero for wall clock time, zero for time since boot
+ * @param sec Receives the seconds
+ * @param nsec Receives the nanoseconds
+ * 
+ */
+void _vdso_get_time(int realtime, int64_t *sec, int64_t *nsec);
+
+_c_header_end;
+
+#endif
\ No newline at end of file
@@ -0,0 +1,74 @@
+/**
+ * @file dirent.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief Directory entries
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#ifndef _LIBC_DIRENT_H
+#define _LIBC_DIRENT_H
+
+#include <_cheader.h>
+#include <_size_t.h>
+#include <_ssize_t.h>
+
+#include <stdint.h>
+
+_c_header_begin;
+
+#define DT_UNKNOWN 0
+#define DT_FIFO 1
+#define DT_CHR 2
+#define DT_DIR 4
+#define DT_BLK 6
+#define DT_REG 8
+#define DT_LNK 10
+#define DT_SOCK 12
+
+/**
+ * @brief Directory entry as returned by getdents
+ * 
+ * Records are packed back to back, each d_reclen bytes long.
+ * 
+ */
+struct vfs_dirent
+{
+    uint32_t d_ino;
+    uint16_t d_reclen;
+    uint8_t d_type;
+    uint8_t reserved;
+    char d_name[];
+};
+
+/**
+ * @brief Reads as many entries of an open directory as fit in a buffer
+ * 
+ * Each call continues where the previous one stopped.
+ * 
+ * @param fd Directory file descriptor
+ * @param buffer Buffer receiving struct vfs_dirent records
+ * @param size Size of the buffer
+ * 
+ * @return Number of bytes written, 0 at the end of the directory, or
+ * negative error code
+ */
+ssize_t getdents(int fd, void *buffer, size_t size);
+
+_c_header_end;
+
+#endif
\ No newline at end of file
@@ -0,0 +1,169 @@
+/**
+ * @file io_ring.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief Batched asynchronous system calls
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#ifndef _LIBC_IO_RING_H
+#define _LIBC_IO_RING_H
+
+#include <_cheader.h>
+#include <_null.h>
+
+#include <stdint.h>
+
+_c_header_begin;
+
+// Layout shared with the kernel. Must match kernel/include/syscall/io_ring.h.
+
+#define IO_RING_MAX_ENTRIES 4096
+
+#define IO_RING_OP_NOP 0
+#define IO_RING_OP_READ 1
+#define IO_RING_OP_WRITE 2
+#define IO_RING_OP_OPEN 3
+#define IO_RING_OP_CLOSE 4
+#define IO_RING_OP_STAT 5
+
+#define IO_RING_OFFSET_CURRENT ((uint64_t)-1)
+
+#define IO_RING_ENTER_GETEVENTS 0x01
+
+/**
+ * @brief One queued operation
+ * 
+ * Field use per operation:
+ * - READ/WRITE: fd, addr = buffer, len, off = position or
+ *   IO_RING_OFFSET_CURRENT
+ * - OPEN: addr = path, open_flags, len = mode
+ * - CLOSE: fd
+ * - STAT: addr = path, or 0 to stat fd, addr2 = struct stat
+ * 
+ */
+typedef struct _io_ring_sqe
+{
+    uint8_t opcode;
+    uint8_t flags;
+    uint16_t reserved;
+    int32_t fd;
+    uint64_t off;
+    uint64_t addr;
+    uint64_t addr2;
+    uint32_t len;
+    uint32_t open_flags;
+    uint64_t user_data;
+} io_ring_sqe_t;
+
+/**
+ * @brief Result of one operation
+ * 
+ */
+typedef struct _io_ring_cqe
+{
+    uint64_t user_data;
+    int32_t res;
+    uint32_t flags;
+} io_ring_cqe_t;
+
+typedef struct _io_ring_header
+{
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    uint32_t mask;
+    uint32_t entries;
+} io_ring_header_t;
+
+typedef struct _io_ring_params
+{
+    uint32_t sq_entries;
+    uint32_t cq_entries;
+    uint64_t sq_ring;
+    uint64_t cq_ring;
+} io_ring_params_t;
+
+/**
+ * @brief Rings of the process, as seen from user space
+ * 
+ */
+typedef struct _io_ring
+{
+    io_ring_header_t *sq;
+    io_ring_sqe_t *sqes;
+
+    io_ring_header_t *cq;
+    io_ring_cqe_t *cqes;
+
+    // Entries handed out by io_ring_get_sqe but not yet submitted
+    uint32_t sqe_tail;
+} io_ring_t;
+
+/**
+ * @brief Creates the rings of the process
+ * 
+ * @param ring Ring to initialize
+ * @param entries Number of submission entries
+ * 
+ * @return 0 on success, negative error code on failure
+ */
+int io_ring_init(io_ring_t *ring, uint32_t entries);
+
+/**
+ * @brief Gets the next free submission entry
+ * 
+ * @return The entry, cleared, or NULL if the submission ring is full
+ */
+io_ring_sqe_t *io_ring_get_sqe(io_ring_t *ring);
+
+/**
+ * @brief Submits all entries obtained since the last submit
+ * 
+ * @return Number of entries submitted, or negative error code
+ */
+int io_ring_submit(io_ring_t *ring);
+
+/**
+ * @brief Submits all pending entries and waits for wait_nr completions
+ * 
+ * @return Number of completions available, or negative error code
+ */
+int io_ring_submit_and_wait(io_ring_t *ring, uint32_t wait_nr);
+
+/**
+ * @brief Gets the oldest completion without blocking
+ * 
+ * @return The completion, or NULL if there is none
+ */
+io_ring_cqe_t *io_ring_peek_cqe(io_ring_t *ring);
+
+/**
+ * @brief Gets the oldest completion, waiting for one if needed
+ * 
+ * @return The completion, or NULL on error
+ */
+io_ring_cqe_t *io_ring_wait_cqe(io_ring_t *ring);
+
+/**
+ * @brief Marks the oldest completion as consumed
+ * 
+ */
+void io_ring_cqe_seen(io_ring_t *ring);
+
+_c_header_end;
+
+#endif
\ No newline at end of file
@@ -0,0 +1,61 @@
+/**
+ * @file poll.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#ifndef _LIBC_POLL_H
+#define _LIBC_POLL_H
+
+#include <_cheader.h>
+
+_c_header_begin;
+
+#define POLLIN 0x0001
+#define POLLPRI 0x0002
+#define POLLOUT 0x0004
+#define POLLERR 0x0008
+#define POLLHUP 0x0010
+#define POLLNVAL 0x0020
+
+typedef unsigned long nfds_t;
+
+struct pollfd
+{
+    int fd;
+    short events;
+    short revents;
+};
+
+/**
+ * @brief Waits for one of a set of file descriptors to become ready
+ * 
+ * @param fds Descriptors to watch. Entries with a negative fd are ignored.
+ * @param nfds Number of entries in fds
+ * @param timeout Timeout in milliseconds, negative to wait forever and 0 to
+ * return immediately
+ * 
+ * @return Number of entries with events set in revents, 0 on timeout, or a
+ * negative error code.
+ */
+int poll(struct pollfd *fds, nfds_t nfds, int timeout);
+
+_c_header_end;
+
+#endif
\ No newline at end of file
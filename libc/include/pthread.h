@@ -0,0 +1,102 @@
+/**
+ * @file pthread.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#ifndef _LIBC_PTHREAD_H
+#define _LIBC_PTHREAD_H
+
+#include <_cheader.h>
+
+_c_header_begin;
+
+/**
+ * @brief Mutex
+ * 
+ * state is 0 when unlocked, 1 when locked and 2 when locked with possible
+ * waiters. Only the contended case enters the kernel.
+ */
+typedef struct
+{
+    volatile int state;
+} pthread_mutex_t;
+
+typedef struct
+{
+    int unused;
+} pthread_mutexattr_t;
+
+/**
+ * @brief Condition variable
+ * 
+ */
+typedef struct
+{
+    volatile int seq;
+    pthread_mutex_t *mutex;
+} pthread_cond_t;
+
+typedef struct
+{
+    int unused;
+} pthread_condattr_t;
+
+/**
+ * @brief One-time initialization control
+ * 
+ */
+typedef struct
+{
+    volatile int state;
+} pthread_once_t;
+
+#define PTHREAD_MUTEX_INITIALIZER \
+    {                             \
+        0                         \
+    }
+
+#define PTHREAD_COND_INITIALIZER \
+    {                            \
+        0, 0                     \
+    }
+
+#define PTHREAD_ONCE_INIT \
+    {                     \
+        0                 \
+    }
+
+int pthread_mutex_init(pthread_mutex_t *mutex,
+                       const pthread_mutexattr_t *attr);
+int pthread_mutex_destroy(pthread_mutex_t *mutex);
+int pthread_mutex_lock(pthread_mutex_t *mutex);
+int pthread_mutex_trylock(pthread_mutex_t *mutex);
+int pthread_mutex_unlock(pthread_mutex_t *mutex);
+
+int pthread_cond_init(pthread_cond_t *cond, const pthread_condattr_t *attr);
+int pthread_cond_destroy(pthread_cond_t *cond);
+int pthread_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex);
+int pthread_cond_signal(pthread_cond_t *cond);
+int pthread_cond_broadcast(pthread_cond_t *cond);
+
+int pthread_once(pthread_once_t *once_control, void (*init_routine)(void));
+
+_c_header_end;
+
+#endif
\ No newline at end of file
@@ -0,0 +1,55 @@
+/**
+ * @file sched.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#ifndef _LIBC_SCHED_H
+#define _LIBC_SCHED_H
+
+#include <_cheader.h>
+
+_c_header_begin;
+
+#include <_pid_t.h>
+
+/**
+ * @brief Creates a new thread sharing the address space and file descriptors
+ * of the caller
+ * 
+ * @param fn Function the thread starts in. The thread exits with its return
+ * value.
+ * @param stack Top of the stack for the new thread, or NULL to let the kernel
+ * allocate one.
+ * @param arg Argument passed to @p fn.
+ * 
+ * @return Thread ID of the new thread, or a negative error code.
+ */
+pid_t clone(int (*fn)(void *), void *stack, void *arg);
+
+/**
+ * @brief Gives up the processor to other runnable threads
+ * 
+ * @return 0.
+ */
+int sched_yield(void);
+
+_c_header_end;
+
+#endif
\ No newline at end of file
@@ -0,0 +1,96 @@
+/**
+ * @file spawn.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#ifndef _LIBC_SPAWN_H
+#define _LIBC_SPAWN_H
+
+#include <_cheader.h>
+
+_c_header_begin;
+
+#include <_pid_t.h>
+
+#define _SPAWN_FA_CLOSE 0
+#define _SPAWN_FA_DUP2 1
+#define _SPAWN_FA_CHDIR 2
+
+/**
+ * @brief A single file action, laid out as expected by the kernel
+ * 
+ */
+struct _spawn_file_action
+{
+    int type;
+    int fd;
+    int newfd;
+    const char *path;
+};
+
+typedef struct
+{
+    int count;
+    int capacity;
+    struct _spawn_file_action *actions;
+} posix_spawn_file_actions_t;
+
+typedef struct
+{
+    int unused;
+} posix_spawnattr_t;
+
+int posix_spawn_file_actions_init(posix_spawn_file_actions_t *file_actions);
+int posix_spawn_file_actions_destroy(posix_spawn_file_actions_t *file_actions);
+int posix_spawn_file_actions_addclose(posix_spawn_file_actions_t *file_actions,
+                                      int fd);
+int posix_spawn_file_actions_adddup2(posix_spawn_file_actions_t *file_actions,
+                                     int fd,
+                                     int newfd);
+int posix_spawn_file_actions_addchdir_np(
+    posix_spawn_file_actions_t *file_actions,
+    const char *path);
+
+/**
+ * @brief Starts a program in a new process
+ * 
+ * The address space of the caller is never copied. The child inherits the
+ * file descriptors and working directory of the caller, modified by
+ * @p file_actions.
+ * 
+ * @param pid Receives the process ID of the child.
+ * @param path Path of the executable.
+ * @param file_actions File actions to apply, may be NULL.
+ * @param attrp Unused, may be NULL.
+ * @param argv NULL terminated argument list.
+ * @param envp NULL terminated environment.
+ * 
+ * @return 0 on success, or an error number.
+ */
+int posix_spawn(pid_t *pid,
+                const char *path,
+                const posix_spawn_file_actions_t *file_actions,
+                const posix_spawnattr_t *attrp,
+                char *const argv[],
+                char *const envp[]);
+
+_c_header_end;
+
+#endif
\ No newline at end of file
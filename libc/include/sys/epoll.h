@@ -0,0 +1,98 @@
+/**
+ * @file epoll.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#ifndef _LIBC_SYS_EPOLL_H
+#define _LIBC_SYS_EPOLL_H
+
+#include <_cheader.h>
+
+#include <stdint.h>
+
+_c_header_begin;
+
+#define EPOLLIN 0x0001
+#define EPOLLPRI 0x0002
+#define EPOLLOUT 0x0004
+#define EPOLLERR 0x0008
+#define EPOLLHUP 0x0010
+#define EPOLLONESHOT (1u << 30)
+#define EPOLLET (1u << 31)
+
+#define EPOLL_CTL_ADD 1
+#define EPOLL_CTL_DEL 2
+#define EPOLL_CTL_MOD 3
+
+typedef union epoll_data
+{
+    void *ptr;
+    int fd;
+    uint32_t u32;
+    uint64_t u64;
+} epoll_data_t;
+
+struct epoll_event
+{
+    uint32_t events;
+    epoll_data_t data;
+} __attribute__((packed));
+
+/**
+ * @brief Creates an epoll instance
+ * 
+ * @param size Must be positive, otherwise unused
+ * 
+ * @return File descriptor of the instance, or a negative error code.
+ */
+int epoll_create(int size);
+
+/**
+ * @brief Adds, modifies or removes a file descriptor watched by an epoll
+ * instance
+ * 
+ * @param epfd Epoll instance
+ * @param op EPOLL_CTL_ADD, EPOLL_CTL_MOD or EPOLL_CTL_DEL
+ * @param fd File descriptor to watch
+ * @param event Events to watch and data to report, may be NULL for
+ * EPOLL_CTL_DEL
+ * 
+ * @return 0 on success, negative error code on failure.
+ */
+int epoll_ctl(int epfd, int op, int fd, struct epoll_event *event);
+
+/**
+ * @brief Waits for events on an epoll instance
+ * 
+ * Only file descriptors whose readiness changed are examined, so the cost
+ * does not grow with the number of watched descriptors.
+ * 
+ * @param timeout Timeout in milliseconds, negative to wait forever
+ * 
+ * @return Number of events stored in events, 0 on timeout.
+ */
+int epoll_wait(int epfd,
+               struct epoll_event *events,
+               int maxevents,
+               int timeout);
+
+_c_header_end;
+
+#endif
\ No newline at end of file
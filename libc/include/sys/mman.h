@@ -0,0 +1,100 @@
+/**
+ * @file mman.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#ifndef _LIBC_SYS_MMAN_H
+#define _LIBC_SYS_MMAN_H
+
+#include <_cheader.h>
+#include <_off_t.h>
+#include <_size_t.h>
+
+#include <fcntl.h>
+
+_c_header_begin;
+
+#define PROT_NONE 0x0
+#define PROT_READ 0x1
+#define PROT_WRITE 0x2
+#define PROT_EXEC 0x4
+
+#define MAP_SHARED 0x01
+#define MAP_PRIVATE 0x02
+#define MAP_FIXED 0x10
+#define MAP_ANONYMOUS 0x20
+
+#define MAP_FAILED ((void *)-1)
+
+/**
+ * @brief Maps a shared memory object into the address space
+ * 
+ * Only MAP_SHARED mappings of objects opened with shm_open, or anonymous
+ * memory with MAP_ANONYMOUS, are supported. The mapping is shared with
+ * children created by fork.
+ * 
+ * @param addr Ignored
+ * @param length Size of the mapping
+ * @param prot PROT_READ, optionally with PROT_WRITE
+ * @param flags MAP_SHARED, optionally with MAP_ANONYMOUS
+ * @param fd Shared memory object, ignored for anonymous memory
+ * @param offset Page aligned offset in the object
+ * 
+ * @return Address of the mapping, or MAP_FAILED.
+ */
+void *mmap(void *addr,
+           size_t length,
+           int prot,
+           int flags,
+           int fd,
+           off_t offset);
+
+/**
+ * @brief Removes mappings in a range of addresses
+ * 
+ * @return 0 on success, negative error code on failure.
+ */
+int munmap(void *addr, size_t length);
+
+/**
+ * @brief Opens a named shared memory object
+ * 
+ * A created object is empty until sized with ftruncate.
+ * 
+ * @param name Name of the object, starting with a slash
+ * @param oflag O_RDONLY or O_RDWR, optionally with O_CREAT, O_EXCL and O_TRUNC
+ * @param mode Permissions of a created object
+ * 
+ * @return File descriptor, or negative error code.
+ */
+int shm_open(const char *name, int oflag, int mode);
+
+/**
+ * @brief Removes the name of a shared memory object
+ * 
+ * The memory is released once it is no longer open or mapped anywhere.
+ * 
+ * @return 0 on success, negative error code on failure.
+ */
+int shm_unlink(const char *name);
+
+_c_header_end;
+
+#endif
\ No newline at end of file
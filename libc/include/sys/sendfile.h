@@ -0,0 +1,49 @@
+/**
+ * @file sendfile.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief Copying between files
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#ifndef _LIBC_SYS_SENDFILE_H
+#define _LIBC_SYS_SENDFILE_H
+
+#include <_cheader.h>
+#include <_off_t.h>
+#include <_size_t.h>
+#include <_ssize_t.h>
+
+_c_header_begin;
+
+/**
+ * @brief Copies data from in_fd to out_fd without passing it through user
+ * space
+ * 
+ * @param out_fd File to write to, at its file offset
+ * @param in_fd File to read from
+ * @param offset Offset to read from, advanced by the number of bytes copied.
+ * If NULL, the file offset of in_fd is used and advanced instead.
+ * @param count Number of bytes to copy
+ * 
+ * @return Number of bytes copied
+ */
+ssize_t sendfile(int out_fd, int in_fd, off_t *offset, size_t count);
+
+_c_header_end;
+
+#endif
\ No newline at end of file
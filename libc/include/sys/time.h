@@ -0,0 +1,64 @@
+/**
+ * @file time.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief Time of day
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#ifndef _LIBC_SYS_TIME_H
+#define _LIBC_SYS_TIME_H
+
+#include <_cheader.h>
+
+#include <time.h>
+
+_c_header_begin;
+
+/**
+ * @brief Time with microsecond resolution
+ * 
+ */
+struct timeval
+{
+    time_t tv_sec;
+    long tv_usec;
+};
+
+/**
+ * @brief Timezone, only kept for compatibility
+ * 
+ */
+struct timezone
+{
+    int tz_minuteswest;
+    int tz_dsttime;
+};
+
+/**
+ * @brief Reads the wall clock time
+ * 
+ * @param tv Receives the time
+ * @param tz Ignored
+ * 
+ * @return 0
+ */
+int gettimeofday(struct timeval *tv, struct timezone *tz);
+
+_c_header_end;
+
+#endif
\ No newline at end of file
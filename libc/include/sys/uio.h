@@ -0,0 +1,72 @@
+/**
+ * @file uio.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief Vectored I/O
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#ifndef _LIBC_SYS_UIO_H
+#define _LIBC_SYS_UIO_H
+
+#include <_cheader.h>
+#include <_size_t.h>
+#include <_ssize_t.h>
+
+_c_header_begin;
+
+/**
+ * @brief Maximum number of buffers in one call
+ * 
+ */
+#define IOV_MAX 1024
+
+/**
+ * @brief One buffer of a vectored read or write
+ * 
+ */
+struct iovec
+{
+    void *iov_base;
+    size_t iov_len;
+};
+
+/**
+ * @brief Reads from a file into several buffers with one system call
+ * 
+ * @param fd File descriptor
+ * @param iov Buffers, filled in order
+ * @param iovcnt Number of buffers
+ * 
+ * @return Total number of bytes read
+ */
+ssize_t readv(int fd, const struct iovec *iov, int iovcnt);
+
+/**
+ * @brief Writes several buffers to a file with one system call
+ * 
+ * @param fd File descriptor
+ * @param iov Buffers, written in order
+ * @param iovcnt Number of buffers
+ * 
+ * @return Total number of bytes written
+ */
+ssize_t writev(int fd, const struct iovec *iov, int iovcnt);
+
+_c_header_end;
+
+#endif
\ No newline at end of file
@@ -0,0 +1,84 @@
+/**
+ * @file time.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief Time functions
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#ifndef _LIBC_TIME_H
+#define _LIBC_TIME_H
+
+#include <_cheader.h>
+#include <_null.h>
+
+_c_header_begin;
+
+/**
+ * @brief Seconds since the epoch
+ * 
+ */
+typedef long time_t;
+
+/**
+ * @brief Clock identifier
+ * 
+ */
+typedef int clockid_t;
+
+/**
+ * @brief Time with nanosecond resolution
+ * 
+ */
+struct timespec
+{
+    time_t tv_sec;
+    long tv_nsec;
+};
+
+/**
+ * @brief Wall clock time
+ * 
+ */
+#define CLOCK_REALTIME 0
+
+/**
+ * @brief Time since boot, never adjusted
+ * 
+ */
+#define CLOCK_MONOTONIC 1
+
+/**
+ * @brief Reads a clock
+ * 
+ * @param clock_id Clock to read
+ * @param tp Receives the time
+ * 
+ * @return 0 on success, -1 on error
+ */
+int clock_gettime(clockid_t clock_id, struct timespec *tp);
+
+/**
+ * @brief Returns the wall clock time in seconds, also storing it in tloc if
+ * it is not NULL
+ * 
+ */
+time_t time(time_t *tloc);
+
+_c_header_end;
+
+#endif
\ No newline at end of file
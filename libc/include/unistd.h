@@ -0,0 +1,145 @@
+/**
+ * @file unistd.h
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#ifndef _LIBC_UNISTD_H
+#define _LIBC_UNISTD_H
+
+#include <_cheader.h>
+
+_c_header_begin;
+
+#include <_null.h>
+#include <_pid_t.h>
+#include <_off_t.h>
+#include <_size_t.h>
+#include <_ssize_t.h>
+
+/**
+ * @brief Gets the ID of the calling process
+ * 
+ * @return The process ID, shared by all threads of the process.
+ */
+pid_t getpid(void);
+
+/**
+ * @brief Gets the ID of the calling thread
+ * 
+ * @return The thread ID.
+ */
+pid_t gettid(void);
+
+/**
+ * @brief Reads from a file at its file offset
+ * 
+ * @return Number of bytes read, 0 at the end of the file.
+ */
+ssize_t read(int fd, void *buf, size_t count);
+
+/**
+ * @brief Writes to a file at its file offset
+ * 
+ * @return Number of bytes written.
+ */
+ssize_t write(int fd, const void *buf, size_t count);
+
+/**
+ * @brief Closes a file descriptor
+ * 
+ * @return 0 on success, negative error code on failure.
+ */
+int close(int fd);
+
+/**
+ * @brief Sets the size of a file
+ * 
+ * Shared memory objects can be given any size. Regular files can only be
+ * truncated to zero length.
+ * 
+ * @return 0 on success, negative error code on failure.
+ */
+int ftruncate(int fd, off_t length);
+
+/**
+ * @brief Reads from a file at a given offset
+ * 
+ * The file offset is neither used nor changed.
+ * 
+ * @return Number of bytes read.
+ */
+ssize_t pread(int fd, void *buf, size_t count, off_t offset);
+
+/**
+ * @brief Writes to a file at a given offset
+ * 
+ * The file offset is neither used nor changed.
+ * 
+ * @return Number of bytes written.
+ */
+ssize_t pwrite(int fd, const void *buf, size_t count, off_t offset);
+
+/**
+ * @brief Copies data between two files without passing it through user space
+ * 
+ * @param fd_in File to copy from
+ * @param off_in Offset to read from, advanced by the number of bytes copied.
+ * If NULL, the file offset of fd_in is used and advanced instead.
+ * @param fd_out File to copy to
+ * @param off_out Offset to write to, same rules as off_in
+ * @param len Number of bytes to copy
+ * @param flags Must be 0
+ * 
+ * @return Number of bytes copied, 0 at the end of the input.
+ */
+ssize_t copy_file_range(int fd_in,
+                        off_t *off_in,
+                        int fd_out,
+                        off_t *off_out,
+                        size_t len,
+                        unsigned int flags);
+
+/**
+ * @brief Creates a pipe
+ * 
+ * @param fds Receives the read end in fds[0] and the write end in fds[1]
+ * 
+ * @return 0 on success, negative error code on failure.
+ */
+int pipe(int fds[2]);
+
+/**
+ * @brief Moves data between a pipe and another file, or between two pipes,
+ * without passing it through user space
+ * 
+ * The offsets follow the rules of copy_file_range and must be NULL for pipes.
+ * 
+ * @return Number of bytes moved, 0 at the end of the input.
+ */
+ssize_t splice(int fd_in,
+               off_t *off_in,
+               int fd_out,
+               off_t *off_out,
+               size_t len,
+               unsigned int flags);
+
+_c_header_end;
+
+#endif
\ No newline at end of file
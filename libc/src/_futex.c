@@ -0,0 +1,47 @@
+/**
+ * @file _futex.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief Futex helpers
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#include <_futex.h>
+#include <_syscall.h>
+
+int _futex_wait(volatile int *addr, int val)
+{
+    return do_syscall3(SYSCALL_FUTEX, (int64_t)addr, FUTEX_WAIT, val);
+}
+
+int _futex_wake(volatile int *addr, int count)
+{
+    return do_syscall3(SYSCALL_FUTEX, (int64_t)addr, FUTEX_WAKE, count);
+}
+
+int _futex_requeue(volatile int *addr,
+                   int wake_count,
+                   volatile int *addr2,
+                   int requeue_count)
+{
+    return do_syscall5(SYSCALL_FUTEX,
+                       (int64_t)addr,
+                       FUTEX_REQUEUE,
+                       wake_count,
+                       requeue_count,
+                       (int64_t)addr2);
+}
\ No newline at end of file
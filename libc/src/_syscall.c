@@ -22,14 +22,18 @@
 
 #include <_syscall.h>
 
+// System calls are made with the SYSCALL instruction. The number is passed in
+// rax and the arguments in rdi, rsi, rdx, r10, r8 and r9. rcx and r11 are
+// clobbered. int $0x80 remains available in the kernel for compatibility.
+
 int64_t do_syscall0(int64_t syscall)
 {
     int64_t ret;
 
-    __asm__ volatile("int $0x80"
+    __asm__ volatile("syscall"
                      : "=a"(ret)
                      : "a"(syscall)
-                     : "memory");
+                     : "rcx", "r11", "memory");
 
     return ret;
 }
@@ -38,11 +42,11 @@ int64_t do_syscall1(int64_t syscall, int64_t arg1)
 {
     int64_t ret;
 
-    __asm__ volatile("int $0x80"
+    __asm__ volatile("syscall"
                      : "=a"(ret)
                      : "a"(syscall),
-                       "b"(arg1)
-                     : "memory");
+                       "D"(arg1)
+                     : "rcx", "r11", "memory");
 
     return ret;
 }
@@ -51,12 +55,12 @@ int64_t do_syscall2(int64_t syscall, int64_t arg1, int64_t arg2)
 {
     int64_t ret;
 
-    __asm__ volatile("int $0x80"
+    __asm__ volatile("syscall"
                      : "=a"(ret)
                      : "a"(syscall),
-                       "b"(arg1),
-                       "c"(arg2)
-                     : "memory");
+                       "D"(arg1),
+                       "S"(arg2)
+                     : "rcx", "r11", "memory");
 
     return ret;
 }
@@ -65,13 +69,88 @@ int64_t do_syscall3(int64_t syscall, int64_t arg1, int64_t arg2, int64_t arg3)
 {
     int64_t ret;
 
-    __asm__ volatile("int $0x80"
+    __asm__ volatile("syscall"
                      : "=a"(ret)
                      : "a"(syscall),
-                       "b"(arg1),
-                       "c"(arg2),
+                       "D"(arg1),
+                       "S"(arg2),
                        "d"(arg3)
-                     : "memory");
+                     : "rcx", "r11", "memory");
+
+    return ret;
+}
+
+int64_t do_syscall4(int64_t syscall,
+                    int64_t arg1,
+                    int64_t arg2,
+                    int64_t arg3,
+                    int64_t arg4)
+{
+    int64_t ret;
+
+    register int64_t r10 __asm__("r10") = arg4;
+
+    __asm__ volatile("syscall"
+                     : "=a"(ret)
+                     : "a"(syscall),
+                       "D"(arg1),
+                       "S"(arg2),
+                       "d"(arg3),
+                       "r"(r10)
+                     : "rcx", "r11", "memory");
+
+    return ret;
+}
+
+int64_t do_syscall5(int64_t syscall,
+                    int64_t arg1,
+                    int64_t arg2,
+                    int64_t arg3,
+                    int64_t arg4,
+                    int64_t arg5)
+{
+    int64_t ret;
+
+    register int64_t r10 __asm__("r10") = arg4;
+    register int64_t r8 __asm__("r8") = arg5;
+
+    __asm__ volatile("syscall"
+                     : "=a"(ret)
+                     : "a"(syscall),
+                       "D"(arg1),
+                       "S"(arg2),
+                       "d"(arg3),
+                       "r"(r10),
+                       "r"(r8)
+                     : "rcx", "r11", "memory");
+
+    return ret;
+}
+
+int64_t do_syscall6(int64_t syscall,
+                    int64_t arg1,
+                    int64_t arg2,
+                    int64_t arg3,
+                    int64_t arg4,
+                    int64_t arg5,
+                    int64_t arg6)
+{
+    int64_t ret;
+
+    register int64_t r10 __asm__("r10") = arg4;
+    register int64_t r8 __asm__("r8") = arg5;
+    register int64_t r9 __asm__("r9") = arg6;
+
+    __asm__ volatile("syscall"
+                     : "=a"(ret)
+                     : "a"(syscall),
+                       "D"(arg1),
+                       "S"(arg2),
+                       "d"(arg3),
+                       "r"(r10),
+                       "r"(r8),
+                       "r"(r9)
+                     : "rcx", "r11", "memory");
 
     return ret;
 }
\ No newline at end of file
@@ -0,0 +1,75 @@
+/**
+ * @file _vdso.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief Data page shared with the kernel
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#include <_vdso.h>
+
+static inline uint64_t _read_timestamp()
+{
+    uint32_t lo;
+    uint32_t hi;
+
+    __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+
+    return ((uint64_t)hi << 32) | lo;
+}
+
+void _vdso_get_time(int realtime, int64_t *sec, int64_t *nsec)
+{
+    const _vdso_data_t *data = _vdso_data;
+
+    uint32_t seq;
+    uint64_t ns;
+    int64_t boot_time;
+
+    do
+    {
+        seq = data->seq;
+
+        if (seq & 1)
+        {
+            continue;
+        }
+
+        __asm__ volatile("" ::: "memory");
+
+        ns = data->mono_base_ns;
+        boot_time = data->boot_time;
+
+        if (data->tsc_valid)
+        {
+            uint64_t cycles = _read_timestamp() - data->tsc_base;
+
+            ns += (uint64_t)(((unsigned __int128)cycles * data->tsc_mult) >>
+                             data->tsc_shift);
+        }
+
+        __asm__ volatile("" ::: "memory");
+    } while ((seq & 1) || seq != data->seq);
+
+    *sec = (int64_t)(ns / 1000000000);
+    *nsec = (int64_t)(ns % 1000000000);
+
+    if (realtime)
+    {
+        *sec += boot_time;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+/**
+ * @file io_ring_cqe.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#include <io_ring.h>
+
+#include <_syscall.h>
+
+io_ring_cqe_t *io_ring_peek_cqe(io_ring_t *ring)
+{
+    if (ring->cq->head == ring->cq->tail)
+    {
+        return NULL;
+    }
+
+    // The entry is written before the tail is advanced
+    __sync_synchronize();
+
+    return &ring->cqes[ring->cq->head & ring->cq->mask];
+}
+
+io_ring_cqe_t *io_ring_wait_cqe(io_ring_t *ring)
+{
+    io_ring_cqe_t *cqe = io_ring_peek_cqe(ring);
+
+    if (cqe)
+    {
+        return cqe;
+    }
+
+    if (do_syscall3(SYSCALL_IO_RING_ENTER, 0, 1, IO_RING_ENTER_GETEVENTS) <
+        0)
+    {
+        return NULL;
+    }
+
+    return io_ring_peek_cqe(ring);
+}
+
+void io_ring_cqe_seen(io_ring_t *ring)
+{
+    ring->cq->head++;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+/**
+ * @file io_ring_get_sqe.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#include <io_ring.h>
+
+#include <string.h>
+
+io_ring_sqe_t *io_ring_get_sqe(io_ring_t *ring)
+{
+    if (ring->sqe_tail - ring->sq->head >= ring->sq->entries)
+    {
+        return NULL;
+    }
+
+    io_ring_sqe_t *sqe = &ring->sqes[ring->sqe_tail & ring->sq->mask];
+
+    ring->sqe_tail++;
+
+    memset(sqe, 0, sizeof(io_ring_sqe_t));
+
+    return sqe;
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+/**
+ * @file io_ring_init.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#include <io_ring.h>
+
+#include <_syscall.h>
+
+int io_ring_init(io_ring_t *ring, uint32_t entries)
+{
+    io_ring_params_t params;
+
+    int ret = do_syscall2(SYSCALL_IO_RING_SETUP, entries, (int64_t)&params);
+
+    if (ret < 0)
+    {
+        return ret;
+    }
+
+    ring->sq = (io_ring_header_t *)params.sq_ring;
+    ring->sqes = (io_ring_sqe_t *)(ring->sq + 1);
+
+    ring->cq = (io_ring_header_t *)params.cq_ring;
+    ring->cqes = (io_ring_cqe_t *)(ring->cq + 1);
+
+    ring->sqe_tail = ring->sq->tail;
+
+    return 0;
+}
\ No newline at end of file
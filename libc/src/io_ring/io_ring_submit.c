@@ -0,0 +1,59 @@
+/**
+ * @file io_ring_submit.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#include <io_ring.h>
+
+#include <_syscall.h>
+
+static uint32_t _io_ring_publish(io_ring_t *ring)
+{
+    uint32_t count = ring->sqe_tail - ring->sq->tail;
+
+    // The entries must be visible before the new tail
+    __sync_synchronize();
+
+    ring->sq->tail = ring->sqe_tail;
+
+    return count;
+}
+
+int io_ring_submit(io_ring_t *ring)
+{
+    uint32_t count = _io_ring_publish(ring);
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    int ret = do_syscall3(SYSCALL_IO_RING_ENTER, count, 0, 0);
+
+    return ret < 0 ? ret : (int)count;
+}
+
+int io_ring_submit_and_wait(io_ring_t *ring, uint32_t wait_nr)
+{
+    uint32_t count = _io_ring_publish(ring);
+
+    return do_syscall3(
+        SYSCALL_IO_RING_ENTER, count, wait_nr, IO_RING_ENTER_GETEVENTS);
+}
\ No newline at end of file
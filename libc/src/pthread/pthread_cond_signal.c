@@ -0,0 +1,34 @@
+/**
+ * @file pthread_cond_signal.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#include <pthread.h>
+
+#include <_futex.h>
+
+int pthread_cond_signal(pthread_cond_t *cond)
+{
+    __atomic_fetch_add(&cond->seq, 1, __ATOMIC_RELEASE);
+
+    _futex_wake(&cond->seq, 1);
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+/**
+ * @file pthread_cond_wait.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#include <pthread.h>
+
+#include <_futex.h>
+
+int pthread_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex)
+{
+    int seq = __atomic_load_n(&cond->seq, __ATOMIC_ACQUIRE);
+
+    cond->mutex = mutex;
+
+    pthread_mutex_unlock(mutex);
+
+    // Returns immediately if the condition was signaled after the unlock
+    _futex_wait(&cond->seq, seq);
+
+    // We may have been requeued to the mutex by a broadcast, so relock it in
+    // the contended state to make sure the remaining waiters are woken.
+    while (__atomic_exchange_n(&mutex->state, 2, __ATOMIC_ACQUIRE) != 0)
+    {
+        _futex_wait(&mutex->state, 2);
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+/**
+ * @file pthread_mutex_lock.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#include <pthread.h>
+
+#include <_futex.h>
+
+int pthread_mutex_lock(pthread_mutex_t *mutex)
+{
+    int expected = 0;
+
+    // Fast path, the mutex is free
+    if (__atomic_compare_exchange_n(&mutex->state,
+                                    &expected,
+                                    1,
+                                    0,
+                                    __ATOMIC_ACQUIRE,
+                                    __ATOMIC_RELAXED))
+    {
+        return 0;
+    }
+
+    // Mark the mutex as contended, so that the owner wakes us when unlocking
+    if (expected != 2)
+    {
+        expected = __atomic_exchange_n(&mutex->state, 2, __ATOMIC_ACQUIRE);
+    }
+
+    while (expected != 0)
+    {
+        _futex_wait(&mutex->state, 2);
+
+        expected = __atomic_exchange_n(&mutex->state, 2, __ATOMIC_ACQUIRE);
+    }
+
+    return 0;
+}
\ No newline at end of file
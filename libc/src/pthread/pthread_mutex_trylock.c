@@ -0,0 +1,42 @@
+/**
+ * @file pthread_mutex_trylock.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#include <pthread.h>
+
+#define EBUSY 16
+
+int pthread_mutex_trylock(pthread_mutex_t *mutex)
+{
+    int expected = 0;
+
+    if (__atomic_compare_exchange_n(&mutex->state,
+                                    &expected,
+                                    1,
+                                    0,
+                                    __ATOMIC_ACQUIRE,
+                                    __ATOMIC_RELAXED))
+    {
+        return 0;
+    }
+
+    return EBUSY;
+}
\ No newline at end of file
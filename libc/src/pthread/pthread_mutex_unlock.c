@@ -0,0 +1,38 @@
+/**
+ * @file pthread_mutex_unlock.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#include <pthread.h>
+
+#include <_futex.h>
+
+int pthread_mutex_unlock(pthread_mutex_t *mutex)
+{
+    // Only enter the kernel if someone might be waiting
+    if (__atomic_fetch_sub(&mutex->state, 1, __ATOMIC_RELEASE) != 1)
+    {
+        __atomic_store_n(&mutex->state, 0, __ATOMIC_RELEASE);
+
+        _futex_wake(&mutex->state, 1);
+    }
+
+    return 0;
+}
\ No newline at end of file
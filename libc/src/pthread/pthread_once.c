@@ -0,0 +1,64 @@
+/**
+ * @file pthread_once.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#include <pthread.h>
+
+#include <_futex.h>
+#include <limits.h>
+
+#define ONCE_INIT 0
+#define ONCE_RUNNING 1
+#define ONCE_DONE 2
+
+int pthread_once(pthread_once_t *once_control, void (*init_routine)(void))
+{
+    if (__atomic_load_n(&once_control->state, __ATOMIC_ACQUIRE) == ONCE_DONE)
+    {
+        return 0;
+    }
+
+    int expected = ONCE_INIT;
+
+    if (__atomic_compare_exchange_n(&once_control->state,
+                                    &expected,
+                                    ONCE_RUNNING,
+                                    0,
+                                    __ATOMIC_ACQUIRE,
+                                    __ATOMIC_ACQUIRE))
+    {
+        init_routine();
+
+        __atomic_store_n(&once_control->state, ONCE_DONE, __ATOMIC_RELEASE);
+
+        _futex_wake(&once_control->state, INT_MAX);
+
+        return 0;
+    }
+
+    while (__atomic_load_n(&once_control->state, __ATOMIC_ACQUIRE) ==
+           ONCE_RUNNING)
+    {
+        _futex_wait(&once_control->state, ONCE_RUNNING);
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+/**
+ * @file _spawn_file_actions_add.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#include <spawn.h>
+
+#include <stdlib.h>
+
+#define ENOMEM 12
+
+int _spawn_file_actions_add(posix_spawn_file_actions_t *file_actions,
+                            int type,
+                            int fd,
+                            int newfd,
+                            const char *path)
+{
+    if (file_actions->count == file_actions->capacity)
+    {
+        int capacity = file_actions->capacity ? file_actions->capacity * 2 : 4;
+
+        struct _spawn_file_action *actions =
+            realloc(file_actions->actions,
+                    sizeof(struct _spawn_file_action) * capacity);
+
+        if (!actions)
+        {
+            return ENOMEM;
+        }
+
+        file_actions->actions = actions;
+        file_actions->capacity = capacity;
+    }
+
+    struct _spawn_file_action *action =
+        &file_actions->actions[file_actions->count++];
+
+    action->type = type;
+    action->fd = fd;
+    action->newfd = newfd;
+    action->path = path;
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+/**
+ * @file posix_spawn.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#include <spawn.h>
+
+#include <_syscall.h>
+
+int posix_spawn(pid_t *pid,
+                const char *path,
+                const posix_spawn_file_actions_t *file_actions,
+                const posix_spawnattr_t *attrp,
+                char *const argv[],
+                char *const envp[])
+{
+    (void)attrp;
+
+    int64_t actions = 0;
+    int64_t count = 0;
+
+    if (file_actions)
+    {
+        actions = (int64_t)file_actions->actions;
+        count = file_actions->count;
+    }
+
+    int ret = do_syscall5(SYSCALL_SPAWN,
+                          (int64_t)path,
+                          (int64_t)argv,
+                          (int64_t)envp,
+                          actions,
+                          count);
+
+    if (ret < 0)
+    {
+        return -ret;
+    }
+
+    if (pid)
+    {
+        *pid = ret;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+/**
+ * @file posix_spawn_file_actions_addclose.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#include <spawn.h>
+
+int _spawn_file_actions_add(posix_spawn_file_actions_t *file_actions,
+                            int type,
+                            int fd,
+                            int newfd,
+                            const char *path);
+
+int posix_spawn_file_actions_addclose(posix_spawn_file_actions_t *file_actions,
+                                      int fd)
+{
+    return _spawn_file_actions_add(file_actions, _SPAWN_FA_CLOSE, fd, -1, 0);
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+/**
+ * @file posix_spawn_file_actions_destroy.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#include <spawn.h>
+
+#include <stdlib.h>
+
+int posix_spawn_file_actions_destroy(posix_spawn_file_actions_t *file_actions)
+{
+    free(file_actions->actions);
+
+    file_actions->count = 0;
+    file_actions->capacity = 0;
+    file_actions->actions = 0;
+
+    return 0;
+}
\ No newline at end of file
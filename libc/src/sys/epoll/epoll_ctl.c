@@ -0,0 +1,30 @@
+/**
+ * @file epoll_ctl.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#include <sys/epoll.h>
+
+#include <_syscall.h>
+
+int epoll_ctl(int epfd, int op, int fd, struct epoll_event *event)
+{
+    return do_syscall4(SYSCALL_EPOLL_CTL, epfd, op, fd, (int64_t)event);
+}
\ No newline at end of file
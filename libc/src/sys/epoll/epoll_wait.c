@@ -0,0 +1,34 @@
+/**
+ * @file epoll_wait.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#include <sys/epoll.h>
+
+#include <_syscall.h>
+
+int epoll_wait(int epfd,
+               struct epoll_event *events,
+               int maxevents,
+               int timeout)
+{
+    return do_syscall4(
+        SYSCALL_EPOLL_WAIT, epfd, (int64_t)events, maxevents, timeout);
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+/**
+ * @file mmap.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#include <sys/mman.h>
+
+#include <_syscall.h>
+
+void *mmap(void *addr,
+           size_t length,
+           int prot,
+           int flags,
+           int fd,
+           off_t offset)
+{
+    int64_t ret = do_syscall6(SYSCALL_MMAP,
+                              (int64_t)addr,
+                              length,
+                              prot,
+                              flags,
+                              fd,
+                              offset);
+
+    if (ret < 0)
+    {
+        return MAP_FAILED;
+    }
+
+    return (void *)ret;
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+/**
+ * @file clock_gettime.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#include <time.h>
+
+#include <_vdso.h>
+
+int clock_gettime(clockid_t clock_id, struct timespec *tp)
+{
+    int64_t sec;
+    int64_t nsec;
+
+    if (clock_id != CLOCK_REALTIME && clock_id != CLOCK_MONOTONIC)
+    {
+        return -1;
+    }
+
+    _vdso_get_time(clock_id == CLOCK_REALTIME, &sec, &nsec);
+
+    if (tp)
+    {
+        tp->tv_sec = (time_t)sec;
+        tp->tv_nsec = (long)nsec;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+/**
+ * @file time.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#include <time.h>
+
+#include <_vdso.h>
+
+time_t time(time_t *tloc)
+{
+    int64_t sec;
+    int64_t nsec;
+
+    _vdso_get_time(1, &sec, &nsec);
+
+    if (tloc)
+    {
+        *tloc = (time_t)sec;
+    }
+
+    return (time_t)sec;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+/**
+ * @file copy_file_range.c
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @brief 
+ * 
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ * 
+ */
+
+#include <unistd.h>
+
+#include <_syscall.h>
+
+ssize_t copy_file_range(int fd_in,
+                        off_t *off_in,
+                        int fd_out,
+                        off_t *off_out,
+                        size_t len,
+                        unsigned int flags)
+{
+    return do_syscall6(SYSCALL_COPY_FILE_RANGE,
+                       fd_in,
+                       (int64_t)off_in,
+                       fd_out,
+                       (int64_t)off_out,
+                       len,
+                       flags);
+}
\ No newline at end of file
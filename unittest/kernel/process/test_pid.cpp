@@ -0,0 +1,243 @@
+/**
+ * @file test_pid.cpp
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+extern "C"
+{
+#include <process/pid.h>
+
+// The kernel process header does not build on the host. The PID code only
+// needs the ID and the hash chain of a process.
+#define _PROCESS_H
+
+    typedef struct _process
+    {
+        pid_t id;
+        struct _process *pid_next;
+    } process_t;
+
+#define _Static_assert static_assert
+
+#include "../../../kernel/src/process/pid.c"
+
+    uint64_t irq_save()
+    {
+        return 0;
+    }
+
+    void irq_restore(uint64_t flags)
+    {
+        (void)flags;
+    }
+}
+
+//==============================================================================
+// Test fixtures
+//==============================================================================
+
+class PidTest : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        pid_init();
+    }
+
+    // Allocates every free ID, returning them in allocation order
+    std::vector<pid_t> AllocAll()
+    {
+        std::vector<pid_t> pids;
+
+        for (pid_t pid = pid_alloc(); pid != -1; pid = pid_alloc())
+        {
+            pids.push_back(pid);
+        }
+
+        return pids;
+    }
+
+    process_t MakeProcess(pid_t pid)
+    {
+        process_t proc;
+
+        memset(&proc, 0, sizeof(proc));
+        proc.id = pid;
+
+        return proc;
+    }
+};
+
+//==============================================================================
+// Tests
+//==============================================================================
+
+TEST_F(PidTest, Alloc_SkipsReservedIds)
+{
+    ASSERT_EQ(pid_alloc(), 2);
+    ASSERT_EQ(pid_alloc(), 3);
+}
+
+TEST_F(PidTest, Alloc_ReturnsLowestFreeId)
+{
+    for (pid_t i = 2; i < 200; ++i)
+    {
+        ASSERT_EQ(pid_alloc(), i);
+    }
+
+    pid_free(150);
+    pid_free(70);
+    pid_free(130);
+
+    ASSERT_EQ(pid_alloc(), 70);
+    ASSERT_EQ(pid_alloc(), 130);
+    ASSERT_EQ(pid_alloc(), 150);
+    ASSERT_EQ(pid_alloc(), 200);
+}
+
+TEST_F(PidTest, Free_ReusesIdInFullLeafWord)
+{
+    // IDs 2 to 127 fill the first two leaf words
+    for (pid_t i = 2; i < 128; ++i)
+    {
+        ASSERT_EQ(pid_alloc(), i);
+    }
+
+    pid_free(64);
+
+    ASSERT_EQ(pid_alloc(), 64);
+    ASSERT_EQ(pid_alloc(), 128);
+}
+
+TEST_F(PidTest, Free_ReusesIdInFullMiddleWord)
+{
+    // The first middle word covers IDs 0 to 4095
+    for (pid_t i = 2; i < 64 * 64 + 1; ++i)
+    {
+        ASSERT_EQ(pid_alloc(), i);
+    }
+
+    pid_free(4000);
+
+    ASSERT_EQ(pid_alloc(), 4000);
+    ASSERT_EQ(pid_alloc(), 64 * 64 + 1);
+}
+
+TEST_F(PidTest, Free_IgnoresReservedAndOutOfRangeIds)
+{
+    pid_free(0);
+    pid_free(1);
+    pid_free(-1);
+    pid_free(PID_MAX);
+
+    ASSERT_EQ(pid_alloc(), 2);
+}
+
+TEST_F(PidTest, Alloc_ExhaustsAtPidMax)
+{
+    std::vector<pid_t> pids = AllocAll();
+
+    ASSERT_EQ(pids.size(), (size_t)PID_MAX - 2);
+    ASSERT_EQ(pids.front(), 2);
+    ASSERT_EQ(pids.back(), PID_MAX - 1);
+    ASSERT_EQ(pid_alloc(), -1);
+}
+
+TEST_F(PidTest, Alloc_ReusesIdAfterExhaustion)
+{
+    AllocAll();
+
+    pid_free(PID_MAX - 1);
+    pid_free(1000);
+
+    ASSERT_EQ(pid_alloc(), 1000);
+    ASSERT_EQ(pid_alloc(), PID_MAX - 1);
+    ASSERT_EQ(pid_alloc(), -1);
+}
+
+TEST_F(PidTest, Hash_FindsInsertedProcesses)
+{
+    // 2 and 2 + PID_HASH_SIZE share a bucket
+    process_t a = MakeProcess(2);
+    process_t b = MakeProcess(2 + PID_HASH_SIZE);
+    process_t c = MakeProcess(3);
+
+    pid_hash_insert(&a);
+    pid_hash_insert(&b);
+    pid_hash_insert(&c);
+
+    ASSERT_EQ(pid_hash_lookup(2), &a);
+    ASSERT_EQ(pid_hash_lookup(2 + PID_HASH_SIZE), &b);
+    ASSERT_EQ(pid_hash_lookup(3), &c);
+    ASSERT_EQ(pid_hash_lookup(4), nullptr);
+    ASSERT_EQ(pid_hash_lookup(-1), nullptr);
+}
+
+TEST_F(PidTest, Hash_RemoveKeepsOtherProcessesInBucket)
+{
+    process_t a = MakeProcess(2);
+    process_t b = MakeProcess(2 + PID_HASH_SIZE);
+    process_t c = MakeProcess(2 + 2 * PID_HASH_SIZE);
+
+    pid_hash_insert(&a);
+    pid_hash_insert(&b);
+    pid_hash_insert(&c);
+
+    pid_hash_remove(&b);
+
+    ASSERT_EQ(pid_hash_lookup(2), &a);
+    ASSERT_EQ(pid_hash_lookup(2 + PID_HASH_SIZE), nullptr);
+    ASSERT_EQ(pid_hash_lookup(2 + 2 * PID_HASH_SIZE), &c);
+
+    pid_hash_remove(&c);
+    pid_hash_remove(&a);
+
+    ASSERT_EQ(pid_hash_lookup(2), nullptr);
+    ASSERT_EQ(pid_hash_lookup(2 + 2 * PID_HASH_SIZE), nullptr);
+}
+
+TEST_F(PidTest, Hash_IgnoresNegativeIds)
+{
+    process_t a = MakeProcess(-1);
+
+    pid_hash_insert(&a);
+
+    ASSERT_EQ(pid_hash_lookup(-1), nullptr);
+}
+
+//==============================================================================
+// Main file
+//==============================================================================
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,297 @@
+/**
+ * @file test_radix_tree.cpp
+ * @author Joakim Bertils
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @brief
+ *
+ * @copyright Copyright (C) 2026,
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https: //www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+extern "C"
+{
+#include "../../../kernel/src/util/radix_tree.c"
+}
+
+//==============================================================================
+// Test fixtures
+//==============================================================================
+
+class RadixTreeTest : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        radix_tree_init(&tree);
+    }
+
+    void TearDown() override
+    {
+        radix_tree_destroy(&tree);
+    }
+
+    radix_tree_t tree;
+
+    // Items are made from their index, so that they can be told apart
+    static void *Item(uint64_t index)
+    {
+        return (void *)(uintptr_t)(index + 1);
+    }
+
+    void Insert(uint64_t index)
+    {
+        ASSERT_EQ(radix_tree_insert(&tree, index, Item(index)), 0);
+    }
+
+    void ExpectItem(uint64_t index)
+    {
+        EXPECT_EQ(radix_tree_lookup(&tree, index), Item(index));
+    }
+
+    void ExpectNoItem(uint64_t index)
+    {
+        EXPECT_EQ(radix_tree_lookup(&tree, index), nullptr);
+    }
+
+    std::vector<uint64_t> GangIndices(uint64_t first, size_t max)
+    {
+        std::vector<void *> items(max);
+        std::vector<uint64_t> indices(max);
+
+        size_t found = radix_tree_gang_lookup(
+            &tree, first, items.data(), indices.data(), max);
+
+        indices.resize(found);
+
+        for (size_t i = 0; i < found; ++i)
+        {
+            EXPECT_EQ(items[i], Item(indices[i]));
+        }
+
+        return indices;
+    }
+};
+
+// First index that needs a tree of the given height
+static constexpr uint64_t HeightStart(uint32_t height)
+{
+    return 1ULL << ((height - 1) * RADIX_TREE_SHIFT);
+}
+
+//==============================================================================
+// Tests
+//==============================================================================
+
+TEST_F(RadixTreeTest, Lookup_EmptyTreeHasNoItems)
+{
+    ExpectNoItem(0);
+    ExpectNoItem(12345);
+    EXPECT_EQ(tree.height, 0U);
+}
+
+TEST_F(RadixTreeTest, Insert_FindsItemsInSingleNode)
+{
+    Insert(0);
+    Insert(RADIX_TREE_SLOTS - 1);
+
+    EXPECT_EQ(tree.height, 1U);
+
+    ExpectItem(0);
+    ExpectItem(RADIX_TREE_SLOTS - 1);
+    ExpectNoItem(1);
+    ExpectNoItem(RADIX_TREE_SLOTS);
+}
+
+TEST_F(RadixTreeTest, Insert_GrowsAcrossHeightBoundaries)
+{
+    Insert(0);
+
+    for (uint32_t height = 2; height <= 5; ++height)
+    {
+        Insert(HeightStart(height) - 1);
+        EXPECT_EQ(tree.height, height - 1);
+
+        Insert(HeightStart(height));
+        EXPECT_EQ(tree.height, height);
+    }
+
+    // Items inserted before growing stay reachable through the new roots
+    ExpectItem(0);
+
+    for (uint32_t height = 2; height <= 5; ++height)
+    {
+        ExpectItem(HeightStart(height) - 1);
+        ExpectItem(HeightStart(height));
+        ExpectNoItem(HeightStart(height) + 1);
+    }
+}
+
+TEST_F(RadixTreeTest, Insert_HandlesLargestIndex)
+{
+    Insert(0);
+    Insert(UINT64_MAX);
+
+    ExpectItem(0);
+    ExpectItem(UINT64_MAX);
+    ExpectNoItem(UINT64_MAX - 1);
+}
+
+TEST_F(RadixTreeTest, Insert_FailsForUsedIndex)
+{
+    Insert(42);
+
+    EXPECT_EQ(radix_tree_insert(&tree, 42, Item(0)), -1);
+
+    ExpectItem(42);
+}
+
+TEST_F(RadixTreeTest, Delete_ReturnsRemovedItem)
+{
+    Insert(7);
+    Insert(HeightStart(3));
+
+    EXPECT_EQ(radix_tree_delete(&tree, 7), Item(7));
+    EXPECT_EQ(radix_tree_delete(&tree, 7), nullptr);
+
+    ExpectNoItem(7);
+    ExpectItem(HeightStart(3));
+}
+
+TEST_F(RadixTreeTest, Delete_MissingIndicesReturnNull)
+{
+    EXPECT_EQ(radix_tree_delete(&tree, 0), nullptr);
+
+    Insert(1);
+
+    EXPECT_EQ(radix_tree_delete(&tree, 2), nullptr);
+    EXPECT_EQ(radix_tree_delete(&tree, HeightStart(4)), nullptr);
+    EXPECT_EQ(radix_tree_delete(&tree, RADIX_TREE_SLOTS + 1), nullptr);
+
+    ExpectItem(1);
+}
+
+TEST_F(RadixTreeTest, Delete_FreesEmptyTree)
+{
+    Insert(3);
+    Insert(HeightStart(4) + 5);
+
+    radix_tree_delete(&tree, HeightStart(4) + 5);
+
+    EXPECT_NE(tree.root, nullptr);
+    ExpectItem(3);
+
+    radix_tree_delete(&tree, 3);
+
+    EXPECT_EQ(tree.root, nullptr);
+    EXPECT_EQ(tree.height, 0U);
+
+    // The tree is usable again after shrinking to nothing
+    Insert(HeightStart(2));
+    ExpectItem(HeightStart(2));
+    EXPECT_EQ(tree.height, 2U);
+}
+
+TEST_F(RadixTreeTest, Delete_FreesEmptySubtrees)
+{
+    uint64_t index = HeightStart(3) + RADIX_TREE_SLOTS + 1;
+
+    Insert(0);
+    Insert(index);
+
+    radix_tree_delete(&tree, index);
+
+    // The path to the deleted item is gone, only the first subtree is left
+    EXPECT_EQ(tree.root->count, 1U);
+    EXPECT_EQ(tree.root->slots[1], nullptr);
+
+    ExpectItem(0);
+}
+
+TEST_F(RadixTreeTest, GangLookup_ReturnsItemsInIndexOrder)
+{
+    std::vector<uint64_t> expected = {0,
+                                      5,
+                                      RADIX_TREE_SLOTS,
+                                      HeightStart(3) + 2,
+                                      HeightStart(4)};
+
+    for (auto it = expected.rbegin(); it != expected.rend(); ++it)
+    {
+        Insert(*it);
+    }
+
+    EXPECT_EQ(GangIndices(0, 16), expected);
+}
+
+TEST_F(RadixTreeTest, GangLookup_StopsAtMax)
+{
+    for (uint64_t i = 0; i < 10; ++i)
+    {
+        Insert(i * 3);
+    }
+
+    EXPECT_EQ(GangIndices(0, 4), (std::vector<uint64_t>{0, 3, 6, 9}));
+    EXPECT_EQ(GangIndices(10, 2), (std::vector<uint64_t>{12, 15}));
+    EXPECT_TRUE(GangIndices(0, 0).empty());
+}
+
+TEST_F(RadixTreeTest, GangLookup_StartsInsideSkippedSubtree)
+{
+    // The first index lies in the subtree of slot 1 at the top level, past
+    // its only item, so the subtree is walked but yields nothing
+    uint64_t subtree = HeightStart(3);
+
+    Insert(5);
+    Insert(subtree + 1);
+    Insert(subtree + 200);
+    Insert(2 * subtree + 3);
+
+    EXPECT_EQ(GangIndices(subtree + 2, 16),
+              (std::vector<uint64_t>{subtree + 200, 2 * subtree + 3}));
+    EXPECT_EQ(GangIndices(subtree + 201, 16),
+              (std::vector<uint64_t>{2 * subtree + 3}));
+    EXPECT_EQ(GangIndices(6, 16),
+              (std::vector<uint64_t>{
+                  subtree + 1, subtree + 200, 2 * subtree + 3}));
+}
+
+TEST_F(RadixTreeTest, GangLookup_FirstBeyondTreeFindsNothing)
+{
+    Insert(1);
+    Insert(2);
+
+    EXPECT_TRUE(GangIndices(RADIX_TREE_SLOTS, 16).empty());
+    EXPECT_TRUE(GangIndices(HeightStart(5), 16).empty());
+}
+
+//==============================================================================
+// Main file
+//==============================================================================
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
+
+//==============================================================================
+// End of file
+//==============================================================================